@@ -0,0 +1,135 @@
+#ifndef FROGS_BENCH_HPP
+#define FROGS_BENCH_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "case.hpp"
+#include "parallel.hpp"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Small helpers shared by the benchmarks. Each benchmark is a plain function registered in bench_main.cpp.
+
+namespace bench {
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Seconds elapsed since the given time point
+inline double seconds_since(const Clock::time_point& start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Runs fn `repeats` times and returns the best (smallest) wall time in seconds
+template <typename Fn>
+double best_of(const int repeats, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < repeats; ++r) {
+        const auto start = Clock::now();
+        fn();
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+// All instance file names under kDataPath, sorted by problem size (i.e. the number in the name)
+inline std::vector<std::string> data_instances() {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(kDataPath)) {
+        if (entry.path().extension() == ".evrp") files.push_back(entry.path().filename().string());
+    }
+    auto size_of = [](const std::string& name) { return std::stoi(name.substr(name.find('n') + 1)); };
+    std::sort(files.begin(), files.end(), [&](const std::string& a, const std::string& b) {
+        return size_of(a) != size_of(b) ? size_of(a) < size_of(b) : a < b;
+    });
+    return files;
+}
+
+// Resident set size of the process in bytes, 0 where /proc/self/statm is not available
+inline size_t resident_bytes() {
+    size_t pages = 0, resident = 0;
+#ifdef __linux__
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%zu %zu", &pages, &resident) != 2) resident = 0;
+        std::fclose(statm);
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return resident;
+#endif
+}
+
+// Hardware cache misses of the calling thread between start() and stop(), read through perf_event_open on Linux.
+// available() is false where the counter can not be opened (other systems, containers, perf_event_paranoid).
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    [[nodiscard]] bool available() const { return fd_ >= 0; }
+
+    void start() const {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // Misses counted since start(), -1 if the counter is not available
+    [[nodiscard]] long long stop() const {
+        long long count = -1;
+#ifdef __linux__
+        if (fd_ < 0) return count;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != sizeof(count)) count = -1;
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+} // namespace bench
+
+void bench_case_startup(int argc, char* argv[]);
+void bench_instance_cache(int argc, char* argv[]);
+void bench_search_throughput(int argc, char* argv[]);
+void bench_distance_precision(int argc, char* argv[]);
+void bench_matrix_free(int argc, char* argv[]);
+void bench_node_order(int argc, char* argv[]);
+void bench_startup_phases(int argc, char* argv[]);
+void bench_spatial_index(int argc, char* argv[]);
+void bench_shared_trials(int argc, char* argv[]);
+void bench_cooperative_lahc(int argc, char* argv[]);
+void bench_island_scaling(int argc, char* argv[]);
+void bench_history_stats(int argc, char* argv[]);
+void bench_route_cache(int argc, char* argv[]);
+void bench_follower_dp(int argc, char* argv[]);
+void bench_remove_enum(int argc, char* argv[]);
+
+#endif //FROGS_BENCH_HPP
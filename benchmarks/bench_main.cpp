@@ -0,0 +1,35 @@
+#include "bench.hpp"
+#include <iostream>
+#include <map>
+
+using namespace std;
+
+// Usage: ./Benchmarks <name> [args...], run from the build directory so that kDataPath resolves
+int main(int argc, char *argv[]) {
+    const map<string, void (*)(int, char**)> benchmarks = {
+            {"case_startup", bench_case_startup},
+            {"cooperative_lahc", bench_cooperative_lahc},
+            {"distance_precision", bench_distance_precision},
+            {"follower_dp", bench_follower_dp},
+            {"history_stats", bench_history_stats},
+            {"instance_cache", bench_instance_cache},
+            {"island_scaling", bench_island_scaling},
+            {"matrix_free", bench_matrix_free},
+            {"node_order", bench_node_order},
+            {"remove_enum", bench_remove_enum},
+            {"route_cache", bench_route_cache},
+            {"search_throughput", bench_search_throughput},
+            {"shared_trials", bench_shared_trials},
+            {"spatial_index", bench_spatial_index},
+            {"startup_phases", bench_startup_phases},
+    };
+
+    if (argc < 2 || benchmarks.find(argv[1]) == benchmarks.end()) {
+        cout << "Usage: ./Benchmarks <name> [args...]\nAvailable benchmarks:\n";
+        for (const auto& [name, fn] : benchmarks) cout << "  " << name << "\n";
+        return argc < 2 ? 0 : 1;
+    }
+
+    benchmarks.at(argv[1])(argc - 2, argv + 2);
+    return 0;
+}
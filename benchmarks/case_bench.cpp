@@ -0,0 +1,113 @@
+#include "bench.hpp"
+#include "mapped_file.hpp"
+#include <iomanip>
+
+namespace {
+
+// The line-based reader Case used before the mapped tokenizer, kept here as the reference for the comparison
+void legacy_parse(const string& file_path, Case& c) {
+    c.num_depot_ = 1;
+    auto extract_value = [&](const string& line) {
+        return line.substr(line.find(':') + 1);
+    };
+
+    ifstream infile(file_path);
+    string line;
+    while (getline(infile, line)) {
+        stringstream ss;
+        if (line.find("DIMENSION:") != string::npos) {
+            ss << extract_value(line);
+            ss >> c.num_customer_;
+            c.num_customer_--;
+        } else if (line.find("STATIONS:") != string::npos) {
+            ss << extract_value(line);
+            ss >> c.num_station_;
+        } else if (line.find("VEHICLES:") != string::npos) {
+            ss << extract_value(line);
+            ss >> c.num_vehicle_;
+        } else if (line.find("CAPACITY:") != string::npos && line.find("ENERGY") == string::npos) {
+            ss << extract_value(line);
+            ss >> c.max_vehicle_capa_;
+        } else if (line.find("ENERGY_CAPACITY:") != string::npos) {
+            ss << extract_value(line);
+            ss >> c.max_battery_capa_;
+        } else if (line.find("ENERGY_CONSUMPTION:") != string::npos) {
+            ss << extract_value(line);
+            ss >> c.energy_consumption_rate_;
+        } else if (line.find("OPTIMAL_VALUE:") != string::npos) {
+            ss << extract_value(line);
+            ss >> c.optimum_;
+        } else if (line.find("NODE_COORD_SECTION") != string::npos) {
+            c.problem_size_ = c.num_depot_ + c.num_customer_ + c.num_station_;
+            c.positions_.assign(c.problem_size_, {0, 0});
+            for (int i = 0; i < c.problem_size_; ++i) {
+                getline(infile, line);
+                ss.str(line);
+                int ind;
+                double x, y;
+                ss >> ind >> x >> y;
+                c.positions_[ind - 1] = {x, y};
+            }
+        } else if (line.find("DEMAND_SECTION") != string::npos) {
+            const int total_number = c.num_depot_ + c.num_customer_;
+            c.demand_.assign(total_number, 0);
+            for (int i = 0; i < total_number; ++i) {
+                getline(infile, line);
+                ss.clear();
+                ss.str(line);
+                int ind, d;
+                ss >> ind >> d;
+                c.demand_[ind - 1] = d;
+                if (d == 0) c.depot_ = ind - 1;
+            }
+        }
+    }
+}
+
+bool same_problem(const Case& a, const Case& b) {
+    return a.num_customer_ == b.num_customer_ && a.num_station_ == b.num_station_ && a.num_vehicle_ == b.num_vehicle_ &&
+           a.max_vehicle_capa_ == b.max_vehicle_capa_ && a.max_battery_capa_ == b.max_battery_capa_ &&
+           a.energy_consumption_rate_ == b.energy_consumption_rate_ && a.optimum_ == b.optimum_ &&
+           a.depot_ == b.depot_ && a.positions_ == b.positions_ && a.demand_ == b.demand_;
+}
+
+} // namespace
+
+// Startup cost of loading every instance under data/: the legacy line parser, the mapped tokenizer, and the full
+// Case construction (parsing + distance matrix). Optional argument: number of repetitions (default 20).
+void bench_case_startup(const int argc, char* argv[]) {
+    const int repeats = argc > 0 ? std::stoi(argv[0]) : 20;
+
+    cout << left << setw(20) << "instance" << right << setw(14) << "legacy(ms)" << setw(14) << "mapped(ms)"
+         << setw(10) << "speedup" << setw(14) << "case(ms)" << setw(8) << "same" << "\n";
+
+    double total_legacy = 0, total_mapped = 0, total_case = 0;
+    for (const auto& file_name : bench::data_instances()) {
+        const string file_path = kDataPath + file_name;
+        const Case reference(file_name);
+
+        bool same = true;
+        const double legacy = bench::best_of(repeats, [&]() {
+            Case parsed;
+            legacy_parse(file_path, parsed);
+            same = same && same_problem(parsed, reference);
+        });
+        const double mapped = bench::best_of(repeats, [&]() {
+            Case parsed;
+            const MappedFile file(file_path);
+            parsed.parse_problem(file.data(), file.end());
+            same = same && same_problem(parsed, reference);
+        });
+        const double full = bench::best_of(repeats, [&]() { Case c(file_name); });
+
+        total_legacy += legacy;
+        total_mapped += mapped;
+        total_case += full;
+        cout << left << setw(20) << file_name << right << fixed << setprecision(3)
+             << setw(14) << legacy * 1e3 << setw(14) << mapped * 1e3 << setw(9) << legacy / mapped << "x"
+             << setw(14) << full * 1e3 << setw(8) << (same ? "yes" : "NO") << "\n";
+    }
+    cout << left << setw(20) << "total" << right << fixed << setprecision(3)
+         << setw(14) << total_legacy * 1e3 << setw(14) << total_mapped * 1e3 << setw(9) << total_legacy / total_mapped << "x"
+         << setw(14) << total_case * 1e3 << "\n";
+}
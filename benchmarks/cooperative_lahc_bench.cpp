@@ -0,0 +1,50 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "lahc.hpp"
+#include "shared_best.hpp"
+#include "trial_scheduler.hpp"
+#include <iomanip>
+
+// Time to reach a target quality with `threads` LAHC runs (seeds 1..threads, max-evals stopping criterion), independent
+// against cooperative (-coop 1). The targets are the final best of the independent runs and 1% / 0.1% above it; the
+// time of a target is when the best of the group first reached it.
+// Optional arguments: instance file name (default E-n51-k5.evrp), threads (default 4).
+void bench_cooperative_lahc(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "E-n51-k5.evrp";
+    const int threads = argc > 1 ? std::stoi(argv[1]) : 4;
+
+    Parameters params;
+    params.instance = file_name;
+    const Case instance(file_name, params);
+    const Preprocessor preprocessor(instance, params);
+
+    auto run_group = [&](SharedBest& shared, const double restart_rate) {
+        const TrialScheduler scheduler(threads, threads, false, 0);
+        const auto start = bench::Clock::now();
+        scheduler.run([&](int, const int seed) {
+            Lahc lahc(seed, &instance, &preprocessor);
+            lahc.share_best(&shared, restart_rate);
+            lahc.run();
+            return lahc.global_best->lower_cost;
+        });
+        return bench::seconds_since(start);
+    };
+
+    // Times are measured from the creation of each SharedBest, right before its group starts
+    SharedBest independent(false);
+    const double independent_seconds = run_group(independent, 0.0);
+    SharedBest cooperative;
+    const double cooperative_seconds = run_group(cooperative, Lahc::kSharedRestartRate);
+
+    const double target = independent.best_cost();
+    cout << "instance: " << file_name << ", threads: " << threads << ", target: " << fixed << setprecision(2) << target << "\n"
+         << left << setw(14) << "mode" << right << setw(12) << "best" << setw(14) << "t(+1%)(s)" << setw(14) << "t(+0.1%)(s)"
+         << setw(14) << "t(target)(s)" << setw(14) << "total(s)" << setw(14) << "improvements" << "\n";
+    for (const auto& [name, shared, seconds] : {std::make_tuple("independent", &independent, independent_seconds),
+                                                std::make_tuple("cooperative", &cooperative, cooperative_seconds)}) {
+        cout << left << setw(14) << name << right << fixed << setprecision(2) << setw(12) << shared->best_cost()
+             << setprecision(3) << setw(14) << shared->seconds_to_reach(target * 1.01)
+             << setw(14) << shared->seconds_to_reach(target * 1.001) << setw(14) << shared->seconds_to_reach(target)
+             << setw(14) << seconds << setw(14) << shared->num_improvements() << "\n";
+    }
+}
@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "Split.h"
+#include "leader_array.hpp"
+#include "follower.hpp"
+#include <iomanip>
+
+// Search throughput and objective drift of the distance matrix precision this binary was built with (distance_t,
+// see -DFLOAT_DISTANCES). On every instance of data/ the leader runs a fixed number of moves and the follower is
+// called every `interval` moves; the drift is the largest gap between the follower cost built from the matrix and
+// the same routes measured from the coordinates in double precision. Build once with and once without the option
+// to compare. Optional arguments: leader moves per instance (default 200,000), follower interval (default 1,000).
+void bench_distance_precision(const int argc, char* argv[]) {
+    const long leader_moves = argc > 0 ? std::stol(argv[0]) : 200'000L;
+    const long interval = argc > 1 ? std::stol(argv[1]) : 1'000L;
+
+    cout << "distance_t: " << (sizeof(distance_t) == sizeof(float) ? "float" : "double") << "\n"
+         << left << setw(20) << "instance" << right << setw(12) << "matrix(MB)" << setw(14) << "moves/s"
+         << setw(14) << "calls/s" << setw(14) << "max drift" << setw(14) << "max rel" << "\n";
+
+    double total_time = 0, max_relative = 0;
+    long total_moves = 0;
+    for (const auto& file_name : bench::data_instances()) {
+        Parameters params;
+        params.instance = file_name;
+        Case instance(file_name, params);
+        Preprocessor preprocessor(instance, params);
+        Split split(params.seed, &instance, &preprocessor);
+        LeaderArray leader(params.seed, &instance, &preprocessor);
+        Follower follower(&instance, &preprocessor);
+
+        Individual ind(&instance, &preprocessor);
+        split.initIndividualWithHienClustering(&ind);
+        const double initial_cost = ind.upper_cost.penalised_cost;
+        leader.load_individual(&ind);
+
+        double leader_time = 0, follower_time = 0, drift = 0, relative = 0;
+        long calls = 0;
+        for (long i = 0; i < leader_moves; i += interval) {
+            auto start = bench::Clock::now();
+            for (long j = 0; j < interval; ++j) {
+                leader.neighbour_explore(initial_cost);
+            }
+            leader.export_individual(&ind);
+            leader_time += bench::seconds_since(start);
+
+            start = bench::Clock::now();
+            follower.run(&ind);
+            follower_time += bench::seconds_since(start);
+            calls++;
+
+            if (follower.lower_cost < INFEASIBLE) {
+                const double exact = instance.calculate_exact_dist_follower(follower.lower_routes, follower.num_routes, follower.lower_num_nodes_per_route);
+                drift = std::max(drift, std::abs(follower.lower_cost - exact));
+                relative = std::max(relative, std::abs(follower.lower_cost - exact) / exact);
+            }
+        }
+
+        total_time += leader_time;
+        total_moves += leader_moves;
+        max_relative = std::max(max_relative, relative);
+        cout << left << setw(20) << file_name << right << fixed << setprecision(3)
+             << setw(12) << static_cast<double>(instance.distance_bytes_) / (1024.0 * 1024.0)
+             << setprecision(0) << setw(14) << static_cast<double>(leader_moves) / leader_time
+             << setw(14) << static_cast<double>(calls) / follower_time
+             << scientific << setprecision(2) << setw(14) << drift << setw(14) << relative << "\n";
+    }
+    cout << left << setw(20) << "total" << right << fixed << setprecision(0) << setw(26)
+         << static_cast<double>(total_moves) / total_time << setw(28) << scientific << setprecision(2) << max_relative << "\n";
+}
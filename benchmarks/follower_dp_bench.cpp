@@ -0,0 +1,57 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "Split.h"
+#include "follower.hpp"
+#include <cmath>
+#include <iomanip>
+
+// Optimal station insertion: Follower::refine (enumeration of the station positions and stations, explicit stack)
+// against Follower::optimise (label-setting dynamic program), on the initial solutions of seeds 1..solutions with the
+// battery range scaled down. Reports the time per solution, the mean lower cost and the solutions left infeasible.
+// Optional arguments: instance file name (default E-n22-k4.evrp), solutions (default 20), smallest range factor
+// (default 0.7).
+void bench_follower_dp(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "E-n22-k4.evrp";
+    const int num_solutions = argc > 1 ? std::stoi(argv[1]) : 20;
+    const double min_factor = argc > 2 ? std::stod(argv[2]) : 0.7;
+
+    Parameters params;
+    params.instance = file_name;
+    const Case instance(file_name, params);
+    Preprocessor preprocessor(instance, params);
+    const double max_range = preprocessor.max_cruise_distance_;
+
+    vector<Individual> solutions;
+    for (int seed = 1; seed <= num_solutions; ++seed) {
+        Split split(seed, &instance, &preprocessor);
+        solutions.emplace_back(&instance, &preprocessor);
+        split.initIndividualWithHienClustering(&solutions.back());
+    }
+
+    cout << "instance: " << file_name << ", solutions: " << num_solutions << "\n"
+         << right << setw(8) << "range" << setw(14) << "mode" << setw(16) << "ms/solution" << setw(16) << "mean cost"
+         << setw(12) << "infeasible" << setw(16) << "lookups/sol" << "\n";
+    for (double factor = 1.0; factor >= min_factor - 1e-9; factor -= 0.1) {
+        preprocessor.max_cruise_distance_ = max_range * factor;
+        for (const bool dp : {false, true}) {
+            Follower follower(&instance, &preprocessor);
+            double total_cost = 0.0;
+            int infeasible = 0;
+            const auto start = bench::Clock::now();
+            for (auto solution : solutions) {
+                dp ? follower.optimise(&solution) : follower.refine(&solution);
+                // optimise adds INFEASIBLE for a route without a plan, refine adds -1 and leaves the route as it was
+                const double distance = instance.calculate_total_dist_follower(follower.lower_routes, follower.num_routes, follower.lower_num_nodes_per_route);
+                const bool feasible = solution.lower_cost < INFEASIBLE && std::abs(solution.lower_cost - distance) < 1e-6;
+                infeasible += !feasible;
+                if (feasible) total_cost += solution.lower_cost;
+            }
+            const double seconds = bench::seconds_since(start);
+            cout << fixed << setprecision(1) << setw(8) << factor << setw(14) << (dp ? "dp" : "enumeration")
+                 << setprecision(3) << setw(16) << 1e3 * seconds / num_solutions << setprecision(2)
+                 << setw(16) << (infeasible < num_solutions ? total_cost / (num_solutions - infeasible) : 0.0)
+                 << setw(12) << infeasible << setw(16) << follower.num_lookups / num_solutions << "\n" << flush;
+        }
+    }
+    preprocessor.max_cruise_distance_ = max_range;
+}
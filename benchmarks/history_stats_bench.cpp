@@ -0,0 +1,50 @@
+#include "bench.hpp"
+#include "history_stats.hpp"
+#include <iomanip>
+#include <random>
+
+// Cost of the history list indicators in a LAHC-like stream of updates: each iteration lowers a slot with probability
+// 1/2, and the indicators are read every `period` iterations, either with a full pass (calculate_statistical_indicators)
+// or from HistoryStats. The periods run from every iteration to once per history length, as Lahc logs them.
+// Optional arguments: history length (default 5000), iterations (default 2000000).
+void bench_history_stats(const int argc, char* argv[]) {
+    const size_t length = argc > 0 ? std::stoul(argv[0]) : 5000;
+    const long iterations = argc > 1 ? std::stol(argv[1]) : 2'000'000L;
+
+    cout << "history length: " << length << ", iterations: " << iterations << "\n"
+         << right << setw(10) << "period" << setw(16) << "full pass(s)" << setw(16) << "streaming(s)"
+         << setw(12) << "speedup" << setw(14) << "|std diff|" << "\n";
+    for (const size_t period : {size_t{1}, size_t{16}, size_t{256}, length}) {
+        // A full pass per read is too slow at short periods, so its iterations are scaled down and the time scaled up
+        const long full_iterations = std::min<long>(iterations, 20'000L * static_cast<long>(period));
+        Indicators full{}, streaming{};
+
+        auto run = [&](const long num_iterations, const bool incremental, Indicators& out) {
+            std::mt19937 random_engine(1);
+            std::uniform_real_distribution<double> step(0.0, 1.0);
+            vector<double> history(length, 1000.0);
+            HistoryStats stats;
+            stats.assign(history);
+            double level = 1000.0;
+            for (long iter = 0; iter < num_iterations; ++iter) {
+                const size_t v = iter % length;
+                level -= step(random_engine) * 1e-3;
+                if (step(random_engine) < 0.5 && level < history[v]) {
+                    history[v] = level;
+                    if (incremental) stats.replace(v, level);
+                }
+                if (iter % period == 0) {
+                    out = incremental ? stats.indicators() : StatsInterface::calculate_statistical_indicators(history);
+                }
+            }
+        };
+
+        const double full_seconds = bench::best_of(1, [&] { run(full_iterations, false, full); })
+                                    * static_cast<double>(iterations) / static_cast<double>(full_iterations);
+        const double streaming_seconds = bench::best_of(1, [&] { run(iterations, true, streaming); });
+        run(full_iterations, true, streaming);  // same stream as the full pass, for the difference
+        cout << setw(10) << period << fixed << setprecision(4) << setw(16) << full_seconds << setw(16) << streaming_seconds
+             << setprecision(1) << setw(11) << full_seconds / streaming_seconds << "x" << scientific << setprecision(2)
+             << setw(14) << std::abs(full.std - streaming.std) << defaultfloat << "\n";
+    }
+}
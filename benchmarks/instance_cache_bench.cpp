@@ -0,0 +1,31 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include <iomanip>
+
+// Startup time of Case + Preprocessor without the instance cache and with a warm cache file.
+// Optional arguments: instance file name (default: all of data/), number of repetitions (default 3).
+void bench_instance_cache(const int argc, char* argv[]) {
+    const vector<string> instances = argc > 0 ? vector<string>{argv[0]} : bench::data_instances();
+    const int repeats = argc > 1 ? std::stoi(argv[1]) : 3;
+
+    cout << left << setw(20) << "instance" << right << setw(14) << "build(ms)" << setw(14) << "cached(ms)" << setw(10) << "speedup" << "\n";
+    for (const auto& file_name : instances) {
+        Parameters params;
+        params.instance = file_name;
+
+        const double build = bench::best_of(repeats, [&]() {
+            Case instance(file_name, params);
+            Preprocessor preprocessor(instance, params);
+        });
+
+        params.enable_instance_cache = true;
+        { Case instance(file_name, params); Preprocessor warm_up(instance, params); }
+        const double cached = bench::best_of(repeats, [&]() {
+            Case instance(file_name, params);
+            Preprocessor preprocessor(instance, params);
+        });
+
+        cout << left << setw(20) << file_name << right << fixed << setprecision(3)
+             << setw(14) << build * 1e3 << setw(14) << cached * 1e3 << setw(9) << build / cached << "x\n";
+    }
+}
@@ -0,0 +1,54 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "lahc.hpp"
+#include "island_model.hpp"
+#include "command_line.hpp"
+#include "trial_scheduler.hpp"
+#include <iomanip>
+
+// Scaling of the island model from 1 to `max_threads` threads, doubling: each thread is one island running one LAHC
+// descent capped at `iterations` iterations, migrating every `interval` iterations on a ring. Reports the wall time,
+// the aggregate iteration rate, its speedup over one thread, and the best and mean objective of the islands.
+// Optional arguments: instance file name (default X-n916-k207.evrp), max threads (default 64), iterations per island
+// (default 1000), migration interval (default 100), topology (ring or random, default ring).
+void bench_island_scaling(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "X-n916-k207.evrp";
+    const int max_threads = argc > 1 ? std::stoi(argv[1]) : 64;
+    const long iterations = argc > 2 ? std::stol(argv[2]) : 1'000;
+    const int interval = argc > 3 ? std::stoi(argv[3]) : 100;
+    const Topology topology = argc > 4 ? CommandLine::string_to_topology(argv[4]) : Topology::RING;
+
+    Parameters params;
+    params.instance = file_name;
+    const Case instance(file_name, params);
+    const Preprocessor preprocessor(instance, params);
+
+    cout << "instance: " << file_name << ", iterations per island: " << iterations << ", migration interval: " << interval
+         << ", hardware threads: " << std::thread::hardware_concurrency() << "\n"
+         << setw(8) << "threads" << setw(12) << "wall(s)" << setw(14) << "iters/s" << setw(10) << "speedup"
+         << setw(12) << "best" << setw(12) << "mean" << setw(10) << "sent" << setw(10) << "dropped" << "\n";
+    double base_rate = 0.0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        IslandModel islands(threads, topology, interval);
+        const TrialScheduler scheduler(threads, threads, false, 0);
+        const auto start = bench::Clock::now();
+        const auto reports = scheduler.run([&](const int trial, const int seed) {
+            Lahc lahc(seed, &instance, &preprocessor);
+            lahc.join_islands(&islands, trial);
+            lahc.iteration_limit = iterations;
+            lahc.initialize_heuristic();
+            lahc.run_heuristic();
+            return lahc.global_best->lower_cost;
+        });
+        const double seconds = bench::seconds_since(start);
+
+        vector<double> results;
+        for (const auto& report : reports) results.push_back(report.result);
+        const Indicators indicators = StatsInterface::calculate_statistical_indicators(results);
+        const double rate = static_cast<double>(iterations) * threads / seconds;
+        if (threads == 1) base_rate = rate;
+        cout << setw(8) << threads << fixed << setprecision(2) << setw(12) << seconds << setw(14) << rate
+             << setw(10) << rate / base_rate << setw(12) << indicators.min << setw(12) << indicators.avg
+             << setw(10) << islands.num_sent() << setw(10) << islands.num_dropped() << "\n";
+    }
+}
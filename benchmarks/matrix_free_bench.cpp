@@ -0,0 +1,92 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "Split.h"
+#include "leader_array.hpp"
+#include "follower.hpp"
+#include <iomanip>
+
+namespace {
+
+struct BackendResult {
+    double startup;         // Case + Preprocessor, seconds
+    double scalar;          // distance() lookups per second
+    double batched;         // distances_from() distances per second
+    double moves;           // leader moves per second
+    double calls;           // follower calls per second
+    double lower_cost;
+};
+
+BackendResult run_backend(const Parameters& params, const long leader_moves, const long follower_calls) {
+    BackendResult result{};
+    auto start = bench::Clock::now();
+    Case instance(params.instance, params);
+    Preprocessor preprocessor(instance, params);
+    result.startup = bench::seconds_since(start);
+
+    // All pairs, once one at a time and once a row at a time
+    const int n = instance.problem_size_;
+    vector<double> row(n);
+    double sum = 0;
+    start = bench::Clock::now();
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) sum += instance.distance(i, j);
+    }
+    result.scalar = static_cast<double>(n) * n / bench::seconds_since(start);
+    start = bench::Clock::now();
+    for (int i = 0; i < n; ++i) {
+        instance.distances_from(i, 0, n, row.data());
+        sum -= std::accumulate(row.begin(), row.end(), 0.0);
+    }
+    result.batched = static_cast<double>(n) * n / bench::seconds_since(start);
+    if (std::abs(sum) > 1e-3) cout << "batched distances differ from the scalar ones: " << sum << "\n";
+
+    Split split(params.seed, &instance, &preprocessor);
+    LeaderArray leader(params.seed, &instance, &preprocessor);
+    Follower follower(&instance, &preprocessor);
+    Individual ind(&instance, &preprocessor);
+    split.initIndividualWithHienClustering(&ind);
+    const double initial_cost = ind.upper_cost.penalised_cost;
+
+    leader.load_individual(&ind);
+    start = bench::Clock::now();
+    for (long i = 0; i < leader_moves; ++i) {
+        leader.neighbour_explore(initial_cost);
+    }
+    result.moves = static_cast<double>(leader_moves) / bench::seconds_since(start);
+    leader.export_individual(&ind);
+
+    start = bench::Clock::now();
+    for (long i = 0; i < follower_calls; ++i) {
+        follower.run(&ind);
+    }
+    result.calls = static_cast<double>(follower_calls) / bench::seconds_since(start);
+    result.lower_cost = ind.lower_cost;
+    return result;
+}
+
+} // namespace
+
+// Dense distance matrix against the matrix-free backend (Parameters::matrix_free_threshold = 0) on one instance:
+// startup, scalar and batched distance throughput, and search throughput, which must reach the same lower cost.
+// Optional arguments: instance file name (default X-n1001-k43.evrp), leader moves (default 1,000,000),
+// follower calls (default 1,000).
+void bench_matrix_free(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "X-n1001-k43.evrp";
+    const long leader_moves = argc > 1 ? std::stol(argv[1]) : 1'000'000L;
+    const long follower_calls = argc > 2 ? std::stol(argv[2]) : 1'000L;
+
+    Parameters params;
+    params.instance = file_name;
+    const BackendResult dense = run_backend(params, leader_moves, follower_calls);
+    params.matrix_free_threshold = 0;
+    const BackendResult matrix_free = run_backend(params, leader_moves, follower_calls);
+
+    cout << "instance: " << file_name << "\n"
+         << left << setw(14) << "backend" << right << setw(14) << "startup(ms)" << setw(16) << "scalar/s"
+         << setw(16) << "batched/s" << setw(14) << "moves/s" << setw(12) << "calls/s" << setw(16) << "lower cost" << "\n";
+    for (const auto& [name, result] : {pair<string, BackendResult>{"dense", dense}, {"matrix-free", matrix_free}}) {
+        cout << left << setw(14) << name << right << fixed << setprecision(1) << setw(14) << result.startup * 1e3
+             << setprecision(0) << setw(16) << result.scalar << setw(16) << result.batched << setw(14) << result.moves
+             << setw(12) << result.calls << setprecision(2) << setw(16) << result.lower_cost << "\n";
+    }
+}
@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "Split.h"
+#include "leader_array.hpp"
+#include "follower.hpp"
+#include <iomanip>
+
+namespace {
+
+struct OrderResult {
+    double moves;           // leader moves per second
+    double calls;           // follower calls per second
+    long long misses;       // cache misses per leader move, -1 if not measured
+};
+
+OrderResult run_order(const Parameters& params, const long leader_moves, const long follower_calls) {
+    Case instance(params.instance, params);
+    Preprocessor preprocessor(instance, params);
+    Split split(params.seed, &instance, &preprocessor);
+    LeaderArray leader(params.seed, &instance, &preprocessor);
+    Follower follower(&instance, &preprocessor);
+    Individual ind(&instance, &preprocessor);
+    split.initIndividualWithHienClustering(&ind);
+    const double initial_cost = ind.upper_cost.penalised_cost;
+
+    OrderResult result{};
+    const bench::CacheMissCounter counter;
+    leader.load_individual(&ind);
+    counter.start();
+    auto start = bench::Clock::now();
+    for (long i = 0; i < leader_moves; ++i) {
+        leader.neighbour_explore(initial_cost);
+    }
+    result.moves = static_cast<double>(leader_moves) / bench::seconds_since(start);
+    const long long misses = counter.stop();
+    result.misses = misses < 0 ? -1 : misses / leader_moves;
+    leader.export_individual(&ind);
+
+    start = bench::Clock::now();
+    for (long i = 0; i < follower_calls; ++i) {
+        follower.run(&ind);
+    }
+    result.calls = static_cast<double>(follower_calls) / bench::seconds_since(start);
+    return result;
+}
+
+} // namespace
+
+// Nodes in file order against nodes renumbered along a Hilbert curve (Parameters::renumber_nodes), on every X-n*
+// instance of data/: leader moves/s, follower calls/s and, where perf counters are available, cache misses per move.
+// Optional arguments: leader moves (default 1,000,000), follower calls (default 500).
+void bench_node_order(const int argc, char* argv[]) {
+    const long leader_moves = argc > 0 ? std::stol(argv[0]) : 1'000'000L;
+    const long follower_calls = argc > 1 ? std::stol(argv[1]) : 500L;
+
+    cout << left << setw(20) << "instance" << right << setw(14) << "file moves/s" << setw(14) << "curve moves/s"
+         << setw(14) << "file calls/s" << setw(14) << "curve calls/s" << setw(14) << "file misses" << setw(14) << "curve misses" << "\n";
+    for (const auto& file_name : bench::data_instances()) {
+        if (file_name[0] != 'X') continue;
+
+        Parameters params;
+        params.instance = file_name;
+        const OrderResult file_order = run_order(params, leader_moves, follower_calls);
+        params.renumber_nodes = true;
+        const OrderResult curve_order = run_order(params, leader_moves, follower_calls);
+
+        auto misses = [](const long long value) { return value < 0 ? string("n/a") : to_string(value); };
+        cout << left << setw(20) << file_name << right << fixed << setprecision(0)
+             << setw(14) << file_order.moves << setw(14) << curve_order.moves
+             << setw(14) << file_order.calls << setw(14) << curve_order.calls
+             << setw(14) << misses(file_order.misses) << setw(14) << misses(curve_order.misses) << "\n";
+    }
+}
@@ -0,0 +1,50 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "follower.hpp"
+#include <iomanip>
+
+// Follower::insert_station_by_remove_enum on long routes: nearest-neighbour tours from the depot over the first
+// customers of the instance, which need a station every few arcs. Reports the best time of a repair, the time per node
+// and the stations left on the route. Optional arguments: instance file name (default X-n1001-k43.evrp), repeats
+// (default 5).
+void bench_remove_enum(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "X-n1001-k43.evrp";
+    const int repeats = argc > 1 ? std::stoi(argv[1]) : 5;
+
+    Parameters params;
+    params.instance = file_name;
+    const Case instance(file_name, params);
+    const Preprocessor preprocessor(instance, params);
+    Follower follower(&instance, &preprocessor);
+
+    cout << "instance: " << file_name << ", repeats: " << repeats << "\n"
+         << right << setw(10) << "nodes" << setw(14) << "time(ms)" << setw(14) << "ns/node" << setw(12) << "stations"
+         << setw(16) << "cost" << "\n";
+    const int num_customers = static_cast<int>(preprocessor.customer_ids_.size());
+    for (int customers = 50; customers <= num_customers; customers *= 2) {
+        // Nearest-neighbour tour over the first customers, depot to depot
+        vector<int> left(preprocessor.customer_ids_.begin(), preprocessor.customer_ids_.begin() + customers);
+        vector<int> route(1, instance.depot_);
+        while (!left.empty()) {
+            const auto next = std::min_element(left.begin(), left.end(), [&](const int a, const int b) {
+                return instance.distance(route.back(), a) < instance.distance(route.back(), b);
+            });
+            route.push_back(*next);
+            left.erase(next);
+        }
+        route.push_back(instance.depot_);
+
+        vector<int> repaired(2 * route.size());
+        int length = 0;
+        double cost = 0.0;
+        const double seconds = bench::best_of(repeats, [&]() {
+            std::copy(route.begin(), route.end(), repaired.begin());
+            length = static_cast<int>(route.size());
+            cost = follower.insert_station_by_remove_enum(repaired.data(), length);
+        });
+        cout << setw(10) << route.size() << fixed << setprecision(3) << setw(14) << 1e3 * seconds << setprecision(1)
+             << setw(14) << 1e9 * seconds / static_cast<double>(route.size())
+             << setw(12) << (cost == -1 ? -1 : length - static_cast<int>(route.size())) << setprecision(2)
+             << setw(16) << cost << "\n" << flush;
+    }
+}
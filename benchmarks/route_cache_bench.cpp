@@ -0,0 +1,33 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "lahc.hpp"
+#include <iomanip>
+
+// LAHC iterations from the same initial solution without and with the Follower route cache: wall time, hit rate, and
+// the best cost reached, which must be the same since a hit replays the repair it caches.
+// Optional arguments: instance file name (default X-n916-k207.evrp), iterations (default 20,000).
+void bench_route_cache(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "X-n916-k207.evrp";
+    const long iterations = argc > 1 ? std::stol(argv[1]) : 20'000L;
+
+    Parameters params;
+    params.instance = file_name;
+    const Case instance(file_name, params);
+    const Preprocessor preprocessor(instance, params);
+
+    cout << "instance: " << file_name << ", iterations: " << iterations << "\n"
+         << right << setw(14) << "cache size" << setw(12) << "time(s)" << setw(12) << "hit rate" << setw(14) << "best" << "\n";
+    for (const int size : {0, 1'024, 16'384, 262'144}) {
+        Parameters search = params;
+        search.route_cache_size = size;
+        Lahc lahc(1, &instance, &preprocessor, search);
+        lahc.iteration_limit = iterations;
+        lahc.initialize_heuristic();
+        const auto start = bench::Clock::now();
+        lahc.run_heuristic();
+        const double seconds = bench::seconds_since(start);
+        cout << setw(14) << size << fixed << setprecision(3) << setw(12) << seconds << setprecision(1)
+             << setw(11) << 100.0 * lahc.follower->route_cache.hit_rate() << "%" << setprecision(2)
+             << setw(14) << lahc.global_best->lower_cost << "\n";
+    }
+}
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "Split.h"
+#include "leader_array.hpp"
+#include "follower.hpp"
+#include <iomanip>
+
+// Throughput of the two search levels on one instance: LeaderArray::neighbour_explore moves (accepting any
+// candidate below the initial cost) and Follower::run calls on the resulting solution.
+// Optional arguments: instance file name (default X-n1001-k43.evrp), leader moves (default 2,000,000),
+// follower calls (default 2,000).
+void bench_search_throughput(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "X-n1001-k43.evrp";
+    const long leader_moves = argc > 1 ? std::stol(argv[1]) : 2'000'000L;
+    const long follower_calls = argc > 2 ? std::stol(argv[2]) : 2'000L;
+
+    Parameters params;
+    params.instance = file_name;
+    Case instance(file_name, params);
+    Preprocessor preprocessor(instance, params);
+    Split split(params.seed, &instance, &preprocessor);
+    LeaderArray leader(params.seed, &instance, &preprocessor);
+    Follower follower(&instance, &preprocessor);
+    follower.route_cache.resize(0);     // the same solution is repaired again and again, it would only measure hits
+
+    Individual ind(&instance, &preprocessor);
+    split.initIndividualWithHienClustering(&ind);
+    const double initial_cost = ind.upper_cost.penalised_cost;
+
+    leader.load_individual(&ind);
+    auto start = bench::Clock::now();
+    for (long i = 0; i < leader_moves; ++i) {
+        leader.neighbour_explore(initial_cost);
+    }
+    const double leader_time = bench::seconds_since(start);
+    leader.export_individual(&ind);
+
+    start = bench::Clock::now();
+    for (long i = 0; i < follower_calls; ++i) {
+        follower.run(&ind);
+    }
+    const double follower_time = bench::seconds_since(start);
+
+    cout << "instance            : " << file_name << "\n"
+         << fixed << setprecision(2)
+         << "upper cost          : " << initial_cost << " -> " << leader.upper_cost << "\n"
+         << "lower cost          : " << ind.lower_cost << "\n"
+         << setprecision(0)
+         << "leader moves/s      : " << static_cast<double>(leader_moves) / leader_time << "\n"
+         << "follower calls/s    : " << static_cast<double>(follower_calls) / follower_time << "\n"
+         << "follower routes/s   : " << static_cast<double>(follower_calls * follower.num_routes) / follower_time << "\n";
+}
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include "lahc.hpp"
+#include <iomanip>
+#include <memory>
+#include <thread>
+
+// Memory and startup time of `trials` trials of the multithreaded mode: one Case + Preprocessor per trial (as before)
+// against one copy shared read-only by all the trials. Each trial then runs one LAHC initialisation and a few leader
+// moves and follower calls on its own thread, so that the lazily filled tables are touched as in a real run.
+// Optional arguments: instance file name (default X-n916-k207.evrp), trials (default 10).
+void bench_shared_trials(const int argc, char* argv[]) {
+    const string file_name = argc > 0 ? argv[0] : "X-n916-k207.evrp";
+    const int trials = argc > 1 ? std::stoi(argv[1]) : 10;
+
+    Parameters params;
+    params.instance = file_name;
+    auto run_trial = [](const int seed, const Case* instance, const Preprocessor* preprocessor) {
+        Lahc lahc(seed, instance, preprocessor);
+        lahc.initialize_heuristic();
+        lahc.leader->load_individual(lahc.current);
+        for (int i = 0; i < 1'000; ++i) lahc.leader->neighbour_explore(lahc.leader->upper_cost);
+        lahc.leader->export_individual(lahc.current);
+        for (int i = 0; i < 10; ++i) lahc.follower->run(lahc.current);
+    };
+
+    cout << "instance: " << file_name << ", trials: " << trials << "\n"
+         << left << setw(12) << "tables" << right << setw(14) << "startup(ms)" << setw(14) << "tables(MB)" << setw(14) << "total(MB)" << "\n";
+    for (const bool shared : {true, false}) {
+        const size_t before = bench::resident_bytes();
+        const auto start = bench::Clock::now();
+        vector<unique_ptr<Case>> instances;
+        vector<unique_ptr<Preprocessor>> preprocessors;
+        for (int t = 0; t < (shared ? 1 : trials); ++t) {
+            instances.push_back(make_unique<Case>(file_name, params));
+            preprocessors.push_back(make_unique<Preprocessor>(*instances.back(), params));
+        }
+        const double startup = bench::seconds_since(start);
+        const double tables = static_cast<double>(bench::resident_bytes() - before) / (1024.0 * 1024.0);
+
+        vector<std::thread> threads;
+        for (int t = 0; t < trials; ++t) {
+            const int copy = shared ? 0 : t;
+            threads.emplace_back(run_trial, t + 1, instances[copy].get(), preprocessors[copy].get());
+        }
+        for (auto& thread : threads) thread.join();
+        const double total = static_cast<double>(bench::resident_bytes() - before) / (1024.0 * 1024.0);
+
+        cout << left << setw(12) << (shared ? "shared" : "per trial") << right << fixed << setprecision(1)
+             << setw(14) << startup * 1e3 << setw(14) << tables << setw(14) << total << "\n";
+    }
+}
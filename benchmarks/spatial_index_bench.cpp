@@ -0,0 +1,96 @@
+#include "bench.hpp"
+#include "spatial_index.hpp"
+#include <iomanip>
+#include <random>
+
+namespace {
+
+// The linear scan of Preprocessor::get_best_and_feasible_station over the candidate nodes
+int scan_best_detour(const Case& c, const vector<int>& nodes, const int from, const int to, const double max_from, const double max_to) {
+    int best = -1;
+    double min_dis = std::numeric_limits<double>::max();
+    for (const int i : nodes) {
+        if (c.distance(from, i) < max_from && min_dis > c.distance(from, i) + c.distance(to, i) &&
+            from != i && to != i && c.distance(i, to) < max_to) {
+            best = i;
+            min_dis = c.distance(from, i) + c.distance(to, i);
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+// SpatialIndex queries against the linear scans they replace, on every instance of data/: best feasible detour
+// station for short customer arcs and random ranges (as in Follower::insert_station_by_remove_enum), and the nb_granular
+// nearest customers (as in Preprocessor::build_tables). The "n" columns use all the customers as candidate stations,
+// to show how both approaches scale. Optional argument: number of detour queries (default 1,000,000).
+void bench_spatial_index(const int argc, char* argv[]) {
+    const int queries = argc > 0 ? std::stoi(argv[0]) : 1'000'000;
+    const int k = Parameters().nb_granular;
+
+    cout << left << setw(20) << "instance" << right << setw(10) << "stations" << setw(12) << "scan(ns)" << setw(12) << "index(ns)"
+         << setw(12) << "scan n(ns)" << setw(12) << "index n(ns)"
+         << setw(14) << "knn sort(ms)" << setw(14) << "knn tree(ms)" << setw(8) << "same" << "\n";
+    for (const auto& file_name : bench::data_instances()) {
+        const Case c(file_name);
+        const double max_cruise = c.max_battery_capa_ / c.energy_consumption_rate_;
+        vector<int> customers, stations;
+        for (int i = 1; i <= c.num_customer_; ++i) customers.push_back(i);
+        for (int i = c.num_customer_ + 1; i < c.problem_size_; ++i) stations.push_back(i);
+        const SpatialIndex station_index(c, stations);
+        const SpatialIndex customer_index(c, customers);
+
+        // Consecutive nodes of a route are mostly close: each arc goes to one of the 10 customers nearest to `from`
+        std::mt19937 engine(0);
+        std::uniform_int_distribution<int> node(1, c.num_customer_);
+        std::uniform_real_distribution<double> range(0.0, max_cruise);
+        vector<std::tuple<int, int, double>> arcs(queries);
+        vector<int> neighbours;
+        for (auto& [from, to, max_from] : arcs) {
+            from = node(engine);
+            customer_index.nearest(from, 10, neighbours);
+            to = neighbours[std::uniform_int_distribution<int>(0, static_cast<int>(neighbours.size()) - 1)(engine)];
+            max_from = range(engine);
+        }
+
+        // Average nanoseconds per query of the scan and of the index over the candidate nodes
+        bool same = true;
+        auto time_detours = [&](const vector<int>& nodes, const SpatialIndex& index) {
+            long long scan_sum = 0, index_sum = 0;
+            auto start = bench::Clock::now();
+            for (const auto& [from, to, max_from] : arcs) scan_sum += scan_best_detour(c, nodes, from, to, max_from, max_cruise);
+            const double scan = bench::seconds_since(start);
+            start = bench::Clock::now();
+            for (const auto& [from, to, max_from] : arcs) index_sum += index.best_detour(from, to, max_from, max_cruise);
+            const double indexed = bench::seconds_since(start);
+            same = same && scan_sum == index_sum;
+            return pair<double, double>(scan / queries * 1e9, indexed / queries * 1e9);
+        };
+        const auto [scan, index] = time_detours(stations, station_index);
+        // The customers as candidates show how the two scale with many stations
+        const auto [scan_many, index_many] = time_detours(customers, customer_index);
+
+        vector<pair<double, int>> order;
+        vector<vector<int>> sorted(c.num_customer_ + 1), tree(c.num_customer_ + 1);
+        auto start = bench::Clock::now();
+        for (int i = 1; i <= c.num_customer_; ++i) {
+            order.clear();
+            for (int j = 1; j <= c.num_customer_; ++j) {
+                if (i != j) order.emplace_back(c.distance(i, j), j);
+            }
+            const int m = std::min<int>(k, static_cast<int>(order.size()));
+            std::partial_sort(order.begin(), order.begin() + m, order.end());
+            for (int j = 0; j < m; ++j) sorted[i].push_back(order[j].second);
+        }
+        const double knn_sort = bench::seconds_since(start);
+        start = bench::Clock::now();
+        for (int i = 1; i <= c.num_customer_; ++i) customer_index.nearest(i, k, tree[i]);
+        const double knn_tree = bench::seconds_since(start);
+        same = same && sorted == tree;
+
+        cout << left << setw(20) << file_name << right << setw(10) << stations.size() << fixed << setprecision(1)
+             << setw(12) << scan << setw(12) << index << setw(12) << scan_many << setw(12) << index_many << setprecision(3)
+             << setw(14) << knn_sort * 1e3 << setw(14) << knn_tree * 1e3 << setw(8) << (same ? "yes" : "NO") << "\n";
+    }
+}
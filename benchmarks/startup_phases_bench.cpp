@@ -0,0 +1,41 @@
+#include "bench.hpp"
+#include "preprocessor.hpp"
+#include <iomanip>
+
+// Wall time of each construction phase of Case and Preprocessor (Case::startup_phases_, Preprocessor::startup_phases_)
+// on one thread and on `threads` threads. Optional arguments: instance file name (default: all of data/), threads
+// (default 0, all hardware threads). Also prints the size of the best station table and its share filled eagerly.
+void bench_startup_phases(const int argc, char* argv[]) {
+    const vector<string> instances = argc > 0 && string(argv[0]) != "all" ? vector<string>{argv[0]} : bench::data_instances();
+    const int threads = argc > 1 ? std::stoi(argv[1]) : 0;
+
+    cout << "threads: 1 and " << resolve_num_threads(threads) << "\n";
+    for (const auto& file_name : instances) {
+        vector<pair<string, double>> phases[2];
+        size_t table_bytes = 0, table_known = 0, table_size = 0;
+        for (int run = 0; run < 2; ++run) {
+            Parameters params;
+            params.instance = file_name;
+            params.build_threads = run == 0 ? 1 : threads;
+            Case instance(file_name, params);
+            Preprocessor preprocessor(instance, params);
+            phases[run] = instance.startup_phases_;
+            phases[run].insert(phases[run].end(), preprocessor.startup_phases_.begin(), preprocessor.startup_phases_.end());
+            table_bytes = preprocessor.best_station_.bytes();
+            table_known = preprocessor.best_station_.num_known();
+            table_size = preprocessor.best_station_.size();
+        }
+
+        cout << file_name << "\n";
+        double total[2] = {0, 0};
+        for (size_t p = 0; p < phases[0].size(); ++p) {
+            total[0] += phases[0][p].second;
+            total[1] += phases[1][p].second;
+            cout << "  " << left << setw(22) << phases[0][p].first << right << fixed << setprecision(3)
+                 << setw(12) << phases[0][p].second * 1e3 << " ms" << setw(12) << phases[1][p].second * 1e3 << " ms\n";
+        }
+        cout << "  " << left << setw(22) << "total" << right << setw(12) << total[0] * 1e3 << " ms" << setw(12) << total[1] * 1e3 << " ms\n";
+        cout << "  best_station_ " << table_bytes / 1024 << " KB, " << setprecision(1)
+             << 100.0 * static_cast<double>(table_known) / static_cast<double>(table_size) << "% filled at startup\n";
+    }
+}
@@ -117,12 +117,14 @@ class LocalSearch
 
 private:
 	
-    Case* instance;                             // Problem instance information
-    Preprocessor* preprocessor;                 // Preprocessed data
+    const Case* instance;                             // Problem instance information
+    const Preprocessor* preprocessor;                 // Preprocessed data
+    double metered_distance(int from, int to) const { ++num_lookups; return instance->distance(from, to); }
     std::default_random_engine random_engine;   // Random number generator
     bool searchCompleted;						// Tells whether all moves have been evaluated without success
 	int nbMoves;								// Total number of moves (RI and SWAP*) applied during the local search. Attention: this is not only a simple counter, it is also used to avoid repeating move evaluations
 	std::vector < int > orderNodes;				// Randomized order for checking the nodes in the RI local search
+	std::vector < std::vector < int > > correlatedVertices;	// Own copy of the correlated vertices of the Preprocessor, reshuffled by each run
 	std::vector < int > orderRoutes;			// Randomized order for checking the routes in the SWAP* local search
 	std::set < int > emptyRoutes;				// indices of all empty routes
 	int loopID;									// Current loop index
@@ -186,6 +188,8 @@ private:
 
 	public:
 
+    mutable uint64_t num_lookups{};             // distance lookups since the search last charged its EvaluationBudget
+
 	// Run the local search with the specified penalty values
 	void run(Individual * indiv, double penaltyCapacityLS, double penaltyDurationLS);
 
@@ -196,7 +200,7 @@ private:
 	void exportIndividual(Individual * indiv);
 
 	// Constructor
-	LocalSearch(int seed, Case* instance, Preprocessor* preprocessor);
+	LocalSearch(int seed, const Case* instance, const Preprocessor* preprocessor);
 };
 
 #endif
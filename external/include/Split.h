@@ -74,10 +74,10 @@ class Split
 private:
 
     // Problem parameters
-    Case* instance;
-    Preprocessor* preprocessor;
+    const Case* instance;
+    const Preprocessor* preprocessor;
+    double metered_distance(int from, int to) const { ++num_lookups; return instance->distance(from, to); }
     int maxVehicles{};
-    std::default_random_engine random_engine;
 
     /* Auxiliary data structures to run the Linear Split algorithm */
     std::vector < ClientSplit > cliSplit;
@@ -118,6 +118,9 @@ private:
 
 public:
 
+    mutable uint64_t num_lookups{};             // distance lookups since the search last charged its EvaluationBudget
+    std::default_random_engine random_engine;   // draws of the start solutions, saved in the checkpoints of a run
+
     // General Split function (tests the unlimited fleet, and only if it does not produce a feasible solution, runs the Split algorithm for limited fleet)
     void generalSplit(Individual * indiv, int nbMaxVehicles);
 
@@ -130,7 +133,7 @@ public:
     void initIndividualWithDirectEncoding(Individual* ind);
 
     // Constructor
-    Split(int seed, Case* instance, Preprocessor* preprocessor);
+    Split(int seed, const Case* instance, const Preprocessor* preprocessor);
 
 };
 #endif
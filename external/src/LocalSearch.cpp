@@ -13,7 +13,7 @@ void LocalSearch::run(Individual * indiv, double penaltyCapacityLS, double penal
     for (int i = 1; i <= instance->num_customer_; i++) {
         std::uniform_int_distribution<int> distribution(0, preprocessor->nb_granular_ - 1);
         if (distribution(random_engine) == 0) { // Random condition check
-            std::shuffle(preprocessor->correlated_vertices_[i].begin(),  preprocessor->correlated_vertices_[i].end(), random_engine);
+            std::shuffle(correlatedVertices[i].begin(),  correlatedVertices[i].end(), random_engine);
         }
     }
 
@@ -33,9 +33,9 @@ void LocalSearch::run(Individual * indiv, double penaltyCapacityLS, double penal
 			nodeU->whenLastTestedRI = nbMoves;
 //            count_nodeU++;
 //            std::cout << "nodeU changed: " << nodeU->cour <<  " | count_nodeU: " << count_nodeU << std::endl;
-			for (int posV = 0; posV < (int)preprocessor->correlated_vertices_[nodeU->cour].size(); posV++)
+			for (int posV = 0; posV < (int)correlatedVertices[nodeU->cour].size(); posV++)
 			{
-				nodeV = &clients[preprocessor->correlated_vertices_[nodeU->cour][posV]];
+				nodeV = &clients[correlatedVertices[nodeU->cour][posV]];
 //                if(lastTestRINodeU != -1) {
 //                    std::cout << "lastTestRINodeU: " << lastTestRINodeU << std::endl;
 //                }
@@ -131,8 +131,8 @@ void LocalSearch::setLocalVariablesRouteV()
 
 bool LocalSearch::move1()
 {
-	double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-	double costSuppV = instance->get_distance(nodeVIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+	double costSuppU = metered_distance(nodeUPrevIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+	double costSuppV = metered_distance(nodeVIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
 	if (routeU != routeV)
 	{
@@ -158,16 +158,16 @@ bool LocalSearch::move1()
 
 bool LocalSearch::move2()
 {
-	double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-	double costSuppV = instance->get_distance(nodeVIndex, nodeUIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+	double costSuppU = metered_distance(nodeUPrevIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+	double costSuppV = metered_distance(nodeVIndex, nodeUIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
 	if (routeU != routeV)
 	{
-		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - instance->get_distance(nodeUIndex, nodeXIndex) - serviceU - serviceX)
+		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - metered_distance(nodeUIndex, nodeXIndex) - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load - loadU - loadX)
 			- routeU->penalty;
 
-		costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + instance->get_distance(nodeUIndex, nodeXIndex) + serviceU + serviceX)
+		costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + metered_distance(nodeUIndex, nodeXIndex) + serviceU + serviceX)
 			+ penaltyExcessLoad(routeV->load + loadU + loadX)
 			- routeV->penalty;
 	}
@@ -186,8 +186,8 @@ bool LocalSearch::move2()
 
 bool LocalSearch::move3()
 {
-	double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-	double costSuppV = instance->get_distance(nodeVIndex, nodeXIndex) + instance->get_distance(nodeXIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+	double costSuppU = metered_distance(nodeUPrevIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+	double costSuppV = metered_distance(nodeVIndex, nodeXIndex) + metered_distance(nodeXIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
 	if (routeU != routeV)
 	{
@@ -214,8 +214,8 @@ bool LocalSearch::move3()
 
 bool LocalSearch::move4()
 {
-	double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-	double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+	double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+	double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
 	if (routeU != routeV)
 	{
@@ -241,16 +241,16 @@ bool LocalSearch::move4()
 
 bool LocalSearch::move5()
 {
-	double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeVIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-	double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+	double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeVIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+	double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
 	if (routeU != routeV)
 	{
-		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - instance->get_distance(nodeUIndex, nodeXIndex) + serviceV - serviceU - serviceX)
+		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - metered_distance(nodeUIndex, nodeXIndex) + serviceV - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load + loadV - loadU - loadX)
 			- routeU->penalty;
 
-		costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + instance->get_distance(nodeUIndex, nodeXIndex) - serviceV + serviceU + serviceX)
+		costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + metered_distance(nodeUIndex, nodeXIndex) - serviceV + serviceU + serviceX)
 			+ penaltyExcessLoad(routeV->load + loadU + loadX - loadV)
 			- routeV->penalty;
 	}
@@ -269,16 +269,16 @@ bool LocalSearch::move5()
 
 bool LocalSearch::move6()
 {
-	double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeYIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-	double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeXIndex, nodeYNextIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeYIndex, nodeYNextIndex);
+	double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeYIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+	double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeXIndex, nodeYNextIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeYIndex, nodeYNextIndex);
 
 	if (routeU != routeV)
 	{
-		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - instance->get_distance(nodeUIndex, nodeXIndex) + instance->get_distance(nodeVIndex, nodeYIndex) + serviceV + serviceY - serviceU - serviceX)
+		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - metered_distance(nodeUIndex, nodeXIndex) + metered_distance(nodeVIndex, nodeYIndex) + serviceV + serviceY - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load + loadV + loadY - loadU - loadX)
 			- routeU->penalty;
 
-		costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex) - serviceV - serviceY + serviceU + serviceX)
+		costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex) - serviceV - serviceY + serviceU + serviceX)
 			+ penaltyExcessLoad(routeV->load + loadU + loadX - loadV - loadY)
 			- routeV->penalty;
 	}
@@ -299,7 +299,7 @@ bool LocalSearch::move7()
 {
 	if (nodeU->position > nodeV->position) return false;
 
-	double cost = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex) + nodeV->cumulatedReversalDistance - nodeX->cumulatedReversalDistance;
+	double cost = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex) + nodeV->cumulatedReversalDistance - nodeX->cumulatedReversalDistance;
 
 	if (cost > -MY_EPSILON) return false;
 	if (nodeU->next == nodeV) return false;
@@ -329,9 +329,9 @@ bool LocalSearch::move7()
 
 bool LocalSearch::move8()
 {
-	double cost = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex)
-		+ penaltyExcessDuration(nodeU->cumulatedTime + nodeV->cumulatedTime + nodeV->cumulatedReversalDistance + instance->get_distance(nodeUIndex, nodeVIndex))
-		+ penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - instance->get_distance(nodeUIndex, nodeXIndex) + routeU->reversalDistance - nodeX->cumulatedReversalDistance + routeV->duration - nodeV->cumulatedTime - instance->get_distance(nodeVIndex, nodeYIndex) + instance->get_distance(nodeXIndex, nodeYIndex))
+	double cost = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex)
+		+ penaltyExcessDuration(nodeU->cumulatedTime + nodeV->cumulatedTime + nodeV->cumulatedReversalDistance + metered_distance(nodeUIndex, nodeVIndex))
+		+ penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - metered_distance(nodeUIndex, nodeXIndex) + routeU->reversalDistance - nodeX->cumulatedReversalDistance + routeV->duration - nodeV->cumulatedTime - metered_distance(nodeVIndex, nodeYIndex) + metered_distance(nodeXIndex, nodeYIndex))
 		+ penaltyExcessLoad(nodeU->cumulatedLoad + nodeV->cumulatedLoad)
 		+ penaltyExcessLoad(routeU->load + routeV->load - nodeU->cumulatedLoad - nodeV->cumulatedLoad)
 		- routeU->penalty - routeV->penalty
@@ -405,9 +405,9 @@ bool LocalSearch::move8()
 
 bool LocalSearch::move9()
 {
-	double cost = instance->get_distance(nodeUIndex, nodeYIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex)
-		+ penaltyExcessDuration(nodeU->cumulatedTime + routeV->duration - nodeV->cumulatedTime - instance->get_distance(nodeVIndex, nodeYIndex) + instance->get_distance(nodeUIndex, nodeYIndex))
-		+ penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - instance->get_distance(nodeUIndex, nodeXIndex) + nodeV->cumulatedTime + instance->get_distance(nodeVIndex, nodeXIndex))
+	double cost = metered_distance(nodeUIndex, nodeYIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex)
+		+ penaltyExcessDuration(nodeU->cumulatedTime + routeV->duration - nodeV->cumulatedTime - metered_distance(nodeVIndex, nodeYIndex) + metered_distance(nodeUIndex, nodeYIndex))
+		+ penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - metered_distance(nodeUIndex, nodeXIndex) + nodeV->cumulatedTime + metered_distance(nodeVIndex, nodeXIndex))
 		+ penaltyExcessLoad(nodeU->cumulatedLoad + routeV->load - nodeV->cumulatedLoad)
 		+ penaltyExcessLoad(nodeV->cumulatedLoad + routeU->load - nodeU->cumulatedLoad)
 		- routeU->penalty - routeV->penalty;
@@ -508,7 +508,7 @@ bool LocalSearch::swapStar()
 		SwapStarElement mySwapStar;
 		mySwapStar.U = nodeU;
 		mySwapStar.bestPositionU = bestInsertClient[routeV->cour][nodeU->cour].bestLocation[0];
-		double deltaDistRouteU = instance->get_distance(nodeU->prev->cour, nodeU->next->cour) - instance->get_distance(nodeU->prev->cour, nodeU->cour) - instance->get_distance(nodeU->cour, nodeU->next->cour);
+		double deltaDistRouteU = metered_distance(nodeU->prev->cour, nodeU->next->cour) - metered_distance(nodeU->prev->cour, nodeU->cour) - metered_distance(nodeU->cour, nodeU->next->cour);
 		double deltaDistRouteV = bestInsertClient[routeV->cour][nodeU->cour].bestCost[0];
 		mySwapStar.moveCost = deltaDistRouteU + deltaDistRouteV
 			+ penaltyExcessLoad(routeU->load - preprocessor->customers_[nodeU->cour].demand) - routeU->penalty
@@ -527,7 +527,7 @@ bool LocalSearch::swapStar()
 		mySwapStar.V = nodeV;
 		mySwapStar.bestPositionV = bestInsertClient[routeU->cour][nodeV->cour].bestLocation[0];
 		double deltaDistRouteU = bestInsertClient[routeU->cour][nodeV->cour].bestCost[0];
-		double deltaDistRouteV = instance->get_distance(nodeV->prev->cour, nodeV->next->cour) - instance->get_distance(nodeV->prev->cour, nodeV->cour) - instance->get_distance(nodeV->cour, nodeV->next->cour);
+		double deltaDistRouteV = metered_distance(nodeV->prev->cour, nodeV->next->cour) - metered_distance(nodeV->prev->cour, nodeV->cour) - metered_distance(nodeV->cour, nodeV->next->cour);
 		mySwapStar.moveCost = deltaDistRouteU + deltaDistRouteV
 			+ penaltyExcessLoad(routeU->load + preprocessor->customers_[nodeV->cour].demand) - routeU->penalty
 			+ penaltyExcessLoad(routeV->load - preprocessor->customers_[nodeV->cour].demand) - routeV->penalty
@@ -573,7 +573,7 @@ double LocalSearch::getCheapestInsertSimultRemoval(Node * U, Node * V, Node *& b
 	}
 
 	// Compute insertion in the place of V
-	double deltaCost = instance->get_distance(V->prev->cour, U->cour) + instance->get_distance(U->cour, V->next->cour) - instance->get_distance(V->prev->cour, V->next->cour);
+	double deltaCost = metered_distance(V->prev->cour, U->cour) + metered_distance(U->cour, V->next->cour) - metered_distance(V->prev->cour, V->next->cour);
 	if (!found || deltaCost < bestCost)
 	{
 		bestPosition = V->prev;
@@ -588,16 +588,16 @@ void LocalSearch::preprocessInsertions(Route * R1, Route * R2)
 	for (Node * U = R1->depot->next; !U->isDepot; U = U->next)
 	{
 		// Performs the preprocessing
-		U->deltaRemoval = instance->get_distance(U->prev->cour, U->next->cour) - instance->get_distance(U->prev->cour, U->cour) - instance->get_distance(U->cour, U->next->cour);
+		U->deltaRemoval = metered_distance(U->prev->cour, U->next->cour) - metered_distance(U->prev->cour, U->cour) - metered_distance(U->cour, U->next->cour);
 		if (R2->whenLastModified > bestInsertClient[R2->cour][U->cour].whenLastCalculated)
 		{
 			bestInsertClient[R2->cour][U->cour].reset();
 			bestInsertClient[R2->cour][U->cour].whenLastCalculated = nbMoves;
-			bestInsertClient[R2->cour][U->cour].bestCost[0] = instance->get_distance(0, U->cour) + instance->get_distance(U->cour, R2->depot->next->cour) - instance->get_distance(0, R2->depot->next->cour);
+			bestInsertClient[R2->cour][U->cour].bestCost[0] = metered_distance(0, U->cour) + metered_distance(U->cour, R2->depot->next->cour) - metered_distance(0, R2->depot->next->cour);
 			bestInsertClient[R2->cour][U->cour].bestLocation[0] = R2->depot;
 			for (Node * V = R2->depot->next; !V->isDepot; V = V->next)
 			{
-				double deltaCost = instance->get_distance(V->cour, U->cour) + instance->get_distance(U->cour, V->next->cour) - instance->get_distance(V->cour, V->next->cour);
+				double deltaCost = metered_distance(V->cour, U->cour) + metered_distance(U->cour, V->next->cour) - metered_distance(V->cour, V->next->cour);
 				bestInsertClient[R2->cour][U->cour].compareAndAdd(deltaCost, V);
 			}
 		}
@@ -660,8 +660,8 @@ void LocalSearch::updateRouteData(Route * myRoute)
 		myplace++;
 		mynode->position = myplace;
 		myload += preprocessor->customers_[mynode->cour].demand;
-		mytime += instance->get_distance(mynode->prev->cour, mynode->cour) + preprocessor->customers_[mynode->cour].service_duration;
-		myReversalDistance += instance->get_distance(mynode->cour, mynode->prev->cour) - instance->get_distance(mynode->prev->cour, mynode->cour) ;
+		mytime += metered_distance(mynode->prev->cour, mynode->cour) + preprocessor->customers_[mynode->cour].service_duration;
+		myReversalDistance += metered_distance(mynode->cour, mynode->prev->cour) - metered_distance(mynode->prev->cour, mynode->cour) ;
 		mynode->cumulatedLoad = myload;
 		mynode->cumulatedTime = mytime;
 		mynode->cumulatedReversalDistance = myReversalDistance;
@@ -759,10 +759,10 @@ void LocalSearch::exportIndividual(Individual * indiv)
 		}
 	}
 
-	indiv->evaluate_upper_cost();
+	num_lookups += indiv->evaluate_upper_cost();
 }
 
-LocalSearch::LocalSearch(int seed, Case* instance, Preprocessor* preprocessor) : instance(instance), preprocessor(preprocessor)
+LocalSearch::LocalSearch(int seed, const Case* instance, const Preprocessor* preprocessor) : instance(instance), preprocessor(preprocessor)
 {
     random_engine = std::default_random_engine(seed);
 	clients = std::vector < Node >(instance->num_customer_ + 1);
@@ -788,6 +788,7 @@ LocalSearch::LocalSearch(int seed, Case* instance, Preprocessor* preprocessor) :
 		depotsEnd[i].route = &routes[i];
 	}
 	for (int i = 1 ; i <= instance->num_customer_ ; i++) orderNodes.push_back(i);
+	correlatedVertices = preprocessor->correlated_vertices_;
 	for (int r = 0 ; r < preprocessor->route_cap_ ; r++) orderRoutes.push_back(r);
 }
 
@@ -11,9 +11,9 @@ void Split::generalSplit(Individual * indiv, int nbMaxVehicles)
     {
         cliSplit[i].demand = preprocessor->customers_[indiv->chromT[i - 1]].demand;
         cliSplit[i].serviceTime = preprocessor->customers_[indiv->chromT[i - 1]].service_duration;
-        cliSplit[i].d0_x = instance->distances_[0][indiv->chromT[i - 1]];
-        cliSplit[i].dx_0 = instance->distances_[indiv->chromT[i - 1]][0];
-        cliSplit[i].dnext = (i < instance->num_customer_) ? instance->distances_[indiv->chromT[i - 1]][indiv->chromT[i]] : -1.e30;
+        cliSplit[i].d0_x = instance->distance(0, indiv->chromT[i - 1]);
+        cliSplit[i].dx_0 = instance->distance(indiv->chromT[i - 1], 0);
+        cliSplit[i].dnext = (i < instance->num_customer_) ? instance->distance(indiv->chromT[i - 1], indiv->chromT[i]) : -1.e30;
         sumLoad[i] = sumLoad[i - 1] + cliSplit[i].demand;
         sumService[i] = sumService[i - 1] + cliSplit[i].serviceTime;
         sumDistance[i] = sumDistance[i - 1] + cliSplit[i - 1].dnext;
@@ -24,7 +24,7 @@ void Split::generalSplit(Individual * indiv, int nbMaxVehicles)
         splitLF(indiv);
 
     // Build up the rest of the Individual structure
-    indiv->evaluate_upper_cost();
+    num_lookups += indiv->evaluate_upper_cost();
 }
 
 int Split::splitSimple(Individual * indiv)
@@ -224,11 +224,11 @@ vector<vector<int>> Split::prinsSplit(const vector<int> &chromosome) {
         {
             load += instance->get_customer_demand_(x[j]);
             if (i == j) {
-                cost = instance->get_distance(instance->depot_, x[j]) * 2;
+                cost = metered_distance(instance->depot_, x[j]) * 2;
             } else {
-                cost -= instance->get_distance(x[j -1], instance->depot_);
-                cost += instance->get_distance(x[j -1], x[j]);
-                cost += instance->get_distance(instance->depot_, x[j]);
+                cost -= metered_distance(x[j -1], instance->depot_);
+                cost += metered_distance(x[j -1], x[j]);
+                cost += metered_distance(instance->depot_, x[j]);
             }
 
             if (load <= instance->max_vehicle_capa_) {
@@ -263,6 +263,8 @@ void Split::initIndividualWithHienClustering(Individual* ind) {
     std::shuffle(chromosome.begin(),chromosome.end(), random_engine);
     vector<vector<int>> routes;
     vector<int> route;
+    vector<int> extended; // nearby customers beyond the stored rows, see Preprocessor::nearby_customers
+    const int num_nearby = instance->num_customer_ - 1;
     while (!chromosome.empty()) {
         route.clear();
 
@@ -271,11 +273,11 @@ void Split::initIndividualWithHienClustering(Individual* ind) {
         route.push_back(anchor);
         int cap = instance->get_customer_demand_(anchor);
 
-        vector<int> nearby_customers = preprocessor->sorted_nearby_customers_[anchor];
-        int length = static_cast<int>(nearby_customers.size()); // the size of nearby_customers
+        const vector<int>* nearby_customers = &preprocessor->sorted_nearby_customers_[anchor];
 
-        for (int i = 0; i < length; ++i) {
-            int node = nearby_customers[i];
+        for (int i = 0; i < num_nearby; ++i) {
+            if (i == static_cast<int>(nearby_customers->size())) nearby_customers = &preprocessor->nearby_customers(anchor, 2 * i, extended);
+            int node = (*nearby_customers)[i];
             auto it = find(chromosome.begin(),chromosome.end(), node);
             if (it == chromosome.end()) {
                 continue;
@@ -303,10 +305,10 @@ void Split::initIndividualWithHienClustering(Individual* ind) {
     for (int node : lastRoute) {
         cap1 += instance->get_customer_demand_(node);
     }
-    int size = instance->num_customer_ - 1; // the size of nearby_customers
-
-    for (int i = 0; i < size; ++i) {
-        int x = preprocessor->sorted_nearby_customers_[customer][i];
+    const vector<int>* nearby_customers = &preprocessor->sorted_nearby_customers_[customer];
+    for (int i = 0; i < num_nearby; ++i) {
+        if (i == static_cast<int>(nearby_customers->size())) nearby_customers = &preprocessor->nearby_customers(customer, 2 * i, extended);
+        int x = (*nearby_customers)[i];
         if (find(lastRoute.begin(), lastRoute.end(), x) != lastRoute.end()) {
             continue;
         }
@@ -339,7 +341,7 @@ void Split::initIndividualWithHienClustering(Individual* ind) {
         ind->chromR[index++] = tour;
     }
 
-    ind->evaluate_upper_cost();
+    num_lookups += ind->evaluate_upper_cost();
 }
 
 void Split::initIndividualWithDirectEncoding(Individual* ind) {
@@ -395,11 +397,11 @@ void Split::initIndividualWithDirectEncoding(Individual* ind) {
         ind->chromR[index++] = tour;
     }
 
-    ind->evaluate_upper_cost();
+    num_lookups += ind->evaluate_upper_cost();
 }
 
 
-Split::Split(int seed, Case* instance, Preprocessor* preprocessor): instance(instance), preprocessor(preprocessor)
+Split::Split(int seed, const Case* instance, const Preprocessor* preprocessor): instance(instance), preprocessor(preprocessor)
 {
 	// Structures of the linear Split
 	cliSplit = std::vector <ClientSplit>(instance->num_customer_ + 1);
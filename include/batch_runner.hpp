@@ -0,0 +1,96 @@
+#ifndef FROGS_BATCH_RUNNER_HPP
+#define FROGS_BATCH_RUNNER_HPP
+
+#include "case.hpp"
+#include "deadline.hpp"
+#include "preprocessor.hpp"
+#include "trial_scheduler.hpp"
+#include <atomic>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Experiment plan: every instance is run with every combination of the parameter grids and every seed. The plan file
+// has one entry per line, a key followed by its values, and '#' starts a comment:
+//   instances E-n22-k4.evrp E-n23-k3.evrp
+//   seeds 1..5
+//   nb_granular 10 20 30
+//   history_length 1000 5000
+// Grid keys are the command line options without the dash; their values override the options given to ./Run.
+struct BatchPlan {
+    vector<string> instances;
+    vector<int> seeds;                              // "a..b" lines expand to a, a + 1, ..., b
+    vector<pair<string, vector<string>>> grid;      // in plan order
+
+    static BatchPlan parse(istream& in);            // throws invalid_argument, with the line number, on a malformed plan
+    static BatchPlan load(const string& file_path);
+};
+
+// One run of the plan
+struct BatchJob {
+    string instance;
+    int seed{};
+    vector<pair<string, string>> settings;          // the grid values of the job
+    Parameters params;                              // the options of ./Run with the settings applied
+    int case_group{};                               // jobs of a group share one Case
+    int table_group{};                              // jobs of a group share one Preprocessor
+
+    [[nodiscard]] string settings_label() const;    // e.g. "nb_granular=20 history_length=1000"
+    [[nodiscard]] string output_label() const;      // the same as a directory name, e.g. "nb_granular=20,history_length=1000"
+};
+
+struct BatchResult {
+    const BatchJob* job{};
+    TrialReport report;
+};
+
+// Runs the jobs of a plan on a pool of worker threads in one process. Each instance is loaded once per combination of
+// the options that change its distance tables, and preprocessed once per combination of the options that change the
+// preprocessing; jobs that only differ in their seed or in kSearchKeys share both. Jobs are ordered by group, and a
+// Case or Preprocessor is built by the first job that needs it and released after the last one.
+class BatchRunner {
+public:
+    using Job = function<double(const BatchJob& job, const Case* instance, const Preprocessor* preprocessor)>;
+
+    static const vector<string> kSearchKeys;        // options read by the search only: history_length, stp, time_limit, log, trace, route_cache
+
+    BatchRunner(const BatchPlan& plan, const Parameters& base);
+
+    vector<BatchResult> run(const Job& job, int num_workers, bool pin_workers);     // one result per job, in job order
+    static double run_lahc(const BatchJob& job, const Case* instance, const Preprocessor* preprocessor,
+                           const CancellationToken* cancellation = nullptr);
+
+    [[nodiscard]] const vector<BatchJob>& jobs() const { return jobs_; }
+    [[nodiscard]] int num_case_groups() const { return static_cast<int>(cases_.size()); }
+    [[nodiscard]] int num_table_groups() const { return static_cast<int>(tables_.size()); }
+
+    static void print_summary(const vector<BatchResult>& results, ostream& out);            // one line per instance and settings
+    static void save_results(const vector<BatchResult>& results, const string& directory);  // results.csv, one row per job, and summary.csv
+
+private:
+    struct CaseGroup {
+        Parameters params;
+        std::once_flag built;
+        unique_ptr<Case> instance;
+        std::atomic<int> remaining{};               // jobs still to run
+    };
+    struct TableGroup {
+        Parameters params;                          // referenced by the Preprocessor
+        int case_group{};
+        std::once_flag built;
+        unique_ptr<Preprocessor> preprocessor;
+        std::atomic<int> remaining{};
+    };
+
+    vector<BatchJob> jobs_;
+    vector<unique_ptr<CaseGroup>> cases_;
+    vector<unique_ptr<TableGroup>> tables_;
+};
+
+#endif //FROGS_BATCH_RUNNER_HPP
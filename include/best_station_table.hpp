@@ -0,0 +1,89 @@
+#ifndef FROGS_BEST_STATION_TABLE_HPP
+#define FROGS_BEST_STATION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Best charging station of every arc between the depot and the customers (the choice is symmetric), in one of two
+// stores:
+//   dense   one 16-bit code per unordered pair in a flat triangular array: the station id plus one (0 for no
+//           station), or kUnknown. O(n^2) memory, for the dense distance backend.
+//   sparse  O(n) memory, for the matrix-free backend: 32-bit stations for a fixed set of arcs (the correlated arcs and
+//           the arcs of the depot), found by binary search in the row of their smaller end, and a fixed-size
+//           open-addressing hash for the other arcs. An arc that finds no free slot within kMaxProbes is not stored,
+//           and is computed again on its next lookup.
+// Entries start unknown and are filled by their first lookup; they are relaxed atomics, so concurrent fills of the
+// same entry, which store the same value, are harmless.
+class BestStationTable {
+public:
+    static constexpr uint16_t kUnknown = 0xFFFF;    // dense code of an entry not computed yet
+    static constexpr int kUnknownStation = -2;      // station() of an entry not computed yet
+    static constexpr int kMaxNodes = 0xFFFE;        // dense store: node ids must fit in a code
+    static const int kMaxProbes;                    // sparse store: slots of the hash tried per arc
+
+    void resize(int num_nodes, int problem_size);   // dense: num_nodes (num_nodes + 1) / 2 pairs, all unknown; stations are ids < problem_size
+    // sparse: the arcs (0, i) and (i, x) for x in neighbours[i], all unknown, plus a hash of about lazy_capacity arcs
+    void resize_sparse(int num_nodes, const std::vector<std::vector<int>>& neighbours, size_t lazy_capacity);
+    [[nodiscard]] bool sparse() const { return sparse_; }
+
+    [[nodiscard]] int station(int from, int to) const;  // the stored station, kUnknownStation if not computed yet
+    int set(int from, int to, int station) const;   // stores the station of the arc and returns it
+    [[nodiscard]] uint16_t code(int from, int to) const;    // dense store only
+    static int decode(const uint16_t code) { return code - 1; }
+    static uint16_t encode(const int station) { return static_cast<uint16_t>(station + 1); }
+
+    [[nodiscard]] int num_nodes() const { return num_nodes_; }
+    [[nodiscard]] size_t size() const { return size_; }                         // number of entries
+    [[nodiscard]] size_t bytes() const;                                         // memory of the store
+    [[nodiscard]] size_t num_known() const;                                     // number of entries already computed
+    void load(const uint16_t* codes);                                           // dense store: copies size() codes, e.g. from the instance cache
+    void store(uint16_t* codes) const;                                          // dense store: copies the size() codes out
+
+private:
+    static_assert(sizeof(std::atomic<uint16_t>) == sizeof(uint16_t), "codes must be plain 16-bit words");
+
+    int num_nodes_{};
+    size_t size_{};
+    bool sparse_{};
+    std::unique_ptr<std::atomic<uint16_t>[]> codes_;        // dense store
+
+    std::vector<size_t> row_offsets_;                       // sparse store: arcs (lo, hi) of row lo, by increasing hi
+    std::vector<int> row_nodes_;
+    std::unique_ptr<std::atomic<int32_t>[]> row_stations_;
+    std::unique_ptr<std::atomic<uint64_t>[]> lazy_keys_;    // sparse store: key of each slot of the hash, 0 if empty
+    std::unique_ptr<std::atomic<int32_t>[]> lazy_stations_;
+    size_t lazy_mask_{};
+
+    static size_t index(int from, int to);
+    static uint64_t lazy_key(const int lo, const int hi) { return (static_cast<uint64_t>(lo) << 32 | static_cast<uint32_t>(hi)) + 1; }
+    [[nodiscard]] std::atomic<int32_t>* row_entry(int lo, int hi) const;    // nullptr if the arc has no row entry
+    [[nodiscard]] int sparse_station(int from, int to) const;
+    int sparse_set(int from, int to, int station) const;
+};
+
+inline size_t BestStationTable::index(const int from, const int to) {
+    const size_t lo = from < to ? from : to;
+    const size_t hi = from < to ? to : from;
+    return hi * (hi + 1) / 2 + lo;
+}
+
+inline uint16_t BestStationTable::code(const int from, const int to) const {
+    return codes_[index(from, to)].load(std::memory_order_relaxed);
+}
+
+inline int BestStationTable::station(const int from, const int to) const {
+    if (sparse_) return sparse_station(from, to);
+    const uint16_t code = codes_[index(from, to)].load(std::memory_order_relaxed);
+    return code == kUnknown ? kUnknownStation : decode(code);
+}
+
+inline int BestStationTable::set(const int from, const int to, const int station) const {
+    if (sparse_) return sparse_set(from, to, station);
+    codes_[index(from, to)].store(encode(station), std::memory_order_relaxed);
+    return station;
+}
+
+#endif //FROGS_BEST_STATION_TABLE_HPP
@@ -0,0 +1,80 @@
+#ifndef FROGS_BOUNDED_QUEUE_HPP
+#define FROGS_BOUNDED_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// Bounded lock-free multi-producer multi-consumer queue (Vyukov's array queue). Each cell carries a sequence number
+// telling producers and consumers whose turn it is, so a push or a pop is one compare-and-swap on the shared position
+// plus one release store on the cell. try_push fails when the queue is full instead of blocking.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(const size_t capacity) : mask_(capacity - 1), cells_(std::make_unique<Cell[]>(capacity)) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) throw std::invalid_argument("BoundedQueue: capacity must be a power of two");
+        for (size_t i = 0; i < capacity; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Moves value into the queue; false, value untouched, if the queue is full
+    bool try_push(T& value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[position & mask_];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // The oldest value, or nothing if the queue is empty
+    std::optional<T> try_pop() {
+        size_t position = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[position & mask_];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value(std::move(cell.value));
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (difference < 0) {
+                return std::nullopt;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> tail_{0};   // next position to push, on its own cache line
+    alignas(64) std::atomic<size_t> head_{0};   // next position to pop
+};
+
+#endif //FROGS_BOUNDED_QUEUE_HPP
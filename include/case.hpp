@@ -19,27 +19,53 @@
 #include <cfloat>
 #include <cstdio>
 #include <numeric>
+#include "parameters.hpp"
 
 using namespace std;
 
 const string kDataPath = "../data/";
 
+// Storage type of the distance matrix. With -DFLOAT_DISTANCES=ON (FROGS_FLOAT_DISTANCES) the matrix takes half the
+// memory; every lookup is widened to double, so route costs are still accumulated in double precision.
+// Each stored distance then has a relative error of at most 2^-24 (~6e-8), so a route cost computed from the matrix
+// differs from the exact one by less than 6e-8 of its value (about 0.01 on a 130,000-long solution). The objectives
+// written to the stats files are recomputed from the coordinates in double precision and are exact.
+#ifdef FROGS_FLOAT_DISTANCES
+using distance_t = float;
+#else
+using distance_t = double;
+#endif
+
 
 class Case {
 public:
+    Case() = default;                                                                   // empty instance, to be filled by parse_problem
     explicit Case(const string& file_name);
+    Case(const string& file_name, const Parameters& params);                            // takes the distance matrix from the instance cache if enabled, no matrix above params.matrix_free_threshold nodes
+    Case(const Case&) = delete;
+    Case& operator=(const Case&) = delete;
     ~Case();
     void read_problem(const string& file_path);	                                        // reads .evrp file
-    static double **generate_2D_matrix_double(int n, int m);                            // generate a 2D matrix of double
+    void parse_problem(const char* cur, const char* end);                               // tokenizes the content of an .evrp file in a single pass
+    void allocate_distance_matrix(bool pad_rows, bool use_huge_pages);                   // allocates distances_ as one cache-line aligned block
+    void build_distance_matrix();                                                       // computes the distance matrix from the node positions
+    void renumber_nodes();                                                              // reorders customers and stations along a Hilbert curve
+    void build_coordinates();                                                           // copies positions_ into coord_x_ / coord_y_
+    void build_nearest_customers(int k);                                                // fills nearest_customers_, matrix-free backend only
+    void enable_matrix_free(int nb_granular);                                           // switches to the matrix-free backend, after build_coordinates
+    [[nodiscard]] int original_id(int node) const;                                      // id of the node in the .evrp file
     [[nodiscard]] int get_customer_demand_(int customer) const;				            // returns the customer demand
     [[nodiscard]] bool is_charging_station(int node) const;					            // returns true if node is a charging station
     [[nodiscard]] double euclidean_distance(int i, int j) const;                        // calculate the Euclidean distance between two nodes
-    [[nodiscard]] double get_distance(int from, int to);				                // returns the distance
-    [[nodiscard]] double get_evals() const;									            // returns the number of evaluations
+    [[nodiscard]] double distance(int from, int to) const;                              // returns the distance; evaluations are charged by the searches, see EvaluationBudget
+    [[nodiscard]] const distance_t* distance_row(int from) const;                       // returns the distances from the node to all nodes, dense backend only
+    void distances_from(int from, int first, int last, double* out) const;              // writes the distances from the node to the nodes [first, last) into out
+    [[nodiscard]] const int* nearest_customers(int customer) const;                     // the num_nearest_ customers closest to the customer, nearest first
     [[nodiscard]] double calculate_total_dist(const vector<vector<int>>& chromR) const; // return the total distance of the upper solution
-    [[nodiscard]] double compute_total_distance(const vector<vector<int>>& routes);     // return the total distance of the given routes
+    [[nodiscard]] double compute_total_distance(const vector<vector<int>>& routes) const; // return the total distance of the given routes
     [[nodiscard]] double compute_total_distance(const vector<int>& route) const;
     [[nodiscard]] double calculate_total_dist_follower(int** routes, int num_routes, const int* num_nodes_per_route) const;
+    [[nodiscard]] double calculate_exact_dist_follower(int** routes, int num_routes, const int* num_nodes_per_route) const; // same, from the coordinates in double precision
     [[nodiscard]] int calculate_demand_sum(const vector<int>& route) const;             // return the demand sum of the given route.
 
 
@@ -57,11 +83,43 @@ public:
     double max_battery_capa_{};             // maximum energy capacity of the vehicle
     double energy_consumption_rate_{};      // energy consumption rate
     double optimum_{};
-    double** distances_{};                  // distance matrix
-    double evals_{};                        // number of evaluations used
+    distance_t* distances_{};               // distance matrix, row-major, each row holds distance_stride_ entries
+    int distance_stride_{};                 // row length of distances_, problem_size_ rounded up to a whole cache line if padded
+    size_t distance_bytes_{};               // allocated size of distances_
+    bool matrix_free_{};                    // true if distances are computed from the coordinates instead of read from distances_
+    vector<double> coord_x_;                // node coordinates as separate arrays, for the batched kernel of distances_from
+    vector<double> coord_y_;
+    int num_nearest_{};                     // row length of nearest_customers_
+    vector<int> nearest_customers_;         // (num_customer_ + 1) x num_nearest_, ties broken by the smaller id
+    int num_threads_{};                     // threads of the construction phases, 0 for all hardware threads
+    vector<pair<string, double>> startup_phases_;   // wall time in seconds of each construction phase
     vector<int> demand_;                    // size = num_customer_ + 1
     vector<pair<double, double>> positions_;// coordinates of the nodes
+    vector<int> original_ids_;              // file id of each node after renumber_nodes, empty if the file order is kept
 };
 
+// The accessors below are on the hot path of every move evaluation, hence defined inline
+inline double Case::distance(const int from, const int to) const {
+    if (matrix_free_) {
+        // Rounded through distance_t, so both backends return the same values
+        const double dx = coord_x_[from] - coord_x_[to];
+        const double dy = coord_y_[from] - coord_y_[to];
+        return static_cast<distance_t>(std::sqrt(dx * dx + dy * dy));
+    }
+    return distances_[static_cast<size_t>(from) * distance_stride_ + to];
+}
+
+inline const distance_t* Case::distance_row(const int from) const {
+    return distances_ + static_cast<size_t>(from) * distance_stride_;
+}
+
+inline int Case::original_id(const int node) const {
+    return original_ids_.empty() ? node : original_ids_[node];
+}
+
+inline const int* Case::nearest_customers(const int customer) const {
+    return nearest_customers_.data() + static_cast<size_t>(customer) * num_nearest_;
+}
+
 
 #endif //FROGS_CASE_HPP
@@ -0,0 +1,135 @@
+#ifndef FROGS_CHECKPOINT_HPP
+#define FROGS_CHECKPOINT_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+const string kCheckpointPath = "../checkpoints/";
+
+// Little binary encoder of a checkpoint: trivially copyable values, vectors of them and strings, in native layout
+class CheckpointEncoder {
+public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are encoded");
+        const auto* data = reinterpret_cast<const char*>(&value);
+        bytes_.insert(bytes_.end(), data, data + sizeof(T));
+    }
+    template <typename T>
+    void put_array(const T* values, const size_t size) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are encoded");
+        put<uint64_t>(size);
+        const auto* data = reinterpret_cast<const char*>(values);
+        bytes_.insert(bytes_.end(), data, data + sizeof(T) * size);
+    }
+    template <typename T>
+    void put_vector(const vector<T>& values) { put_array(values.data(), values.size()); }
+    void put_string(const string& value) { put_array(value.data(), value.size()); }
+
+    [[nodiscard]] const vector<char>& bytes() const { return bytes_; }
+    vector<char> release() { return std::move(bytes_); }
+
+private:
+    vector<char> bytes_;
+};
+
+// Reads back what a CheckpointEncoder wrote; throws runtime_error past the end of the data
+class CheckpointDecoder {
+public:
+    CheckpointDecoder(const char* data, const size_t size) : position_(data), end_(data + size) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        read(&value, sizeof(T));
+        return value;
+    }
+    template <typename T>
+    void get_array(T* values, const size_t size) {
+        if (get<uint64_t>() != size) throw runtime_error("checkpoint: unexpected array size");
+        read(values, sizeof(T) * size);
+    }
+    template <typename T>
+    vector<T> get_vector() {
+        vector<T> values(checked_size(sizeof(T)));
+        read(values.data(), sizeof(T) * values.size());
+        return values;
+    }
+    string get_string() {
+        string value(checked_size(1), '\0');
+        read(value.data(), value.size());
+        return value;
+    }
+    [[nodiscard]] bool at_end() const { return position_ == end_; }
+
+private:
+    const char* position_;
+    const char* end_;
+
+    size_t checked_size(const size_t element_size) {
+        const auto size = get<uint64_t>();
+        if (size > static_cast<uint64_t>(end_ - position_) / element_size) throw runtime_error("checkpoint: truncated");
+        return size;
+    }
+    void read(void* out, const size_t size) {
+        if (size > static_cast<size_t>(end_ - position_)) throw runtime_error("checkpoint: truncated");
+        std::memcpy(out, position_, size);
+        position_ += size;
+    }
+};
+
+// Checkpoint files: a header (magic, version, fingerprint of what the state belongs to, payload size, FNV-1a checksum
+// of the payload) followed by the payload. Files are written to a temporary name and renamed, so a crash while writing
+// leaves the previous checkpoint intact.
+class CheckpointFile {
+public:
+    static const uint32_t kVersion;
+
+    static bool write(const string& path, uint64_t fingerprint, const vector<char>& payload);  // false on I/O errors
+    static bool read(const string& path, uint64_t fingerprint, vector<char>& payload);         // false if missing, stale or corrupted
+};
+
+// Writes checkpoints on a background thread, so that the search only pays for encoding its state. Only the latest
+// submitted checkpoint matters: one submitted while the previous is still being written replaces the pending one.
+// The destructor writes the pending checkpoint, if any, before returning. A checkpoint can come with a barrier, run on
+// the writer thread before the file is put in place, that waits for the output the checkpoint refers to, such as the
+// rows of an asynchronous log; it must return once that output is closed.
+class AsyncCheckpointWriter {
+public:
+    AsyncCheckpointWriter();
+    ~AsyncCheckpointWriter();
+    AsyncCheckpointWriter(const AsyncCheckpointWriter&) = delete;
+    AsyncCheckpointWriter& operator=(const AsyncCheckpointWriter&) = delete;
+
+    void submit(const string& path, uint64_t fingerprint, vector<char> payload, std::function<void()> barrier = nullptr);
+    void flush();                               // waits until every submitted checkpoint is on disk
+    [[nodiscard]] long num_written() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool pending_{false};
+    bool writing_{false};
+    bool stopping_{false};
+    string path_;
+    uint64_t fingerprint_{};
+    vector<char> payload_;
+    std::function<void()> barrier_;
+    long written_{0};
+    std::thread thread_;
+
+    void loop();
+};
+
+#endif //FROGS_CHECKPOINT_HPP
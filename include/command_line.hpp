@@ -19,6 +19,8 @@ private:
 public:
     // Constructor: Parses command-line arguments
     CommandLine(int argc, char* argv[]);
+    // Constructor: Takes already split key-value pairs, e.g. the settings of a batch job
+    explicit CommandLine(std::unordered_map<std::string, std::string> arguments);
 
     // Override default parameters based on command-line arguments
     void parse_parameters(Parameters& params) const;
@@ -33,6 +35,7 @@ public:
     [[nodiscard]] bool get_bool(const std::string& key, bool default_value) const;
     [[nodiscard]] static std::string to_lowercase(const std::string& str) ;
     [[nodiscard]] static Algorithm string_to_algorithm(const std::string& algo_str);
+    [[nodiscard]] static Topology string_to_topology(const std::string& topology_str);
 
     // Debug: Print all parsed arguments
     void print_arguments() const;
@@ -0,0 +1,47 @@
+#ifndef FROGS_DEADLINE_HPP
+#define FROGS_DEADLINE_HPP
+
+#include <atomic>
+#include <limits>
+
+// Cooperative cancellation flag: set by another thread or a signal handler, polled by the searches, which then stop
+// at their next check and keep their best solution
+class CancellationToken {
+public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+    [[nodiscard]] bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    static_assert(std::atomic<bool>::is_always_lock_free, "the token is set from signal handlers");
+    std::atomic<bool> cancelled_{false};
+};
+
+// Cancels token on SIGINT and SIGTERM, e.g. to stop a run cleanly when a job scheduler reclaims its slot.
+// The token must outlive the handlers; nullptr restores the default handlers.
+void cancel_on_signals(CancellationToken* token);
+
+// Monotonic time in seconds, read from CLOCK_MONOTONIC_COARSE on Linux (a few milliseconds of resolution, but no more
+// than a memory read) and from steady_clock elsewhere
+double coarse_seconds();
+
+// A point in time after which a run stops, or a cancellation token, whichever comes first. The default Deadline never
+// expires. expired() is cheap enough to be called every few iterations of a search loop.
+class Deadline {
+public:
+    Deadline() = default;
+    Deadline(double seconds, const CancellationToken* token);  // seconds from now, infinity for no time limit
+
+    [[nodiscard]] bool expired() const {
+        if (token_ != nullptr && token_->cancelled()) return true;
+        return end_ != std::numeric_limits<double>::infinity() && coarse_seconds() >= end_;
+    }
+    [[nodiscard]] double remaining() const;                     // seconds left, infinity for no time limit
+    [[nodiscard]] bool cancelled() const { return token_ != nullptr && token_->cancelled(); }
+
+private:
+    double end_{std::numeric_limits<double>::infinity()};
+    const CancellationToken* token_{};
+};
+
+#endif //FROGS_DEADLINE_HPP
@@ -0,0 +1,40 @@
+#ifndef FROGS_DIRTY_ROUTES_HPP
+#define FROGS_DIRTY_ROUTES_HPP
+
+#include <vector>
+
+using namespace std;
+
+// Ids of the routes a search level changed since its consumer last caught up, e.g. the routes touched by the moves of
+// the leader, which are the only ones the follower needs to repair again. all() means that everything may have changed
+// (a new solution was loaded), and is set until the first clear().
+class DirtyRoutes {
+public:
+    void resize(const int route_cap) {
+        marked_.assign(route_cap, 0);
+        ids_.clear();
+        ids_.reserve(route_cap);
+        all_ = true;
+    }
+    void mark(const int route) {
+        if (marked_[route]) return;
+        marked_[route] = 1;
+        ids_.push_back(route);
+    }
+    void mark_all() { all_ = true; }
+    void clear() {
+        for (const int route : ids_) marked_[route] = 0;
+        ids_.clear();
+        all_ = false;
+    }
+
+    [[nodiscard]] bool all() const { return all_; }
+    [[nodiscard]] const vector<int>& ids() const { return ids_; }       // in marking order, without duplicates
+
+private:
+    vector<char> marked_;
+    vector<int> ids_;
+    bool all_{true};
+};
+
+#endif //FROGS_DIRTY_ROUTES_HPP
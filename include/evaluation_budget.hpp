@@ -0,0 +1,60 @@
+#ifndef FROGS_EVALUATION_BUDGET_HPP
+#define FROGS_EVALUATION_BUDGET_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// Distance lookups charged by one search thread. Only its owner charges it, in batches (a move, a follower call),
+// other threads can read it at any time.
+class EvaluationCounter {
+public:
+    void charge(const uint64_t lookups) {
+        lookups_.store(lookups_.load(std::memory_order_relaxed) + lookups, std::memory_order_relaxed);
+    }
+    [[nodiscard]] uint64_t lookups() const { return lookups_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<uint64_t> lookups_{0};   // own cache line, so that the threads do not share one
+};
+
+// Budget of fitness evaluations of a search, counted exactly in distance lookups: a lookup is a partial evaluation
+// worth 1 / lookups_per_evaluation of a full one, so that max_evals evaluations are max_evals * lookups_per_evaluation
+// lookups. Each search thread charges its own counter and the budget sums them.
+class EvaluationBudget {
+public:
+    EvaluationBudget(int lookups_per_evaluation, double max_evals);
+    EvaluationBudget(const EvaluationBudget&) = delete;
+    EvaluationBudget& operator=(const EvaluationBudget&) = delete;
+
+    EvaluationCounter& add_counter();                       // a new counter for one search thread, valid as long as the budget
+    [[nodiscard]] uint64_t lookups() const;                 // lookups charged to all counters
+    [[nodiscard]] double evaluations() const;               // the same, in evaluations
+    [[nodiscard]] bool exhausted() const;                   // true once max_evals evaluations are used
+    [[nodiscard]] uint64_t max_lookups() const { return max_lookups_; }
+
+private:
+    uint64_t lookups_per_evaluation_;
+    uint64_t max_lookups_;
+    mutable std::mutex mutex_;
+    std::deque<EvaluationCounter> counters_;                // deque: counters never move once handed out
+};
+
+// Lookups charged for a repair that now takes fewer of them than the version the budget was set for, as many as that
+// version took, so that max_evals and the search stay the same.
+struct RepairCostModel {
+    // One round of the remove enumeration (Follower::insert_station_by_remove_enum), with num_stations stations left
+    // on a route of num_arcs arcs, the first on arc first_arc and the last on arc last_arc, num_removable of them
+    // removable. The round summed the stretch around every station arc by arc, from the station before it (or the
+    // depot) to the station after it (or the depot): num_arcs + last_arc - first_arc + 1 - num_stations arcs, since
+    // the stretches overlap between every two stations; one lookup for each end at a station, 2 * (num_stations - 1)
+    // in all; and three lookups for the saving of each removable station.
+    static uint64_t remove_enum_round(const int num_arcs, const int first_arc, const int last_arc, const int num_stations,
+                                      const int num_removable) {
+        return static_cast<uint64_t>(num_arcs + last_arc - first_arc + 1 - num_stations) +
+               2 * static_cast<uint64_t>(num_stations - 1) + 3 * static_cast<uint64_t>(num_removable);
+    }
+};
+
+#endif //FROGS_EVALUATION_BUDGET_HPP
@@ -0,0 +1,67 @@
+#ifndef FROGS_EVOLUTION_LOG_HPP
+#define FROGS_EVOLUTION_LOG_HPP
+
+#include "bounded_queue.hpp"
+#include "stats_interface.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// One row of the evolution log: the iteration, the global best and the indicators of the history list
+struct EvolutionRow {
+    long iter{};
+    double global_best{};
+    Indicators history;
+};
+
+// CSV evolution log written by a background thread. The search thread only moves rows into a fixed-size ring buffer,
+// which never blocks and never allocates; the writer formats and appends them to the file, and flushes it every
+// flush_interval seconds or as soon as the buffer is half full, so memory stays bounded and a crash leaves the log as
+// of the last flush. A row appended while the buffer is full is dropped and counted. A log opened with resume_rows,
+// the num_appended() of a checkpoint, is cut back to its header and that many rows and continued, so that a resumed
+// run extends it.
+class EvolutionLog {
+public:
+    static const size_t kCapacity;              // default number of rows in the ring buffer
+    static const double kFlushInterval;         // default seconds between two flushes
+
+    EvolutionLog(const string& path, const string& header, size_t capacity = kCapacity, double flush_interval = kFlushInterval,
+                 long resume_rows = -1);        // -1 starts a new file with the header
+    ~EvolutionLog();                            // same as close()
+    EvolutionLog(const EvolutionLog&) = delete;
+    EvolutionLog& operator=(const EvolutionLog&) = delete;
+
+    bool append(EvolutionRow row);              // false if the buffer was full and the row was dropped
+    void close();                               // writes the buffered rows, stops the writer and closes the file
+    void wait_written(long rows);               // waits until the file holds rows rows, from any thread but the appender
+
+    [[nodiscard]] bool is_open() const { return file_.is_open(); }
+    [[nodiscard]] long num_appended() const { return appended_.load(std::memory_order_relaxed); }  // rows of the file once written
+    [[nodiscard]] long num_written() const { return written_.load(std::memory_order_relaxed); }
+    [[nodiscard]] long num_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    BoundedQueue<EvolutionRow> rows_;
+    const double flush_interval_;
+    ofstream file_;
+    std::atomic<long> appended_{0};
+    std::atomic<long> written_{0};
+    std::atomic<long> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> wake_requested_{false};
+    std::mutex mutex_;                          // guards the writer's sleep and wait_written()
+    std::condition_variable wake_;
+    std::condition_variable synced_;
+    bool stopped_{false};                       // the writer is done, guarded by mutex_
+    std::thread thread_;
+
+    void loop();
+    void drain();                               // writes every buffered row and flushes the file
+};
+
+#endif //FROGS_EVOLUTION_LOG_HPP
@@ -8,8 +8,8 @@
 #include "case.hpp"
 #include "preprocessor.hpp"
 #include "individual.hpp"
-#include <list>
-#include <stack>
+#include "route_cache.hpp"
+#include "dirty_routes.hpp"
 
 #define INFEASIBLE 1'000'000'000L
 
@@ -18,6 +18,36 @@ struct State {
     int m_len{}, n_len{}, i{}, stationIdx{}; // Current state variables
 };
 
+// A partial charging plan in the dynamic program of "insert_station_by_dp": the plan up to a route node
+struct ChargingLabel {
+    double cost{};      // distance travelled from the depot
+    double remaining{}; // distance the battery still allows
+    int parent{};       // label at the previous route node, -1 at the depot
+    int station{};      // station visited on the arc from the previous node, -1 for none
+};
+
+// A station of "insert_station_by_remove_enum", inserted on the arc (route[pos], route[pos + 1])
+struct InsertedStation {
+    int pos{};
+    int station{};
+    double head{};      // distance from route[pos] to the station
+    double tail{};      // distance from the station to route[pos + 1]
+    double saving{};    // distance saved by removing the station
+    int prev{};         // previous station left on the route, -1 for none
+    int next{};         // next station left on the route, the number of arcs for none
+    bool removable{};   // the battery covers the stretch between prev and next
+    bool queued{};      // in the heap of removable stations
+
+    // A removable station in the heap, the largest saving on top, then the first on the route
+    struct Candidate {
+        double saving{};
+        int station{};
+        bool operator<(const Candidate& other) const {
+            return saving != other.saving ? saving < other.saving : station > other.station;
+        }
+    };
+};
+
 // This struct is used to store the charging station information for the given route
 struct ChargingMeta {
     double cost{}; // cost after applying recharging decision
@@ -26,11 +56,35 @@ struct ChargingMeta {
     vector<int> chosen_sta; // chosen station
 };
 
+// Working memory of the insert_station_by_* functions, reserved from node_cap when the Follower is built and reused
+// for every route, so that repairing a route does not allocate once the buffers are warm. One per Follower, and a
+// Follower belongs to a single search thread.
+struct FollowerScratch {
+    vector<int> route;                          // the route as it was before the stations are inserted
+    vector<double> accumulated_distance;        // accumulated_distance[i]: distance from the depot to route[i]
+    vector<int> arc_station;                    // best station of each arc
+    vector<int> chosen_pos;
+    vector<int> best_chosen_pos;
+    vector<int> chosen_sta;
+    vector<InsertedStation> inserted;           // stations of "insert_station_by_remove_enum", by position
+    vector<InsertedStation::Candidate> candidates_by_saving;
+    vector<State> states;                       // stack of "try_enumerate_n_stations_to_route"
+    ChargingMeta best;                          // best plan of "try_enumerate_n_stations_to_route"
+    vector<ChargingLabel> labels;               // labels of "insert_station_by_dp", grown on demand
+    vector<ChargingLabel> candidates;
+    vector<int> front;
+    vector<int> stations;
+
+    void reserve(int node_cap);
+};
+
 class Follower {
 public:
 
-    Case* instance;
-    Preprocessor* preprocessor;
+    const Case* instance;
+    const Preprocessor* preprocessor;
+    mutable uint64_t num_lookups{};        // distance lookups since the search last charged its EvaluationBudget
+    double metered_distance(int from, int to) const { ++num_lookups; return instance->distance(from, to); }
 
     /* Auxiliary data structures to run the follower (i.e., lower optimisation) algorithm */
     int route_cap;
@@ -39,20 +93,31 @@ public:
     int** lower_routes;
     int*  lower_num_nodes_per_route;
     double lower_cost;
+    vector<double> route_costs;            // lower cost of each route, summed into lower_cost
+    vector<uint64_t> route_lookups;        // distance lookups the repair of each route took
+    const Individual* synced{};            // individual the routes were last repaired from by run(), nullptr if none
+    RouteCache route_cache;                // repairs of the routes met before, used by run()
+    vector<int> route_key;                 // scratch: the route being repaired, before its stations are inserted
+    mutable FollowerScratch scratch;       // buffers of the insert_station_by_* functions
 
     double insert_station_by_simple_enum(int* repaired_route, int& repaired_length);
     double insert_station_by_remove_enum(int* repaired_route, int& repaired_length) const;
-    void recursive_charging_placement(int m_len, int n_len, int* chosen_pos, int* best_chosen_pos, double& final_cost, int cur_upper_bound, int* route, int length, vector<double>& accumulated_distance);
+    void recursive_charging_placement(int m_len, int n_len, int* chosen_pos, int* best_chosen_pos, double& final_cost, int cur_upper_bound, int* route, int length, vector<double>& accumulated_distance, const vector<int>& arc_station);
     double insert_station_by_all_enumeration(int* repaired_route, int& repaired_length) const;
-    ChargingMeta try_enumerate_n_stations_to_route(int m_len, int n_len, int* chosen_sta, int* chosen_pos, double& cost,
-                                                   int cur_upper_bound, int* route, int length, vector<double>& accumulated_distance) const;
+    double insert_station_by_dp(int* repaired_route, int& repaired_length) const;
+    void try_enumerate_n_stations_to_route(int m_len, int n_len, int* chosen_sta, int* chosen_pos, double& cost,
+                                           int cur_upper_bound, int* route, int length, vector<double>& accumulated_distance,
+                                           ChargingMeta& best) const;
 
 
     void refine(Individual* ind);
+    void optimise(Individual* ind);        // optimal charging plan of every route, by insert_station_by_dp
     void run(Individual* ind);
+    void run(Individual* ind, const DirtyRoutes& dirty);   // repairs only the dirty routes if ind is the individual of the last run
+    double repair_route(int i);            // inserts the stations of route i, returns its lower cost (INFEASIBLE if it can not)
     void load_individual(const Individual* ind);
     void export_individual(Individual* ind) const;
-    Follower(Case* instance, Preprocessor* preprocessor);
+    Follower(const Case* instance, const Preprocessor* preprocessor);
     ~Follower();
 
     friend ostream& operator<<(ostream& os, const Follower& follower);
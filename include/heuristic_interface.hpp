@@ -7,6 +7,8 @@
 
 #include "case.hpp"
 #include "preprocessor.hpp"
+#include "evaluation_budget.hpp"
+#include "deadline.hpp"
 #include <iostream>
 #include <random>
 #include <chrono>
@@ -14,23 +16,36 @@
 
 using namespace std;
 
+// One run of a search. The Case and the Preprocessor are read-only and shared by all the runs of a process, possibly
+// on several threads; the state a run changes (random engine, evaluation budget, convergence counters) lives here and
+// in the search components it owns.
 class HeuristicInterface {
 public:
     string name;
     int seed;
-    Case* instance;
-    Preprocessor* preprocessor;
+    const Case* instance;
+    const Preprocessor* preprocessor;
     std::default_random_engine random_engine;
     uniform_real_distribution<double> uniform_real_dist;
+    EvaluationBudget evaluation_budget;     // max_evals_ evaluations, a full evaluation being problem_size_ distance lookups
+    EvaluationCounter& evaluations;         // counter charged by the thread running this heuristic
+    double max_exec_time;                   // time budget of the max-time criterion in seconds, max_exec_time_ by default
+    const CancellationToken* cancellation{};// stops the run at its next deadline check once cancelled
+    Deadline deadline;                      // max_exec_time after the start with the max-time criterion, the token only otherwise
+    mutable int no_improvement_count{};     // consecutive iterations without change of the best objective, see stop_criteria_obj_convergence
+    mutable double prev_best_obj{std::numeric_limits<double>::max()};  // best objective of the previous iteration
 
     // Constructor to initialize member variables
-    HeuristicInterface(string heuristic_name, int seed_value, Case* instance, Preprocessor* preprocessor)
+    HeuristicInterface(string heuristic_name, int seed_value, const Case* instance, const Preprocessor* preprocessor)
             : name(std::move(heuristic_name)),
               seed(seed_value),
               instance(instance),
               preprocessor(preprocessor),
               random_engine(seed_value),
-              uniform_real_dist(0.0, 1.0) {
+              uniform_real_dist(0.0, 1.0),
+              evaluation_budget(instance->problem_size_, preprocessor->max_evals_),
+              evaluations(evaluation_budget.add_counter()),
+              max_exec_time(preprocessor->max_exec_time_) {
 
     }
 
@@ -38,17 +53,14 @@ public:
     virtual void initialize_heuristic() = 0;
     virtual void run_heuristic() = 0;
     [[nodiscard]] virtual bool stop_criteria_max_evals() const {
-        return instance->get_evals() >= preprocessor->max_evals_;
+        return evaluation_budget.exhausted();
     }
 
     [[nodiscard]] virtual bool stop_criteria_max_exec_time(const std::chrono::duration<double>& duration) const {
-        return duration.count() >= preprocessor->max_exec_time_;
+        return duration.count() >= max_exec_time;
     }
 
     [[nodiscard]] virtual bool stop_criteria_obj_convergence(const double current_best_obj) const {
-        static int no_improvement_count = 0; // consecutive no-change count
-        static double prev_best_obj = std::numeric_limits<double>::max(); // previous best objective, initialized to infinity
-
         // If change is small, increment count; otherwise, reset
         if (double obj_change = std::abs(current_best_obj - prev_best_obj); obj_change < MY_EPSILON) {
             no_improvement_count++;
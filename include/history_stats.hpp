@@ -0,0 +1,50 @@
+#ifndef FROGS_HISTORY_STATS_HPP
+#define FROGS_HISTORY_STATS_HPP
+
+#include "stats_interface.hpp"
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Min, max, mean and standard deviation of a fixed-size list of values whose slots are overwritten one at a time, such
+// as the LAHC history list. The mean and the sum of squared deviations follow each replacement with a Welford-style
+// update, and the min and max are kept in a tournament tree over the slots, so a replacement costs O(log size) and the
+// indicators are read in O(1). The moments are recomputed exactly every kResyncInterval replacements, which bounds the
+// rounding drift of long runs.
+class HistoryStats {
+public:
+    static const size_t kResyncInterval;
+
+    void assign(size_t size, double value);         // size slots, all equal to value
+    void assign(const vector<double>& values);
+    void replace(size_t slot, double value);
+    // Continues the running moments of a saved list after assign(values), so that its indicators round the same
+    void restore_moments(double mean, double m2, size_t num_replaced);
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] double value(size_t slot) const { return tree_[leaves_ + slot].min; }
+    [[nodiscard]] double min() const { return tree_[1].min; }
+    [[nodiscard]] double max() const { return tree_[1].max; }
+    [[nodiscard]] double mean() const { return mean_; }
+    [[nodiscard]] double m2() const { return m2_; }
+    [[nodiscard]] size_t num_replaced() const { return num_replaced_; }
+    [[nodiscard]] double variance() const;          // sample variance, 0 for fewer than two values
+    [[nodiscard]] Indicators indicators() const;    // same fields as StatsInterface::calculate_statistical_indicators
+
+private:
+    struct Range {
+        double min, max;
+    };
+
+    size_t size_{};
+    size_t leaves_{};                               // power of two >= size_; the leaf of slot i is tree_[leaves_ + i]
+    vector<Range> tree_;                            // tree_[1] is the root, padding leaves are neutral
+    double mean_{};
+    double m2_{};                                   // sum of the squared deviations from mean_
+    size_t num_replaced_{};                         // replacements since the last exact computation
+
+    void resync();                                  // recomputes mean_ and m2_ from the leaves
+};
+
+#endif //FROGS_HISTORY_STATS_HPP
@@ -31,8 +31,8 @@ struct UpperCost {
 
 class Individual {
 public:
-    Case* instance{};
-    Preprocessor* preprocessor{};
+    const Case* instance{};
+    const Preprocessor* preprocessor{};
 
     // chromosome information, for evolution
     vector<int> chromT;             // Giant tour representing the individual
@@ -49,11 +49,11 @@ public:
 
     Individual();                                                                   // Constructor: empty individual
     Individual(const Individual& ind);                                              // Copy constructor
-    Individual(Case* instance, Preprocessor* preprocessor);                         // Constructor: random individual
-    Individual(Case* instance, Preprocessor* preprocessor, const vector<int>& chromT);     // Constructor: random individual, the next step is to use `Split` to generate the ChromR
-    Individual(Case* instance, Preprocessor* preprocessor, const vector<int>& chromT, const vector<vector<int>>& chromR, double upper_cost);  // Constructor: some delicate methods for initialisation
+    Individual(const Case* instance, const Preprocessor* preprocessor);                         // Constructor: random individual
+    Individual(const Case* instance, const Preprocessor* preprocessor, const vector<int>& chromT);     // Constructor: random individual, the next step is to use `Split` to generate the ChromR
+    Individual(const Case* instance, const Preprocessor* preprocessor, const vector<int>& chromT, const vector<vector<int>>& chromR, double upper_cost);  // Constructor: some delicate methods for initialisation
 
-    void evaluate_upper_cost();                                                     // Measuring cost of a solution from the information of chromR
+    int evaluate_upper_cost();                                                      // Measuring cost of a solution from the information of chromR, returns the number of distance lookups
     double broken_pairs_distance(const Individual* ind) const;                      // Distance measure with another individual
     double average_broken_pairs_distance_closest(int nb_closest) const;             // Returns the average distance of this individual with the nbClosest individuals
 
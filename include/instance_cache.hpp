@@ -0,0 +1,64 @@
+#ifndef FROGS_INSTANCE_CACHE_HPP
+#define FROGS_INSTANCE_CACHE_HPP
+
+#include "case.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Preprocessor;
+
+const string kCachePath = "../cache/";
+
+// Layout of the cache file: this header, followed by 64-byte aligned sections located by the offsets below.
+// Tables with one row per customer (sorted_nearby_customers_, correlated_vertices_) are stored as offsets + values.
+struct InstanceCacheHeader {
+    char magic[8];                      // "FROGSIC"
+    uint32_t version;                   // InstanceCache::kVersion at the time the file was written
+    uint32_t header_size;               // sizeof(InstanceCacheHeader), guards against layout changes
+    uint64_t fingerprint;               // InstanceCache::fingerprint of the instance and the preprocessing parameters
+    int32_t problem_size;
+    int32_t num_customer;
+    int32_t num_station;
+    int32_t nb_granular;
+    uint32_t distance_size;             // sizeof(distance_t) of the build that wrote the file
+    uint32_t reserved;
+    double max_distance;                // Preprocessor::max_distance_
+    uint64_t distances_offset;          // problem_size x problem_size distance_t
+    uint64_t nearby_offsets_offset;     // num_customer + 2 uint64 row offsets
+    uint64_t nearby_values_offset;      // int32 customer ids
+    uint64_t correlated_offsets_offset; // num_customer + 2 uint64 row offsets
+    uint64_t correlated_values_offset;  // int32 customer ids
+    uint64_t best_station_offset;       // BestStationTable codes, (num_customer + 1) * (num_customer + 2) / 2 uint16
+    uint64_t file_size;
+};
+
+// Binary cache of the O(n^2) tables built by Case and Preprocessor, keyed by a hash of the instance and nb_granular.
+// A valid file is memory-mapped and its tables are read in place.
+class InstanceCache {
+public:
+    static const uint32_t kVersion;
+
+    [[nodiscard]] static uint64_t fingerprint(const Case& c, int nb_granular);     // hash of the instance data, nb_granular and kVersion
+    [[nodiscard]] static string file_path(const Case& c, int nb_granular);         // cache file of the instance
+    static bool save(const Case& c, const Preprocessor& preprocessor);              // writes the cache file, returns false on I/O errors
+
+    bool open(const Case& c, int nb_granular);                                       // maps the cache file, returns false if it is missing, stale or corrupted
+    [[nodiscard]] bool is_open() const { return header_ != nullptr; }
+    [[nodiscard]] const InstanceCacheHeader& header() const { return *header_; }
+    [[nodiscard]] const distance_t* distances() const;                              // row-major distance matrix
+    [[nodiscard]] vector<vector<int>> sorted_nearby_customers() const;
+    [[nodiscard]] vector<vector<int>> correlated_vertices() const;
+    [[nodiscard]] const uint16_t* best_station() const;                              // BestStationTable codes
+
+private:
+    MappedFile file_;
+    const InstanceCacheHeader* header_{};
+
+    [[nodiscard]] vector<vector<int>> read_rows(uint64_t offsets_offset, uint64_t values_offset) const;
+};
+
+#endif //FROGS_INSTANCE_CACHE_HPP
@@ -0,0 +1,42 @@
+#ifndef FROGS_ISLAND_MODEL_HPP
+#define FROGS_ISLAND_MODEL_HPP
+
+#include "bounded_queue.hpp"
+#include "individual.hpp"
+#include "parameters.hpp"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Migration between the islands of a parallel search, one island per thread. Every island has a bounded lock-free
+// inbox; an island sends copies of its elite solutions to its neighbours (the next island on a ring, or a random other
+// island) and takes in what the others sent it. A migrant sent to a full inbox is dropped rather than waited for.
+class IslandModel {
+public:
+    static const int kInboxCapacity;    // migrants waiting per island, a power of two
+
+    IslandModel(int num_islands, Topology topology, int migration_interval);
+
+    [[nodiscard]] int num_islands() const { return static_cast<int>(inboxes_.size()); }
+    [[nodiscard]] Topology topology() const { return topology_; }
+    [[nodiscard]] int migration_interval() const { return migration_interval_; }   // iterations between two migrations of an island
+
+    int neighbour(int island, std::default_random_engine& engine) const;           // island receiving the next emigrant of island
+    bool emigrate(int island, const Individual& migrant, std::default_random_engine& engine); // false if the migrant was dropped
+    unique_ptr<Individual> immigrate(int island);                                   // oldest migrant waiting for island, nullptr if none
+
+    [[nodiscard]] long num_sent() const { return sent_.load(std::memory_order_relaxed); }
+    [[nodiscard]] long num_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    Topology topology_;
+    int migration_interval_;
+    vector<unique_ptr<BoundedQueue<unique_ptr<Individual>>>> inboxes_;
+    std::atomic<long> sent_{0};
+    std::atomic<long> dropped_{0};
+};
+
+#endif //FROGS_ISLAND_MODEL_HPP
@@ -13,14 +13,22 @@
 #include "individual.hpp"
 #include "heuristic_interface.hpp"
 #include "stats_interface.hpp"
+#include "history_stats.hpp"
+#include "shared_best.hpp"
+#include "island_model.hpp"
+#include "checkpoint.hpp"
+#include "trace.hpp"
 
 using namespace std;
 
 class Lahc final : public HeuristicInterface, public StatsInterface {
 public:
     static const std::string ALGORITHM;
+    static const double kSharedRestartRate;     // restart rate of the cooperative mode
+    static const int kDeadlineCheckInterval;    // iterations between two deadline checks in run_heuristic
 
     bool enable_logging;
+    long trace_interval;                        // iterations between two trace rows, 0 for no trace
     int stop_criteria;
 
     long iter;                                  // Iteration counter I
@@ -28,6 +36,7 @@ public:
     long history_length;                        // LAHC history length Lh
     vector<double> history_list;                // Lahc history list L, it holds the objetive values
     std::unique_ptr<Individual> global_best;    // Global best solution found so far
+    HistoryStats history_stats;                 // min, max, mean and std of history_list, updated with it
     Indicators history_list_metrics;            // The statistical info of the history list
     Individual* current;                        // Current solution s
 
@@ -36,8 +45,28 @@ public:
     LeaderArray* leader;
     Follower* follower;
 
+    SharedBest* shared_best{};                  // best solution of a group of cooperating runs, nullptr for an isolated run
+    double shared_restart_rate{};               // probability that a restart starts from the shared best instead of a new solution
+    IslandModel* islands{};                     // island model this run belongs to, nullptr for an isolated run
+    int island{};                               // index of this run in islands
+    double emigrated_cost{};                    // cost of the last solution sent to the neighbours
+    long iteration_limit;                       // run_heuristic returns after this many iterations, unlimited by default
+
+    string output_label;                        // subdirectory of the outputs under the instance, empty outside a batch
+    string checkpoint_path;                     // file of the periodic checkpoints, empty for none
+    double checkpoint_interval{};               // seconds between two checkpoints
+    double next_checkpoint{};                   // coarse_seconds() of the next checkpoint
+    bool resume{};                              // run() starts from the checkpoint in checkpoint_path if there is one
+    bool leader_loaded{};                       // the leader already holds current (restored state), run_heuristic must not reload it
+    long resumed_log_rows{-1};                  // rows of the evolution log at the restored checkpoint, -1 for a new log
+    long resumed_trace_rows{-1};                // rows of the trace in full blocks at the restored checkpoint, -1 for a new trace
+    vector<uint64_t> resumed_trace_pending;     // the rows of its current block
+    unique_ptr<AsyncCheckpointWriter> checkpoint_writer;
+    unique_ptr<TraceWriter> trace;              // binary trace of the iterations, open during run() with a trace_interval
+
 public:
-    Lahc(int seed, Case *instance, Preprocessor* preprocessor);
+    Lahc(int seed, const Case* instance, const Preprocessor* preprocessor);
+    Lahc(int seed, const Case* instance, const Preprocessor* preprocessor, const Parameters& params); // search settings from params instead of preprocessor->params
     ~Lahc() override;
     void run() override;
     void initialize_heuristic() override;
@@ -46,6 +75,19 @@ public:
     void close_log_for_evolution() override;
     void flush_row_into_evol_log() override;
     void save_log_for_solution() override;
+    void open_trace();                          // <output_directory()>/trace.<instance>.bin
+    [[nodiscard]] string output_directory() const;  // stats/LAHC/<instance>/[<output_label>/]<seed>, created if needed
+    void charge_evaluations();                  // charges the distance lookups of split, leader and follower to the evaluation budget
+    void share_best(SharedBest* shared, double restart_rate);  // publishes improvements to shared, and restarts from it at restart_rate
+    void join_islands(IslandModel* model, int index);           // exchanges the global best with the neighbours of island index
+    void migrate();                             // sends the global best if it improved, adopts the best immigrant if it beats it
+    void enable_checkpoints(const string& path, double interval);  // writes the state to path every interval seconds
+    [[nodiscard]] string checkpoint_file() const;   // default checkpoint file of this run
+    [[nodiscard]] uint64_t checkpoint_fingerprint() const;  // instance, preprocessing, seed and history length the state belongs to
+    [[nodiscard]] vector<char> encode_state() const;
+    void decode_state(const vector<char>& payload);         // throws runtime_error on a malformed payload
+    void save_checkpoint();                     // encodes the state and hands it to the background writer, with the log rows to wait for
+    bool resume_from_checkpoint();              // restores the state saved in checkpoint_path, false if there is none
 
 };
 
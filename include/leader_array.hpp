@@ -8,11 +8,12 @@
 #include "case.hpp"
 #include "preprocessor.hpp"
 #include "individual.hpp"
+#include "dirty_routes.hpp"
 
 class LeaderArray {
 public:
-    Case* instance;
-    Preprocessor* preprocessor;
+    const Case* instance;
+    const Preprocessor* preprocessor;
     std::default_random_engine random_engine;   // Random number generator
     uniform_int_distribution<int> uniform_int_dis;// Uniform distribution for random integers
 
@@ -25,12 +26,14 @@ public:
     int max_search_depth;
     double upper_cost;
     double history_cost;
+    uint64_t num_lookups{};     // distance lookups of the moves evaluated since the search last charged its EvaluationBudget
+    DirtyRoutes dirty_routes;   // routes changed by the moves since the follower last caught up, all of them after a load
 
     void run(Individual* ind);
     void neighbour_explore(const double& history_val);
     void load_individual(Individual* ind);
     void export_individual(Individual* ind) const;
-    LeaderArray(int seed_val, Case* instance, Preprocessor* preprocessor);
+    LeaderArray(int seed_val, const Case* instance, const Preprocessor* preprocessor);
     ~LeaderArray();
 
 
@@ -97,8 +97,10 @@ public:
 
     double historyCost;
 
-    Case* instance;                             // Problem instance information
-    Preprocessor* preprocessor;                 // Preprocessed data
+    const Case* instance;                             // Problem instance information
+    const Preprocessor* preprocessor;                 // Preprocessed data
+    mutable uint64_t num_lookups{};             // distance lookups since the search last charged its EvaluationBudget
+    double metered_distance(int from, int to) const { ++num_lookups; return instance->distance(from, to); }
     std::default_random_engine random_engine;   // Random number generator
     uniform_int_distribution<int> uniformIntDis;// Uniform distribution for random integers
     uniform_int_distribution<int> disIntraMove; // Uniform distribution for random integers in the range for intra-route moves
@@ -106,6 +108,7 @@ public:
     bool searchCompleted;						// Tells whether all moves have been evaluated without success
     int nbMoves;								// Total number of moves (RI and SWAP*) applied during the local search. Attention: this is not only a simple counter, it is also used to avoid repeating move evaluations
     std::vector < int > orderNodes;				// Randomized order for checking the nodes in the RI local search
+    std::vector < std::vector < int > > correlatedVertices;	// Own copy of the correlated vertices of the Preprocessor, reshuffled by each run
     std::vector < int > orderRoutes;			// Randomized order for checking the routes in the SWAP* local search
     std::set < int > emptyRoutes;				// indices of all empty routes
     int loopID;									// Current loop index
@@ -194,7 +197,7 @@ public:
     void exportIndividual(Individual * indiv);
 
     // Constructor
-    LeaderLahc(int seed, Case* instance, Preprocessor* preprocessor);
+    LeaderLahc(int seed, const Case* instance, const Preprocessor* preprocessor);
 };
 
 
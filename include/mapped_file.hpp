@@ -0,0 +1,33 @@
+#ifndef FROGS_MAPPED_FILE_HPP
+#define FROGS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped, so no copy of the content is made;
+// elsewhere the content is read once into an owned buffer. The view stays valid until the object is destroyed.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& file_path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& file_path);          // maps the file, returns false if it can not be opened
+    void close();                                       // unmaps the file
+    [[nodiscard]] bool is_open() const { return data_ != nullptr || (opened_ && size_ == 0); }
+    [[nodiscard]] const char* data() const { return data_; }
+    [[nodiscard]] const char* end() const { return data_ + size_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+private:
+    const char* data_{};
+    std::size_t size_{};
+    bool opened_{};
+    bool is_mapped_{};          // true if data_ comes from mmap, false if it is an owned buffer
+};
+
+#endif //FROGS_MAPPED_FILE_HPP
@@ -0,0 +1,86 @@
+#ifndef FROGS_PARALLEL_HPP
+#define FROGS_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Number of threads used when 0 is requested: all hardware threads
+inline int resolve_num_threads(const int num_threads) {
+    if (num_threads > 0) return num_threads;
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Calls fn(first, last) on consecutive blocks of at most `grain` indices covering [begin, end), on up to num_threads
+// threads (0: all hardware threads), the calling thread included. Blocks are handed out from a shared counter, so
+// iterations of uneven cost stay balanced. fn must be safe to call concurrently on different blocks, and can keep
+// per-block scratch buffers. The first exception thrown by fn is rethrown once all threads have stopped.
+template <typename Fn>
+void parallel_for_blocks(const int begin, const int end, const int grain, Fn&& fn, const int num_threads = 0) {
+    if (begin >= end) return;
+    const int num_blocks = (end - begin + grain - 1) / grain;
+    const int num_workers = std::min(resolve_num_threads(num_threads), num_blocks);
+    if (num_workers == 1) {
+        for (int first = begin; first < end; first += grain) fn(first, std::min(first + grain, end));
+        return;
+    }
+
+    std::atomic<int> next{begin};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&]() {
+        try {
+            for (int first = next.fetch_add(grain); first < end; first = next.fetch_add(grain)) {
+                fn(first, std::min(first + grain, end));
+            }
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next = end;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers - 1);
+    for (int t = 1; t < num_workers; ++t) workers.emplace_back(work);
+    work();
+    for (auto& worker : workers) worker.join();
+    if (error) std::rethrow_exception(error);
+}
+
+// Calls fn(i) for every i in [begin, end), see parallel_for_blocks
+template <typename Fn>
+void parallel_for(const int begin, const int end, Fn&& fn, const int num_threads = 0, const int grain = 1) {
+    parallel_for_blocks(begin, end, grain, [&](const int first, const int last) {
+        for (int i = first; i < last; ++i) fn(i);
+    }, num_threads);
+}
+
+// Wall time of the successive phases of a construction, e.g. {"parse", 0.01}, {"distances", 0.12}
+class PhaseTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PhaseTimer() : last_(Clock::now()) {}
+
+    // Closes the current phase under the given name and starts the next one
+    void lap(const std::string& phase) {
+        const auto now = Clock::now();
+        phases_.emplace_back(phase, std::chrono::duration<double>(now - last_).count());
+        last_ = now;
+    }
+
+    [[nodiscard]] const std::vector<std::pair<std::string, double>>& phases() const { return phases_; }
+
+private:
+    Clock::time_point last_;
+    std::vector<std::pair<std::string, double>> phases_;
+};
+
+#endif //FROGS_PARALLEL_HPP
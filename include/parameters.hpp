@@ -11,21 +11,41 @@
 using namespace std;
 
 enum class Algorithm { CBMA, LAHC};
+enum class Topology { NONE, RING, RANDOM };    // migration topology of the island model, NONE for isolated trials
 
 struct Parameters {
     // Running parameters
     Algorithm algorithm;        // Algorithm name
     string instance;            // Problem instance name
+    string plan;                // Batch plan file, empty for a single instance
+    string output_label;        // Subdirectory of the run's outputs under its instance, set per batch job
     bool enable_logging;        // Enable logging
+    int trace_interval;         // LAHC iterations between two rows of the binary trace, 0 for no trace
     int stop_criteria;          // Stopping criteria (e.g., max evaluations used)
+    double time_limit;          // Time budget of the max-time criterion in seconds, 0 for the instance default
     bool enable_multithreading; // Enable multi-threading
     int seed;                   // Random seed
+    int num_trials;             // Number of independent trials with multi-threading, seeded seed + 1, seed + 2, ...
+    int num_workers;            // Worker threads running the trials, 0 for all cores
+    bool pin_workers;           // Pin each trial worker to its own CPU (Linux)
+    bool cooperative;           // Trials share their best solution and restart from it
+    Topology topology;          // Island model: trials exchange their elite solutions with their neighbours
+    int migration_interval;     // Island model: LAHC iterations between two migrations
+    int checkpoint_interval;    // Seconds between two checkpoints of each trial's state, 0 for none
+    bool resume;                // Each trial starts from its checkpoint if there is one
+    bool enable_instance_cache; // Load/store the preprocessed instance tables from/to a binary cache file
+    bool pad_distance_rows;     // Pad the rows of the distance matrix to whole cache lines
+    bool enable_huge_pages;     // Back large distance matrices with transparent huge pages (Linux)
+    int matrix_free_threshold;  // Above this number of nodes, distances are computed on the fly instead of stored
+    bool renumber_nodes;        // Renumber customers and stations along a space-filling curve at load time
+    int build_threads;          // Threads building the distance matrix and the preprocessing tables, 0 for all cores
 
     // Algorithm parameters
     int nb_granular;            // Granular search parameter
     bool is_hard_constraint;    // Hard constraint
     bool is_duration_constraint;// Whether to consider duration constraint
     int history_length;         // LAHC history length
+    int route_cache_size;       // Routes whose charging decisions the Follower keeps, 0 for no cache
 
 
     // Constructor: Initializes default values
@@ -33,14 +53,31 @@ struct Parameters {
             algorithm(Algorithm::LAHC),
             instance("E-n22-k4.evrp"),
             enable_logging(false),
+            trace_interval(0),
             stop_criteria(0),
+            time_limit(0.0),
             enable_multithreading(false),
-            seed(0) {
+            seed(0),
+            num_trials(10),
+            num_workers(0),
+            pin_workers(false),
+            cooperative(false),
+            topology(Topology::NONE),
+            migration_interval(1'000),
+            checkpoint_interval(0),
+            resume(false),
+            enable_instance_cache(false),
+            pad_distance_rows(true),
+            enable_huge_pages(true),
+            matrix_free_threshold(20'000),
+            renumber_nodes(false),
+            build_threads(0) {
 
         nb_granular = 20;
         is_hard_constraint = true;
         is_duration_constraint = false;
         history_length = 5'000;
+        route_cache_size = 16'384;
     }
 };
 
@@ -8,6 +8,9 @@
 #include "case.hpp"
 #include "parameters.hpp"
 #include "CircleSector.h"
+#include "instance_cache.hpp"
+#include "spatial_index.hpp"
+#include "best_station_table.hpp"
 #include <random>
 
 
@@ -24,8 +27,12 @@ struct Customer {
 
 class Preprocessor {
     static const int MAX_EVALUATION_FACTOR;
+    static const int kScannedStations;  // up to this many stations, the station queries scan them linearly instead of using station_index_ (twice as fast there, see the spatial_index benchmark)
 
 public:
+    static const int kNearbyCustomers;      // length of the stored rows of sorted_nearby_customers_
+    static const int kLazyStationsPerNode;  // matrix-free backend: arcs per node of best_station_ filled on their first lookup
+
     const Case& c;
     const Parameters& params;
 
@@ -49,16 +56,33 @@ public:
     vector<int> station_ids_;       // the id of charging stations
     vector<Customer> customers_;    // the information list of customers
 
-    vector<vector<int>> sorted_nearby_customers_;   // For Hien's clustering usage only. For each customer, a list of customer nodes from near to far, e.g., {index 1: [5,3,2,6], index 2: [], ...}
+    vector<vector<int>> sorted_nearby_customers_;   // For Hien's clustering usage only. For each customer, its kNearbyCustomers nearest customers from near to far (ties by id), e.g., {index 1: [5,3,2,6], index 2: [], ...}; nearby_customers() goes further
     vector<vector<int>> correlated_vertices_;       // Neighborhood restrictions: For each client, list of nearby customers
-    vector<vector<int>> best_station_;              // For each pair of customers, the best station to visit, i.e., the station that minimizes the extra cost
+    BestStationTable best_station_;                 // For each pair of customers, the best station to visit, i.e., the station that minimizes the extra cost. Filled for the correlated arcs and the depot arcs, lazily for the others; sparse on the matrix-free backend
+    SpatialIndex station_index_;                    // k-d tree over the charging stations
+    SpatialIndex customer_index_;                   // k-d tree over the customers
+    vector<pair<string, double>> startup_phases_;   // wall time in seconds of each table construction phase
 
     Preprocessor(const Case& c, const Parameters& params);
 
+    void build_tables();                                // computes max_distance_, the neighbour lists and the eager part of best_station_
+    void load_tables(const InstanceCache& cache);       // takes the same tables from a mapped instance cache
+
+    // The count nearest customers of customer (all of them if there are fewer), from near to far: its row of
+    // sorted_nearby_customers_ if that is long enough, else a longer row written to extended by customer_index_
+    const vector<int>& nearby_customers(int customer, int count, vector<int>& extended) const;
+    [[nodiscard]] int best_station(int from, int to) const;      // best_station_ lookup, computes and stores the entry on its first use
+    int fill_best_station(int from, int to) const;              // the first-use path of best_station, kept out of line
     [[nodiscard]] int get_best_station(int from, int to) const;
     [[nodiscard]] int get_best_and_feasible_station(int from, int to, double max_dis) const; // the station within allowed max distance from "from", and min dis[from][s]+dis[to][s]
 
 };
 
 
+inline int Preprocessor::best_station(const int from, const int to) const {
+    const int station = best_station_.station(from, to);
+    if (station != BestStationTable::kUnknownStation) return station;
+    return fill_best_station(from, to);
+}
+
 #endif //FROGS_PREPROCESSOR_HPP
@@ -0,0 +1,51 @@
+#ifndef FROGS_ROUTE_CACHE_HPP
+#define FROGS_ROUTE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Charging decisions of the Follower per route, keyed by the node sequence of the route (depots included). A move of
+// the leader changes at most two routes, so most routes of a solution are answered from here instead of repaired
+// again. The table is set-associative, kWays entries per set with least-recently-used replacement, so its size is
+// fixed; keys are compared in full, a hash collision is never taken for a hit. Not thread-safe: one per Follower.
+class RouteCache {
+public:
+    static const int kWays;
+
+    struct Entry {
+        uint64_t hash{};
+        uint64_t stamp{};                       // last use, 0 for an empty entry
+        double cost{};                          // cost added to the lower cost, INFEASIBLE included
+        uint64_t lookups{};                     // distance lookups the repair took
+        int length{};                           // nodes of the route
+        int repaired_length{};                  // nodes of the repaired route
+        vector<int> nodes;                      // the route, then the repaired route
+
+        [[nodiscard]] const int* repaired() const { return nodes.data() + length; }
+    };
+
+    void resize(size_t capacity);               // about capacity entries (a power of two), all empty; 0 disables the cache
+    [[nodiscard]] bool enabled() const { return !entries_.empty(); }
+    [[nodiscard]] size_t capacity() const { return entries_.size(); }
+
+    static uint64_t hash(const int* route, int length);
+    const Entry* find(uint64_t hash, const int* route, int length);        // nullptr on a miss
+    void insert(uint64_t hash, const int* route, int length, const int* repaired, int repaired_length, double cost,
+                uint64_t lookups);
+
+    [[nodiscard]] uint64_t num_hits() const { return hits_; }
+    [[nodiscard]] uint64_t num_misses() const { return misses_; }
+    [[nodiscard]] double hit_rate() const { return hits_ + misses_ > 0 ? static_cast<double>(hits_) / static_cast<double>(hits_ + misses_) : 0.0; }
+
+private:
+    vector<Entry> entries_;                     // set s holds entries_[s * kWays, (s + 1) * kWays)
+    size_t set_mask_{};
+    uint64_t clock_{};
+    uint64_t hits_{};
+    uint64_t misses_{};
+};
+
+#endif //FROGS_ROUTE_CACHE_HPP
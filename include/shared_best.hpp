@@ -0,0 +1,79 @@
+#ifndef FROGS_SHARED_BEST_HPP
+#define FROGS_SHARED_BEST_HPP
+
+#include "individual.hpp"
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Best solution found by a group of searches running on different threads. Reading is lock-free: the best is an
+// immutable snapshot behind one atomic pointer, and the most common publish, one that does not improve the best, is
+// rejected on an atomic cost. An improvement copies the solution outside any lock, then swaps it in under a mutex
+// only publishers take, and records its cost and time. A replaced snapshot is freed as soon as no Reader holds one, so
+// memory stays at the best snapshot, the few a reader may still hold and one small record per improvement.
+// Without keep_solutions only the records are kept, e.g. to report on independent searches that never restart from
+// the best.
+class SharedBest {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Snapshot {
+        Individual solution;
+        double cost;                    // lower_cost of the solution
+        double seconds;                 // time since the SharedBest was created
+        int publisher;                  // seed of the search that found it
+    };
+
+    struct Improvement {
+        double cost{numeric_limits<double>::max()};
+        double seconds{-1.0};
+        int publisher{-1};
+    };
+
+    // The best snapshot when it was created, not freed before the Reader is destroyed
+    class Reader {
+    public:
+        explicit Reader(const SharedBest& shared);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        [[nodiscard]] const Snapshot* get() const { return snapshot_; }    // nullptr before the first publish
+        const Snapshot* operator->() const { return snapshot_; }
+
+    private:
+        const SharedBest& shared_;
+        const Snapshot* snapshot_;
+    };
+
+    explicit SharedBest(bool keep_solutions = true) : start_(Clock::now()), keep_solutions_(keep_solutions) {}
+    ~SharedBest();
+    SharedBest(const SharedBest&) = delete;
+    SharedBest& operator=(const SharedBest&) = delete;
+
+    bool publish(const Individual& solution, int publisher);   // records it if it improves the best, returns whether it did
+    [[nodiscard]] double best_cost() const { return best_cost_.load(std::memory_order_acquire); }
+    [[nodiscard]] Improvement best_improvement() const;         // cost, time and publisher of the best, defaults if none
+    [[nodiscard]] vector<Improvement> improvements() const;     // in publish order, strictly decreasing costs
+    [[nodiscard]] double seconds_to_reach(double target) const; // first time the best was <= target, -1 if never
+    [[nodiscard]] int num_improvements() const;
+    [[nodiscard]] size_t num_snapshots() const;                 // alive: the best and those a reader may still hold
+
+private:
+    Clock::time_point start_;
+    const bool keep_solutions_;
+    std::atomic<const Snapshot*> best_{nullptr};
+    std::atomic<double> best_cost_{numeric_limits<double>::max()};
+    mutable std::atomic<int> readers_{0};
+    mutable std::mutex mutex_;                      // taken by improving publishers and the reports only
+    vector<const Snapshot*> retired_;               // replaced snapshots, freed once there is no reader
+    vector<Improvement> improvements_;
+
+    void reclaim();                                 // with mutex_ held
+};
+
+#endif //FROGS_SHARED_BEST_HPP
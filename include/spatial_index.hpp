@@ -0,0 +1,48 @@
+#ifndef FROGS_SPATIAL_INDEX_HPP
+#define FROGS_SPATIAL_INDEX_HPP
+
+#include "case.hpp"
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+// k-d tree over a subset of the nodes of a Case, e.g. the charging stations or the customers.
+// Whole subtrees are skipped with bounding-box lower bounds, and the candidates that remain are measured with
+// Case::distance, so every answer is exactly the one of a linear scan over the same nodes in increasing id order.
+// The Case must outlive the index.
+class SpatialIndex {
+public:
+    static const int kLeafSize;         // maximum number of nodes per leaf
+
+    SpatialIndex() = default;
+    SpatialIndex(const Case& c, const vector<int>& nodes);
+    void build(const Case& c, const vector<int>& nodes);
+
+    // The indexed node s, other than from and to, that minimises d(from, s) + d(to, s) among those with
+    // d(from, s) < max_from and d(s, to) < max_to; the smallest id on ties, -1 if there is none
+    [[nodiscard]] int best_detour(int from, int to,
+                                  double max_from = numeric_limits<double>::infinity(),
+                                  double max_to = numeric_limits<double>::infinity()) const;
+    // The k indexed nodes closest to node (node itself excluded), ordered by (distance, id)
+    void nearest(int node, int k, vector<int>& out) const;
+    [[nodiscard]] int size() const { return static_cast<int>(ids_.size()); }
+
+private:
+    struct TreeNode {
+        double min_x, min_y, max_x, max_y;  // bounding box of the points of the subtree
+        int begin, end;                     // range of the subtree in ids_ / xs_ / ys_
+        int left, right;                    // children, -1 for a leaf
+    };
+
+    const Case* c_{};
+    vector<int> ids_;                       // node ids, in tree order
+    vector<double> xs_;                     // coordinates, in tree order
+    vector<double> ys_;
+    vector<TreeNode> tree_;                 // tree_[0] is the root
+
+    int build_subtree(int begin, int end);
+    [[nodiscard]] double box_distance(const TreeNode& box, int node) const; // lower bound of the distance from node to the box
+};
+
+#endif //FROGS_SPATIAL_INDEX_HPP
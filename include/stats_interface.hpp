@@ -16,6 +16,7 @@
 #include <iomanip>
 #include <sstream>
 #include <numeric>
+#include <memory>
 
 namespace fs = std::filesystem;
 using namespace std;
@@ -35,8 +36,7 @@ public:
     std::chrono::high_resolution_clock::time_point start;
     std::chrono::duration<double> duration;
 
-    std::ofstream log_evolution;
-    std::ostringstream oss_row_evol;
+    std::unique_ptr<class EvolutionLog> log_evolution;     // written by a background thread, see evolution_log.hpp
     std::ofstream log_solution;
 
     static Indicators calculate_statistical_indicators(const std::vector<double>& datas);
@@ -48,7 +48,7 @@ public:
     virtual void close_log_for_evolution() = 0; // close the file
     virtual void save_log_for_solution() = 0; // open a file, save the solution, and close it
 
-    virtual ~StatsInterface() = default;
+    virtual ~StatsInterface();
 };
 
 #endif //FROGS_STATS_INTERFACE_HPP
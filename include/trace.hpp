@@ -0,0 +1,112 @@
+#ifndef FROGS_TRACE_HPP
+#define FROGS_TRACE_HPP
+
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Binary columnar trace of a run, e.g. one row per LAHC iteration. Every value is an 8-byte word, so the layout is
+// fixed and the file can be memory-mapped as it is:
+//   header   32 bytes: magic "FROGSTR", version, number of columns, rows per block; then one 32-byte descriptor per
+//            column: its name, zero-padded to 24 bytes, and its type
+//   blocks   a uint64 row count followed by one array of block_rows values per column; the last block is zero-padded
+// Full blocks are written as soon as they are complete, so a crash only loses the rows of the current block. A writer
+// opened with the num_written() and pending_rows() of an earlier one, as saved in a checkpoint, cuts the file back to
+// those full blocks and continues it from those rows.
+enum class TraceType : uint32_t { INT64 = 0, DOUBLE = 1 };
+
+struct TraceColumn {
+    string name;                                // at most kMaxNameLength characters
+    TraceType type{TraceType::DOUBLE};
+};
+
+// One value of a row, stored as its 8-byte pattern
+struct TraceValue {
+    uint64_t bits{};
+    TraceValue(const double value) { std::memcpy(&bits, &value, sizeof(bits)); }
+    TraceValue(const long value) : bits(static_cast<uint64_t>(value)) {}
+    TraceValue(const int value) : bits(static_cast<uint64_t>(static_cast<int64_t>(value))) {}
+    TraceValue(const uint64_t value) : bits(value) {}
+};
+
+struct TraceFormat {
+    static const char kMagic[8];
+    static const uint32_t kVersion;
+    static const size_t kMaxNameLength;
+    static const size_t kHeaderSize;            // bytes before the column descriptors
+    static const size_t kColumnSize;            // bytes of a column descriptor
+
+    static size_t data_offset(size_t num_columns) { return kHeaderSize + num_columns * kColumnSize; }
+    static size_t block_bytes(size_t num_columns, size_t block_rows) { return sizeof(uint64_t) * (1 + num_columns * block_rows); }
+};
+
+class TraceWriter {
+public:
+    static const size_t kBlockRows;             // default rows per block
+
+    // resume_rows = -1 starts a new file; throws runtime_error, also when a resumed file does not match or has fewer rows
+    TraceWriter(const string& path, const vector<TraceColumn>& columns, size_t block_rows = kBlockRows, long resume_rows = -1,
+                const vector<uint64_t>& pending = {});
+    ~TraceWriter();                             // same as close()
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    void append(std::initializer_list<TraceValue> row);     // one value per column, in column order
+    void close();                               // writes the last, partial block and closes the file
+
+    [[nodiscard]] size_t num_columns() const { return num_columns_; }
+    [[nodiscard]] long num_rows() const { return num_rows_; }
+    [[nodiscard]] long num_written() const { return num_rows_ - static_cast<long>(rows_in_block_); }  // rows in full blocks
+    [[nodiscard]] vector<uint64_t> pending_rows() const;    // values of the rows after num_written(), column by column
+
+private:
+    ofstream file_;
+    size_t num_columns_;
+    size_t block_rows_;
+    vector<uint64_t> block_;                    // row count, then the columns of the current block
+    size_t rows_in_block_{};
+    long num_rows_{};
+    size_t block_offset_{};                     // file position of the current block
+
+    void write_header(const vector<TraceColumn>& columns);
+    void reopen(const string& path, const vector<TraceColumn>& columns, long resume_rows, const vector<uint64_t>& pending);
+    void write_block();
+};
+
+// Memory-mapped view of a trace file. A trailing incomplete block, as left by a crash, is ignored.
+class TraceReader {
+public:
+    explicit TraceReader(const string& path);   // throws runtime_error on a missing or malformed file
+
+    [[nodiscard]] size_t num_columns() const { return columns_.size(); }
+    [[nodiscard]] size_t num_rows() const { return num_rows_; }
+    [[nodiscard]] size_t block_rows() const { return block_rows_; }
+    [[nodiscard]] const TraceColumn& column(const size_t c) const { return columns_[c]; }
+    [[nodiscard]] int find_column(const string& name) const;       // -1 if there is none
+    [[nodiscard]] double value(size_t row, size_t c) const;        // converted to double for INT64 columns
+    [[nodiscard]] int64_t integer(size_t row, size_t c) const;     // converted to int64 for DOUBLE columns
+    // The values of column c in the given block, block_size(block) of them, straight from the mapping
+    [[nodiscard]] const uint64_t* block_column(size_t block, size_t c) const;
+    [[nodiscard]] size_t num_blocks() const { return block_counts_.size(); }
+    [[nodiscard]] size_t block_size(const size_t block) const { return block_counts_[block]; }
+
+    void write_csv(ostream& out) const;         // header line with the column names, then one line per row
+
+private:
+    MappedFile file_;
+    vector<TraceColumn> columns_;
+    size_t block_rows_{};
+    vector<size_t> block_counts_;               // rows of each block, all full but the last
+    size_t num_rows_{};
+
+    [[nodiscard]] uint64_t bits(size_t row, size_t c) const;
+};
+
+#endif //FROGS_TRACE_HPP
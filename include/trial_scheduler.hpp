@@ -0,0 +1,48 @@
+#ifndef FROGS_TRIAL_SCHEDULER_HPP
+#define FROGS_TRIAL_SCHEDULER_HPP
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Outcome and cost of one trial
+struct TrialReport {
+    int trial{};                // 0-based trial index
+    int seed{};                 // seed the trial ran with
+    int worker{};               // worker thread that ran it
+    int cpu{-1};                // CPU the worker was pinned to, -1 if not pinned
+    double result{};            // value returned by the trial, e.g. the best objective
+    double wall_seconds{};      // wall time of the trial
+    double cpu_seconds{};       // CPU time of the worker thread during the trial
+};
+
+// Runs independent trials on a pool of worker threads. Workers take the next trial from a shared counter, so a pool
+// smaller than the number of trials stays busy until the last one; with pinning, worker w is bound to CPU
+// w % (number of CPUs) (Linux only, ignored elsewhere). The first exception thrown by a trial is rethrown by run()
+// once all the workers have stopped.
+class TrialScheduler {
+public:
+    using Trial = function<double(int trial, int seed)>;
+
+    TrialScheduler(int num_trials, int num_workers, bool pin_workers, int base_seed);  // num_workers 0: all hardware threads
+
+    static int trial_seed(int base_seed, int trial);    // base_seed + trial + 1, i.e. seeds 1..num_trials for -seed 0
+    vector<TrialReport> run(const Trial& trial) const;  // one report per trial, in trial order
+
+    [[nodiscard]] int num_trials() const { return num_trials_; }
+    [[nodiscard]] int num_workers() const { return num_workers_; }
+
+    static void print_reports(const vector<TrialReport>& reports, ostream& out);    // one line per trial
+    static void save_reports(const vector<TrialReport>& reports, const string& file_path); // the same, as csv
+
+private:
+    int num_trials_;
+    int num_workers_;           // at most num_trials_
+    bool pin_workers_;
+    int base_seed_;
+};
+
+#endif //FROGS_TRIAL_SCHEDULER_HPP
@@ -1,43 +1,47 @@
-#include <thread>
-#include <mutex>
 #include "parameters.hpp"
 #include "command_line.hpp"
 #include "case.hpp"
 #include "preprocessor.hpp"
 #include "lahc.hpp"
+#include "trial_scheduler.hpp"
+#include "batch_runner.hpp"
 #include "magic_enum.hpp"
 
 using namespace std;
 using namespace magic_enum;
 
-#define MAX_TRIALS 10
-
-std::mutex perf_mutex;
-
-void run_algorithm(int run, const Parameters* params, vector<double>& perf_of_trials) {
-    Case* instance = new Case(params->instance);
-    auto* preprocessor = new Preprocessor(*instance, *params);
-
-    switch (params->algorithm) {
+// Set by SIGINT / SIGTERM: the trials stop at their next deadline check and the results found so far are written out
+CancellationToken cancellation;
+// Follower route cache use, summed over the trials
+std::atomic<uint64_t> route_cache_hits{0};
+std::atomic<uint64_t> route_cache_misses{0};
+
+// One trial, returns the best objective found. The instance and its preprocessed tables are built once and shared
+// read-only by all the trials, which also publish their improvements to shared_best (and restart from it in the
+// cooperative mode) and, with an island model, exchange their elite solutions as island `trial`
+double run_algorithm(int trial, int seed, const Case* instance, const Preprocessor* preprocessor, SharedBest* shared_best,
+                     IslandModel* islands) {
+    double best = 0.0;
+    switch (preprocessor->params.algorithm) {
         case Algorithm::CBMA: {
             // TODO: Implement CBMA
             break;
         }
 
         case Algorithm::LAHC: {
-            Lahc* lahc = new Lahc(run, instance, preprocessor);
+            Lahc* lahc = new Lahc(seed, instance, preprocessor);
+            lahc->share_best(shared_best, preprocessor->params.cooperative ? Lahc::kSharedRestartRate : 0.0);
+            if (islands) lahc->join_islands(islands, trial);
+            lahc->cancellation = &cancellation;
             lahc->run();
-            {
-                std::lock_guard<std::mutex> lock(perf_mutex);
-                perf_of_trials[run - 1] = lahc->global_best->lower_cost;
-            }
+            best = lahc->global_best->lower_cost;
+            route_cache_hits += lahc->follower->route_cache.num_hits();
+            route_cache_misses += lahc->follower->route_cache.num_misses();
             delete lahc;
             break;
         }
     }
-
-    delete preprocessor;
-    delete instance;
+    return best;
 }
 
 int main(int argc, char *argv[])
@@ -46,29 +50,57 @@ int main(int argc, char *argv[])
 
     CommandLine cmd(argc, argv);
     cmd.parse_parameters(params);
+    cancel_on_signals(&cancellation);
+
+    // Batch mode: all the jobs of the plan in this process, results in ../stats/batch/<plan name>
+    if (!params.plan.empty()) {
+        BatchRunner runner(BatchPlan::load(params.plan), params);
+        const vector<BatchResult> results = runner.run([](const BatchJob& job, const Case* c, const Preprocessor* p) {
+            return BatchRunner::run_lahc(job, c, p, &cancellation);
+        }, params.num_workers, params.pin_workers);
+        BatchRunner::print_summary(results, cout);
+        BatchRunner::save_results(results, kStatsPath + "/batch/" + fs::path(params.plan).stem().string());
+        return 0;
+    }
 
-    vector<double> perf_of_trials(MAX_TRIALS, 0.0);
-    if (!params.enable_multithreading){
-        run_algorithm(1, &params, std::ref(perf_of_trials));
-    } else {
-        std::vector<std::thread> threads;
-
-        for (int run = 2; run <= MAX_TRIALS; ++run) {
-            threads.emplace_back(run_algorithm, run, &params, std::ref(perf_of_trials));
-        }
-        run_algorithm(1, &params, std::ref(perf_of_trials));
-
-        for (auto& thread : threads) {
-            thread.join();
-        }
+    const Case instance(params.instance, params);
+    const Preprocessor preprocessor(instance, params);
+
+    // Without multi-threading, a single trial on the calling thread
+    const TrialScheduler scheduler(params.enable_multithreading ? params.num_trials : 1,
+                                   params.enable_multithreading ? params.num_workers : 1,
+                                   params.pin_workers, params.seed);
+    // Only the cooperative trials restart from the best solution, the others need the record of its improvements
+    SharedBest shared_best(params.cooperative);
+    IslandModel islands(scheduler.num_trials(), params.topology, params.migration_interval);
+    IslandModel* island_model = params.topology != Topology::NONE ? &islands : nullptr;
+    const vector<TrialReport> reports = scheduler.run([&](const int trial, const int seed) {
+        return run_algorithm(trial, seed, &instance, &preprocessor, &shared_best, island_model);
+    });
+    TrialScheduler::print_reports(reports, cout);
+    if (const SharedBest::Improvement best = shared_best.best_improvement(); best.publisher >= 0) {
+        cout << (params.cooperative ? "cooperative" : island_model ? "island" : "independent") << " trials: best " << fixed << setprecision(2)
+             << best.cost << " by seed " << best.publisher << " after " << setprecision(3) << best.seconds
+             << " s, " << shared_best.num_improvements() << " improvements\n";
+    }
+    if (const uint64_t routes = route_cache_hits + route_cache_misses; routes > 0) {
+        cout << "route cache: " << fixed << setprecision(1) << 100.0 * static_cast<double>(route_cache_hits) / static_cast<double>(routes)
+             << "% hits over " << routes << " routes repaired by the follower\n";
+    }
+    if (cancellation.cancelled()) cout << "cancelled: results are the best found before the signal\n";
+    if (island_model) {
+        cout << "islands: " << islands.num_sent() << " migrants sent, " << islands.num_dropped() << " dropped\n";
     }
 
+    vector<double> perf_of_trials;
+    for (const auto& report : reports) perf_of_trials.push_back(report.result);
 
     string stats_file_path = kStatsPath + "/" + static_cast<string>(enum_name(params.algorithm)) + "/" +
                              params.instance.substr(0, params.instance.find('.'));
 
     StatsInterface::create_directories_if_not_exists(stats_file_path);
     StatsInterface::stats_for_multiple_trials(stats_file_path + "/" + "stats." + params.instance,perf_of_trials);
+    TrialScheduler::save_reports(reports, stats_file_path + "/" + "trials." + params.instance + ".csv");
 
     return 0;
 }
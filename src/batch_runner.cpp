@@ -0,0 +1,253 @@
+#include "batch_runner.hpp"
+#include "command_line.hpp"
+#include "lahc.hpp"
+#include "stats_interface.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+const vector<string> BatchRunner::kSearchKeys = {"history_length", "stp", "time_limit", "log", "trace", "route_cache"};
+
+namespace {
+
+// Options read by the Preprocessor but not by Case
+const vector<string> kTableKeys = {"nb_granular", "is_hard_constraint", "is_duration_constraint"};
+// Options a plan sets through its own lines, or that make no sense per job
+const vector<string> kReservedKeys = {"ins", "seed", "plan", "mth", "trials", "workers", "pin"};
+
+bool contains(const vector<string>& keys, const string& key) {
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+// Instance and the settings whose keys are not excluded, e.g. "E-n22-k4.evrp nb_granular=20"
+string group_key(const BatchJob& job, const vector<string>& excluded_a, const vector<string>& excluded_b) {
+    string key = job.instance;
+    for (const auto& [name, value] : job.settings) {
+        if (!contains(excluded_a, name) && !contains(excluded_b, name)) key += " " + name + "=" + value;
+    }
+    return key;
+}
+
+} // namespace
+
+BatchPlan BatchPlan::parse(istream& in) {
+    BatchPlan plan;
+    string line;
+    for (int line_number = 1; std::getline(in, line); ++line_number) {
+        if (const auto comment = line.find('#'); comment != string::npos) line.erase(comment);
+        istringstream tokens(line);
+        string key;
+        if (!(tokens >> key)) continue;
+        vector<string> values;
+        for (string value; tokens >> value;) values.push_back(value);
+
+        const string where = "plan line " + to_string(line_number) + ": ";
+        if (values.empty()) throw invalid_argument(where + "no values for '" + key + "'");
+        if (key[0] == '-') key.erase(0, key.find_first_not_of('-'));
+
+        if (key == "instances") {
+            plan.instances.insert(plan.instances.end(), values.begin(), values.end());
+        } else if (key == "seeds") {
+            for (const auto& value : values) {
+                try {
+                    if (const auto range = value.find(".."); range != string::npos) {
+                        const int first = std::stoi(value.substr(0, range));
+                        const int last = std::stoi(value.substr(range + 2));
+                        if (last < first) throw invalid_argument("empty range");
+                        for (int seed = first; seed <= last; ++seed) plan.seeds.push_back(seed);
+                    } else {
+                        plan.seeds.push_back(std::stoi(value));
+                    }
+                } catch (const std::exception&) {
+                    throw invalid_argument(where + "bad seed '" + value + "'");
+                }
+            }
+        } else if (contains(kReservedKeys, key)) {
+            throw invalid_argument(where + "'" + key + "' cannot be a grid key");
+        } else {
+            const auto it = std::find_if(plan.grid.begin(), plan.grid.end(), [&](const auto& entry) { return entry.first == key; });
+            if (it != plan.grid.end()) throw invalid_argument(where + "duplicate grid key '" + key + "'");
+            plan.grid.emplace_back(key, values);
+        }
+    }
+    if (plan.instances.empty()) throw invalid_argument("plan: no instances");
+    if (plan.seeds.empty()) plan.seeds.push_back(1);
+    return plan;
+}
+
+BatchPlan BatchPlan::load(const string& file_path) {
+    ifstream in(file_path);
+    if (!in) throw runtime_error("cannot open the plan file " + file_path);
+    return parse(in);
+}
+
+string BatchJob::settings_label() const {
+    string label;
+    for (const auto& [key, value] : settings) label += (label.empty() ? "" : " ") + key + "=" + value;
+    return label;
+}
+
+string BatchJob::output_label() const {
+    string label;
+    for (const auto& [key, value] : settings) label += (label.empty() ? "" : ",") + key + "=" + value;
+    std::replace_if(label.begin(), label.end(), [](const char c) { return c == '/' || c == ' '; }, '_');
+    return label;
+}
+
+BatchRunner::BatchRunner(const BatchPlan& plan, const Parameters& base) {
+    // Every combination of the grid values, the first key varying slowest
+    vector<vector<pair<string, string>>> combinations(1);
+    for (const auto& [key, values] : plan.grid) {
+        vector<vector<pair<string, string>>> next;
+        for (const auto& combination : combinations) {
+            for (const auto& value : values) {
+                next.push_back(combination);
+                next.back().emplace_back(key, value);
+            }
+        }
+        combinations = std::move(next);
+    }
+
+    map<string, int> case_ids, table_ids;
+    for (const auto& instance : plan.instances) {
+        for (const auto& settings : combinations) {
+            BatchJob job;
+            job.instance = instance;
+            job.settings = settings;
+            job.params = base;
+            CommandLine(unordered_map<string, string>(settings.begin(), settings.end())).parse_parameters(job.params);
+            job.params.instance = instance;
+            // Jobs of the same instance and seed write their log, trace and checkpoints apart
+            job.params.output_label = job.output_label();
+
+            const string case_key = group_key(job, kSearchKeys, kTableKeys);
+            if (const auto [it, inserted] = case_ids.emplace(case_key, static_cast<int>(cases_.size())); inserted) {
+                cases_.push_back(make_unique<CaseGroup>());
+                cases_.back()->params = job.params;
+            }
+            job.case_group = case_ids[case_key];
+            // The nearest customers of a matrix-free Case must cover the largest neighbourhood of its jobs
+            auto& case_params = cases_[job.case_group]->params;
+            case_params.nb_granular = std::max(case_params.nb_granular, job.params.nb_granular);
+
+            const string table_key = group_key(job, kSearchKeys, {});
+            if (const auto [it, inserted] = table_ids.emplace(table_key, static_cast<int>(tables_.size())); inserted) {
+                tables_.push_back(make_unique<TableGroup>());
+                tables_.back()->params = job.params;
+                tables_.back()->case_group = job.case_group;
+            }
+            job.table_group = table_ids[table_key];
+
+            for (const int seed : plan.seeds) {
+                job.seed = seed;
+                jobs_.push_back(job);
+            }
+        }
+    }
+
+    // Jobs sharing tables run next to each other, so that few instances are alive at the same time
+    std::stable_sort(jobs_.begin(), jobs_.end(), [](const BatchJob& a, const BatchJob& b) {
+        return a.case_group != b.case_group ? a.case_group < b.case_group : a.table_group < b.table_group;
+    });
+    for (const auto& job : jobs_) {
+        cases_[job.case_group]->remaining++;
+        tables_[job.table_group]->remaining++;
+    }
+}
+
+vector<BatchResult> BatchRunner::run(const Job& job, const int num_workers, const bool pin_workers) {
+    const TrialScheduler scheduler(static_cast<int>(jobs_.size()), num_workers, pin_workers, 0);
+    const vector<TrialReport> reports = scheduler.run([&](const int index, int) {
+        const BatchJob& current = jobs_[index];
+        CaseGroup& case_group = *cases_[current.case_group];
+        TableGroup& table_group = *tables_[current.table_group];
+
+        std::call_once(case_group.built, [&] {
+            case_group.instance = make_unique<Case>(case_group.params.instance, case_group.params);
+        });
+        std::call_once(table_group.built, [&] {
+            table_group.preprocessor = make_unique<Preprocessor>(*case_group.instance, table_group.params);
+        });
+
+        const double result = job(current, case_group.instance.get(), table_group.preprocessor.get());
+
+        // The last job of a group releases its tables
+        if (--table_group.remaining == 0) table_group.preprocessor.reset();
+        if (--case_group.remaining == 0) case_group.instance.reset();
+        return result;
+    });
+
+    vector<BatchResult> results(jobs_.size());
+    for (size_t i = 0; i < jobs_.size(); ++i) {
+        results[i].job = &jobs_[i];
+        results[i].report = reports[i];
+        results[i].report.seed = jobs_[i].seed;
+    }
+    return results;
+}
+
+double BatchRunner::run_lahc(const BatchJob& job, const Case* instance, const Preprocessor* preprocessor,
+                             const CancellationToken* cancellation) {
+    Lahc lahc(job.seed, instance, preprocessor, job.params);
+    lahc.cancellation = cancellation;
+    lahc.run();
+    return lahc.global_best->lower_cost;
+}
+
+namespace {
+
+// Results grouped by instance and settings, in job order
+vector<pair<const BatchJob*, vector<const BatchResult*>>> group_by_settings(const vector<BatchResult>& results) {
+    vector<pair<const BatchJob*, vector<const BatchResult*>>> groups;
+    map<string, size_t> ids;
+    for (const auto& result : results) {
+        const string key = result.job->instance + " " + result.job->settings_label();
+        if (const auto [it, inserted] = ids.emplace(key, groups.size()); inserted) groups.emplace_back(result.job, vector<const BatchResult*>());
+        groups[ids[key]].second.push_back(&result);
+    }
+    return groups;
+}
+
+} // namespace
+
+void BatchRunner::print_summary(const vector<BatchResult>& results, ostream& out) {
+    for (const auto& [job, group] : group_by_settings(results)) {
+        vector<double> values;
+        for (const auto* result : group) values.push_back(result->report.result);
+        const Indicators indicators = StatsInterface::calculate_statistical_indicators(values);
+        out << job->instance << "  " << job->settings_label() << fixed << setprecision(2)
+            << "  trials " << indicators.size << "  mean " << indicators.avg << "  std " << indicators.std
+            << "  min " << indicators.min << "  max " << indicators.max << "\n";
+    }
+}
+
+void BatchRunner::save_results(const vector<BatchResult>& results, const string& directory) {
+    StatsInterface::create_directories_if_not_exists(directory);
+
+    ofstream rows(directory + "/results.csv");
+    rows << "instance,settings,seed,result,worker,wall_seconds,cpu_seconds\n";
+    for (const auto& result : results) {
+        rows << result.job->instance << "," << result.job->settings_label() << "," << result.job->seed << ","
+             << fixed << setprecision(2) << result.report.result << "," << result.report.worker << ","
+             << setprecision(6) << result.report.wall_seconds << "," << result.report.cpu_seconds << "\n";
+    }
+
+    // The indicators of stats_for_multiple_trials, one row per instance and settings
+    ofstream summary(directory + "/summary.csv");
+    summary << "instance,settings,trials,mean,std,min,max,mean_wall_seconds\n";
+    for (const auto& [job, group] : group_by_settings(results)) {
+        vector<double> values;
+        double wall = 0.0;
+        for (const auto* result : group) {
+            values.push_back(result->report.result);
+            wall += result->report.wall_seconds;
+        }
+        const Indicators indicators = StatsInterface::calculate_statistical_indicators(values);
+        summary << job->instance << "," << job->settings_label() << "," << indicators.size << ","
+                << fixed << setprecision(2) << indicators.avg << "," << indicators.std << "," << indicators.min << ","
+                << indicators.max << "," << setprecision(6) << wall / static_cast<double>(group.size()) << "\n";
+    }
+}
@@ -0,0 +1,144 @@
+#include "best_station_table.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+const int BestStationTable::kMaxProbes = 16;
+
+void BestStationTable::resize(const int num_nodes, const int problem_size) {
+    if (problem_size > kMaxNodes) throw std::length_error("BestStationTable: too many nodes for 16-bit codes");
+    this->sparse_ = false;
+    this->num_nodes_ = num_nodes;
+    this->size_ = static_cast<size_t>(num_nodes) * (num_nodes + 1) / 2;
+    this->codes_ = std::make_unique<std::atomic<uint16_t>[]>(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        codes_[i].store(kUnknown, std::memory_order_relaxed);
+    }
+    row_offsets_.clear();
+    row_nodes_.clear();
+    row_stations_.reset();
+    lazy_keys_.reset();
+    lazy_stations_.reset();
+}
+
+void BestStationTable::resize_sparse(const int num_nodes, const std::vector<std::vector<int>>& neighbours, const size_t lazy_capacity) {
+    this->sparse_ = true;
+    this->num_nodes_ = num_nodes;
+    this->codes_.reset();
+
+    // Each arc is kept once, in the row of its smaller end; the row of the depot holds all its arcs
+    row_offsets_.assign(num_nodes + 1, 0);
+    row_nodes_.clear();
+    for (int lo = 0; lo < num_nodes; ++lo) {
+        const size_t begin = row_nodes_.size();
+        if (lo == 0) {
+            for (int hi = 1; hi < num_nodes; ++hi) row_nodes_.push_back(hi);
+        } else if (lo < static_cast<int>(neighbours.size())) {
+            for (const int hi : neighbours[lo]) {
+                if (hi > lo && hi < num_nodes) row_nodes_.push_back(hi);
+            }
+            std::sort(row_nodes_.begin() + static_cast<std::ptrdiff_t>(begin), row_nodes_.end());
+            row_nodes_.erase(std::unique(row_nodes_.begin() + static_cast<std::ptrdiff_t>(begin), row_nodes_.end()), row_nodes_.end());
+        }
+        row_offsets_[lo + 1] = row_nodes_.size();
+    }
+    row_nodes_.shrink_to_fit();
+    row_stations_ = std::make_unique<std::atomic<int32_t>[]>(row_nodes_.size());
+    for (size_t i = 0; i < row_nodes_.size(); ++i) {
+        row_stations_[i].store(kUnknownStation, std::memory_order_relaxed);
+    }
+
+    size_t slots = 1024;
+    while (slots < lazy_capacity) slots <<= 1;
+    lazy_mask_ = slots - 1;
+    lazy_keys_ = std::make_unique<std::atomic<uint64_t>[]>(slots);
+    lazy_stations_ = std::make_unique<std::atomic<int32_t>[]>(slots);
+    for (size_t i = 0; i < slots; ++i) {
+        lazy_keys_[i].store(0, std::memory_order_relaxed);
+        lazy_stations_[i].store(kUnknownStation, std::memory_order_relaxed);
+    }
+    this->size_ = row_nodes_.size() + slots;
+}
+
+std::atomic<int32_t>* BestStationTable::row_entry(const int lo, const int hi) const {
+    const auto first = row_nodes_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[lo]);
+    const auto last = row_nodes_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[lo + 1]);
+    const auto it = std::lower_bound(first, last, hi);
+    return it != last && *it == hi ? &row_stations_[it - row_nodes_.begin()] : nullptr;
+}
+
+int BestStationTable::sparse_station(const int from, const int to) const {
+    if (from == to) return 0;
+    const int lo = std::min(from, to);
+    const int hi = std::max(from, to);
+    if (const auto* entry = row_entry(lo, hi)) return entry->load(std::memory_order_relaxed);
+
+    const uint64_t key = lazy_key(lo, hi);
+    const size_t home = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+    for (int probe = 0; probe < kMaxProbes; ++probe) {
+        const size_t slot = (home + probe) & lazy_mask_;
+        const uint64_t slot_key = lazy_keys_[slot].load(std::memory_order_acquire);
+        if (slot_key == key) return lazy_stations_[slot].load(std::memory_order_relaxed);
+        if (slot_key == 0) break;
+    }
+    return kUnknownStation;
+}
+
+int BestStationTable::sparse_set(const int from, const int to, const int station) const {
+    if (from == to) return station;
+    const int lo = std::min(from, to);
+    const int hi = std::max(from, to);
+    if (auto* entry = row_entry(lo, hi)) {
+        entry->store(station, std::memory_order_relaxed);
+        return station;
+    }
+
+    // A slot is claimed by its key first; a reader that sees the key before the station computes the station itself
+    const uint64_t key = lazy_key(lo, hi);
+    const size_t home = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+    for (int probe = 0; probe < kMaxProbes; ++probe) {
+        const size_t slot = (home + probe) & lazy_mask_;
+        uint64_t slot_key = lazy_keys_[slot].load(std::memory_order_acquire);
+        if (slot_key == 0 && lazy_keys_[slot].compare_exchange_strong(slot_key, key, std::memory_order_acq_rel)) slot_key = key;
+        if (slot_key == key) {
+            lazy_stations_[slot].store(station, std::memory_order_relaxed);
+            return station;
+        }
+    }
+    return station;
+}
+
+size_t BestStationTable::bytes() const {
+    if (!sparse_) return size_ * sizeof(uint16_t);
+    const size_t slots = lazy_keys_ ? lazy_mask_ + 1 : 0;
+    return row_offsets_.size() * sizeof(size_t) + row_nodes_.size() * (sizeof(int) + sizeof(int32_t)) +
+           slots * (sizeof(uint64_t) + sizeof(int32_t));
+}
+
+size_t BestStationTable::num_known() const {
+    size_t known = 0;
+    if (sparse_) {
+        for (size_t i = 0; i < row_nodes_.size(); ++i) {
+            known += row_stations_[i].load(std::memory_order_relaxed) != kUnknownStation;
+        }
+        for (size_t i = 0; i <= lazy_mask_; ++i) {
+            known += lazy_stations_[i].load(std::memory_order_relaxed) != kUnknownStation;
+        }
+        return known;
+    }
+    for (size_t i = 0; i < size_; ++i) {
+        known += codes_[i].load(std::memory_order_relaxed) != kUnknown;
+    }
+    return known;
+}
+
+void BestStationTable::load(const uint16_t* codes) {
+    for (size_t i = 0; i < size_; ++i) {
+        codes_[i].store(codes[i], std::memory_order_relaxed);
+    }
+}
+
+void BestStationTable::store(uint16_t* codes) const {
+    for (size_t i = 0; i < size_; ++i) {
+        codes[i] = codes_[i].load(std::memory_order_relaxed);
+    }
+}
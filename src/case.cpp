@@ -3,119 +3,333 @@
 //
 
 #include "case.hpp"
+#include "mapped_file.hpp"
+#include "instance_cache.hpp"
+#include "parallel.hpp"
+#include "spatial_index.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+const size_t kCacheLineSize = 64;
+const size_t kHugePageSize = 2 * 1024 * 1024;
+const int kNearestCustomers = 32;             // minimum row length of the nearest customer cache
+
+const int kDistanceTile = 64;                 // rows and columns per tile of the symmetric matrix construction
+
+size_t round_up(const size_t value, const size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Distances from node `from` to the nodes [first, last), written to out[0, last - first). Branch-free over the
+// coordinate arrays so the compiler vectorizes it (see -fno-math-errno in CMakeLists.txt); dx * dx equals the
+// pow(dx, 2) of Case::euclidean_distance, and the result is rounded through distance_t like the matrix entries.
+template <typename T>
+void euclidean_row(const double* xs, const double* ys, const int from, const int first, const int last, T* out) {
+    const double x = xs[from];
+    const double y = ys[from];
+    for (int j = first; j < last; j++) {
+        const double dx = x - xs[j];
+        const double dy = y - ys[j];
+        out[j - first] = static_cast<distance_t>(std::sqrt(dx * dx + dy * dy));
+    }
+}
+
+// Position of the cell (x, y) along the Hilbert curve filling a kHilbertSide x kHilbertSide grid
+const uint32_t kHilbertSide = 1u << 16;
+
+uint64_t hilbert_index(uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = kHilbertSide / 2; s > 0; s /= 2) {
+        const uint32_t rx = (x & s) > 0;
+        const uint32_t ry = (y & s) > 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        // rotate the quadrant so that the curve stays continuous
+        if (ry == 0) {
+            if (rx == 1) {
+                x = kHilbertSide - 1 - x;
+                y = kHilbertSide - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+} // namespace
 
-Case::Case(const string& file_name) {
+Case::Case(const string& file_name) : Case(file_name, Parameters()) {
+
+}
+
+Case::Case(const string& file_name, const Parameters& params) {
     this->file_name_ = file_name;
     this->instance_name_ = file_name.substr(0, file_name.find('.'));
+    this->num_threads_ = params.build_threads;
 
+    PhaseTimer timer;
     this->read_problem(kDataPath + file_name);
+    timer.lap("parse");
+    if (params.renumber_nodes) {
+        this->renumber_nodes();
+        timer.lap("renumber");
+    }
+    this->build_coordinates();
+
+    // Above the threshold the matrix would not fit in memory: distances are computed on the fly and only the nearest
+    // customers of each customer are kept
+    if (problem_size_ > params.matrix_free_threshold) {
+        this->enable_matrix_free(params.nb_granular);
+        timer.lap("nearest customers");
+        this->startup_phases_ = timer.phases();
+        return;
+    }
+
+    this->allocate_distance_matrix(params.pad_distance_rows, params.enable_huge_pages);
+    InstanceCache cache;
+    if (params.enable_instance_cache && cache.open(*this, params.nb_granular)) {
+        for (int i = 0; i < problem_size_; i++) {
+            memcpy(distances_ + static_cast<size_t>(i) * distance_stride_, cache.distances() + static_cast<size_t>(i) * problem_size_, sizeof(distance_t) * problem_size_);
+        }
+        timer.lap("cached distances");
+    } else {
+        this->build_distance_matrix();
+        timer.lap("distances");
+    }
+    this->startup_phases_ = timer.phases();
 }
 
 
 Case::~Case() {
+    std::free(this->distances_);
+}
+
+void Case::read_problem(const std::string &file_path) {
+    // The whole file is mapped once and tokenized in place, no per-line copy is made
+    const MappedFile file(file_path);
+    if (!file.is_open()) {
+        cerr << "Error: Cannot open the problem file '" << file_path << "'" << endl;
+        return;
+    }
+    parse_problem(file.data(), file.end());
+
+    this->max_service_time_ = std::numeric_limits<double>::max();
+}
+
+void Case::allocate_distance_matrix(const bool pad_rows, const bool use_huge_pages) {
+    std::free(this->distances_);
+
+    // With padding, every row starts on a cache line, so row scans can use aligned SIMD loads
+    this->distance_stride_ = pad_rows ? static_cast<int>(round_up(problem_size_, kCacheLineSize / sizeof(distance_t))) : problem_size_;
+    size_t alignment = kCacheLineSize;
+#ifdef __linux__
+    if (use_huge_pages && sizeof(distance_t) * distance_stride_ * problem_size_ >= kHugePageSize) alignment = kHugePageSize;
+#endif
+    // aligned_alloc wants a size that is a multiple of the alignment
+    this->distance_bytes_ = round_up(sizeof(distance_t) * distance_stride_ * problem_size_, alignment);
+    this->distances_ = static_cast<distance_t*>(std::aligned_alloc(alignment, std::max(distance_bytes_, alignment)));
+    if (this->distances_ == nullptr) throw std::bad_alloc();
+#ifdef __linux__
+    // Backing the matrix with transparent huge pages removes most of the TLB misses of the random lookups
+    if (alignment == kHugePageSize) madvise(this->distances_, distance_bytes_, MADV_HUGEPAGE);
+#endif
+    std::fill_n(this->distances_, distance_bytes_ / sizeof(distance_t), distance_t{});
+}
+
+void Case::build_distance_matrix() {
+    if (this->distances_ == nullptr) allocate_distance_matrix(true, true);
+    if (static_cast<int>(coord_x_.size()) != problem_size_) build_coordinates();
+
+    // The matrix is symmetric: the task of a band of kDistanceTile rows computes its entries on and right of the
+    // diagonal, then mirrors them below the diagonal one kDistanceTile-wide column strip at a time. Bands write
+    // disjoint entries, so they run in parallel.
+    const int num_bands = (problem_size_ + kDistanceTile - 1) / kDistanceTile;
+    const size_t stride = distance_stride_;
+    parallel_for(0, num_bands, [&](const int band) {
+        const int row_begin = band * kDistanceTile;
+        const int row_end = std::min(row_begin + kDistanceTile, problem_size_);
+        for (int i = row_begin; i < row_end; i++) {
+            euclidean_row(coord_x_.data(), coord_y_.data(), i, i, problem_size_, distances_ + i * stride + i);
+        }
+        for (int j = row_begin + 1; j < problem_size_; j++) {
+            distance_t* column = distances_ + j * stride;
+            for (int i = row_begin; i < std::min(row_end, j); i++) {
+                column[i] = distances_[i * stride + j];
+            }
+        }
+    }, num_threads_);
+}
+
+void Case::renumber_nodes() {
+    // Nodes close in space get close ids, so the distances of a route sit in nearby rows and columns of distances_.
+    // Customers stay in [1, num_customer_] and stations after them; the depot keeps id 0.
+    double min_x = DBL_MAX, min_y = DBL_MAX, max_x = -DBL_MAX, max_y = -DBL_MAX;
+    for (const auto& [x, y] : positions_) {
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+    }
+    const double scale = (kHilbertSide - 1) / std::max({max_x - min_x, max_y - min_y, 1e-9});
+
+    vector<uint64_t> key(problem_size_);
     for (int i = 0; i < problem_size_; i++) {
-        delete[] this->distances_[i];
+        key[i] = hilbert_index(static_cast<uint32_t>((positions_[i].first - min_x) * scale),
+                               static_cast<uint32_t>((positions_[i].second - min_y) * scale));
     }
-    delete[] this->distances_;
+    this->original_ids_.resize(problem_size_);
+    std::iota(original_ids_.begin(), original_ids_.end(), 0);
+    auto by_key = [&](const int a, const int b) { return key[a] != key[b] ? key[a] < key[b] : a < b; };
+    std::sort(original_ids_.begin() + 1, original_ids_.begin() + num_customer_ + 1, by_key);
+    std::sort(original_ids_.begin() + num_customer_ + 1, original_ids_.end(), by_key);
+
+    vector<pair<double, double>> positions(problem_size_);
+    vector<int> demand(demand_.size());
+    for (int i = 0; i < problem_size_; i++) {
+        positions[i] = positions_[original_ids_[i]];
+        if (i < static_cast<int>(demand_.size())) demand[i] = demand_[original_ids_[i]];
+    }
+    this->positions_ = std::move(positions);
+    this->demand_ = std::move(demand);
 }
 
-void Case::read_problem(const std::string &file_path) {
+void Case::build_coordinates() {
+    this->coord_x_.resize(problem_size_);
+    this->coord_y_.resize(problem_size_);
+    for (int i = 0; i < problem_size_; i++) {
+        coord_x_[i] = positions_[i].first;
+        coord_y_[i] = positions_[i].second;
+    }
+}
+
+void Case::enable_matrix_free(const int nb_granular) {
+    this->matrix_free_ = true;
+    this->build_nearest_customers(std::max(kNearestCustomers, nb_granular));
+}
+
+void Case::build_nearest_customers(const int k) {
+    this->num_nearest_ = std::min(k, std::max(num_customer_ - 1, 0));
+    this->nearest_customers_.assign(static_cast<size_t>(num_customer_ + 1) * num_nearest_, 0);
+
+    vector<int> customers(num_customer_);
+    std::iota(customers.begin(), customers.end(), 1);
+    const SpatialIndex index(*this, customers);
+    parallel_for_blocks(1, num_customer_ + 1, kDistanceTile, [&](const int first, const int last) {
+        vector<int> nearest;
+        for (int i = first; i < last; i++) {
+            index.nearest(i, num_nearest_, nearest);
+            std::copy(nearest.begin(), nearest.end(), nearest_customers_.begin() + static_cast<ptrdiff_t>(i) * num_nearest_);
+        }
+    }, num_threads_);
+}
+
+void Case::distances_from(const int from, const int first, const int last, double* out) const {
+    if (matrix_free_) {
+        euclidean_row(coord_x_.data(), coord_y_.data(), from, first, last, out);
+        return;
+    }
+
+    const distance_t* row = distance_row(from);
+    for (int j = first; j < last; j++) {
+        out[j - first] = row[j];
+    }
+}
+
+void Case::parse_problem(const char* cur, const char* const end) {
     this->num_depot_ = 1;
 
-    // Helper lambda to extract values after a colon
-    auto extract_value = [&](const string& line) {
-        return line.substr(line.find(':') + 1);
+    // Helper lambdas working directly on the character buffer
+    auto is_blank = [](const char ch) { return ch == ' ' || ch == '\t' || ch == '\r'; };
+    auto skip_blanks = [&]() { while (cur < end && is_blank(*cur)) ++cur; };
+    auto skip_line = [&]() {
+        while (cur < end && *cur != '\n') ++cur;
+        if (cur < end) ++cur;
+    };
+    auto read_keyword = [&]() {
+        const char* first = cur;
+        while (cur < end && !is_blank(*cur) && *cur != ':' && *cur != '\n') ++cur;
+        return string_view(first, cur - first);
+    };
+    auto read_number = [&](auto& value) {
+        skip_blanks();
+        if (cur < end && *cur == '+') ++cur;
+        const auto [ptr, ec] = std::from_chars(cur, end, value);
+        cur = ptr;
+        return ec == std::errc();
+    };
+    auto read_value = [&](auto& value) {
+        skip_blanks();
+        if (cur < end && *cur == ':') ++cur;
+        read_number(value);
+        skip_line();
     };
 
-    ifstream infile(file_path);
-    string line;
+    while (cur < end) {
+        while (cur < end && (is_blank(*cur) || *cur == '\n')) ++cur;
+        const string_view keyword = read_keyword();
+        skip_blanks();
 
-    // Read file line by line
-    while (getline(infile, line)) {
-        stringstream ss;
-        if (line.find("DIMENSION:") != string::npos) {
-            ss << extract_value(line);
-            ss >> this->num_customer_;
+        if (keyword == "DIMENSION") {
+            read_value(this->num_customer_);
             this->num_customer_--;  // Adjusting the customer number
         }
-        else if (line.find("STATIONS:") != string::npos) {
-            ss << extract_value(line);
-            ss >> this->num_station_;
+        else if (keyword == "STATIONS") {
+            read_value(this->num_station_);
         }
-        else if (line.find("VEHICLES:") != string::npos) {
-            ss << extract_value(line);
-            ss >> this->num_vehicle_;
+        else if (keyword == "VEHICLES") {
+            read_value(this->num_vehicle_);
         }
-        else if (line.find("CAPACITY:") != string::npos && line.find("ENERGY") == string::npos) {
-            ss << extract_value(line);
-            ss >> this->max_vehicle_capa_;
+        else if (keyword == "CAPACITY") {
+            read_value(this->max_vehicle_capa_);
         }
-        else if (line.find("ENERGY_CAPACITY:") != string::npos) {
-            ss << extract_value(line);
-            ss >> this->max_battery_capa_;
+        else if (keyword == "ENERGY_CAPACITY") {
+            read_value(this->max_battery_capa_);
         }
-        else if (line.find("ENERGY_CONSUMPTION:") != string::npos) {
-            ss << extract_value(line);
-            ss >> this->energy_consumption_rate_;
+        else if (keyword == "ENERGY_CONSUMPTION") {
+            read_value(this->energy_consumption_rate_);
         }
-        else if (line.find("OPTIMAL_VALUE:") != string::npos) {
-            ss << extract_value(line);
-            ss >> this->optimum_;
+        else if (keyword == "OPTIMAL_VALUE") {
+            read_value(this->optimum_);
         }
-        else if (line.find("NODE_COORD_SECTION") != string::npos) {
+        else if (keyword == "NODE_COORD_SECTION") {
+            skip_line();
             this->problem_size_ = num_depot_ + num_customer_ + num_station_;
-            positions_.resize(problem_size_, {0, 0});
+            positions_.assign(problem_size_, {0, 0});
 
             // Reading coordinates
-            for (int i = 0; i < problem_size_; ++i) {
-                getline(infile, line);
-                ss.str(line);
-                int ind;
-                double x, y;
-                ss >> ind >> x >> y;
-                positions_[ind - 1] = {x, y};  // Set the position
+            for (int i = 0; i < problem_size_ && cur < end; ++i) {
+                int ind{};
+                double x{}, y{};
+                if (read_number(ind) && read_number(x) && read_number(y) && ind >= 1 && ind <= problem_size_) {
+                    positions_[ind - 1] = {x, y};  // Set the position
+                }
+                skip_line();
             }
         }
-        else if (line.find("DEMAND_SECTION") != string::npos) {
-            int total_number = num_depot_ + num_customer_;
-            demand_.resize(total_number, 0);
+        else if (keyword == "DEMAND_SECTION") {
+            skip_line();
+            const int total_number = num_depot_ + num_customer_;
+            demand_.assign(total_number, 0);
 
             // Reading demand_ values
-            for (int i = 0; i < total_number; ++i) {
-                getline(infile, line);
-                ss.clear();
-                ss.str(line);
-                int ind, c;
-                ss >> ind >> c;
-                demand_[ind - 1] = c;
-                if (c == 0) depot_ = ind - 1;  // Identify depot_
+            for (int i = 0; i < total_number && cur < end; ++i) {
+                int ind{}, c{};
+                if (read_number(ind) && read_number(c) && ind >= 1 && ind <= total_number) {
+                    demand_[ind - 1] = c;
+                    if (c == 0) depot_ = ind - 1;  // Identify depot_
+                }
+                skip_line();
             }
         }
-    }
-    infile.close();
-
-
-    this->max_service_time_ = std::numeric_limits<double>::max();
-    this->distances_ = generate_2D_matrix_double(problem_size_, problem_size_);
-    for (int i = 0; i < problem_size_; i++) {
-        for (int j = 0; j < problem_size_; j++) {
-            distances_[i][j] = euclidean_distance(i, j);
-        }
-    }
-}
-
-double **Case::generate_2D_matrix_double(int n, int m) {
-    auto **matrix = new double *[n];
-    for (int i = 0; i < n; i++) {
-        matrix[i] = new double[m];
-    }
-    //initialize the 2-d array
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < m; j++) {
-            matrix[i][j] = 0.0;
+        else {
+            skip_line();
         }
     }
-    return matrix;
 }
 
 double Case::euclidean_distance(const int i, const int j) const {
@@ -127,29 +341,17 @@ int Case::get_customer_demand_(const int customer) const {
     return demand_[customer];
 }
 
-double Case::get_distance(const int from, const int to) {
-    //adds partial evaluation to the overall fitness evaluation count
-    //It can be used when local search is used and a whole evaluation is not necessary
-    evals_ += (1.0 / problem_size_);
-
-    return distances_[from][to];
-}
-
-double Case::get_evals() const {
-    return evals_;
-}
-
 double Case::calculate_total_dist(const vector<vector<int>>& chromR) const {
     double tour_length = 0.0;
 
     for (const auto& route : chromR) {
         if (route.empty()) continue;
 
-        tour_length += distances_[depot_][route[0]];
+        tour_length += distance(depot_, route[0]);
         for (int j = 0; j < route.size() - 1; ++j) {
-            tour_length += distances_[route[j]][route[j + 1]];
+            tour_length += distance(route[j], route[j + 1]);
         }
-        tour_length += distances_[route.back()][depot_];
+        tour_length += distance(route.back(), depot_);
     }
 
     return tour_length;
@@ -159,7 +361,18 @@ double Case::calculate_total_dist_follower(int **routes, int num_routes, const i
     double tour_length = 0.0;
     for (int i = 0; i < num_routes; ++i) {
         for (int j = 0; j < num_nodes_per_route[i] - 1; ++j) {
-            tour_length += distances_[routes[i][j]][routes[i][j + 1]];
+            tour_length += distance(routes[i][j], routes[i][j + 1]);
+        }
+    }
+
+    return tour_length;
+}
+
+double Case::calculate_exact_dist_follower(int **routes, int num_routes, const int *num_nodes_per_route) const {
+    double tour_length = 0.0;
+    for (int i = 0; i < num_routes; ++i) {
+        for (int j = 0; j < num_nodes_per_route[i] - 1; ++j) {
+            tour_length += euclidean_distance(routes[i][j], routes[i][j + 1]);
         }
     }
 
@@ -176,23 +389,21 @@ int Case::calculate_demand_sum(const vector<int> &route) const {
 }
 
 // TODO: modify these two functions below for new Individual structure
-double Case::compute_total_distance(const vector<vector<int>> &routes) {
+double Case::compute_total_distance(const vector<vector<int>> &routes) const {
     double tour_length = 0.0;
     for (auto& route : routes) {
         for (int j = 0; j < route.size() - 1; ++j) {
-            tour_length += distances_[route[j]][route[j + 1]];
+            tour_length += distance(route[j], route[j + 1]);
         }
     }
 
-    evals_++;
-
     return tour_length;
 }
 
 double Case::compute_total_distance(const vector<int> &route) const {
     double tour_length = 0.0;
     for (int j = 0; j < route.size() - 1; ++j) {
-        tour_length += distances_[route[j]][route[j + 1]];
+        tour_length += distance(route[j], route[j + 1]);
     }
 
     return tour_length;
@@ -0,0 +1,141 @@
+#include "checkpoint.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace fs = std::filesystem;
+
+const uint32_t CheckpointFile::kVersion = 4;
+
+namespace {
+
+const char kMagic[8] = {'F', 'R', 'O', 'G', 'S', 'C', 'K', '\0'};
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t fingerprint;
+    uint64_t payload_size;
+    uint64_t checksum;
+};
+
+// 64-bit FNV-1a
+uint64_t checksum(const vector<char>& bytes) {
+    uint64_t hash = 14'695'981'039'346'656'037ULL;
+    for (const char byte : bytes) {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 1'099'511'628'211ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+bool CheckpointFile::write(const string& path, const uint64_t fingerprint, const vector<char>& payload) {
+    CheckpointHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(CheckpointHeader);
+    header.fingerprint = fingerprint;
+    header.payload_size = payload.size();
+    header.checksum = checksum(payload);
+
+    const string tmp_path = path + ".tmp" + to_string(std::random_device{}());
+    try {
+        if (const fs::path parent = fs::path(path).parent_path(); !parent.empty()) fs::create_directories(parent);
+
+        ofstream out(tmp_path, ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.data(), static_cast<streamsize>(payload.size()));
+        out.close();
+        if (!out) {
+            fs::remove(tmp_path);
+            return false;
+        }
+        fs::rename(tmp_path, path);
+    } catch (const std::exception&) {
+        std::error_code ignored;
+        fs::remove(tmp_path, ignored);
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointFile::read(const string& path, const uint64_t fingerprint, vector<char>& payload) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+
+    CheckpointHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.header_size != sizeof(CheckpointHeader) || header.fingerprint != fingerprint) {
+        return false;
+    }
+
+    std::error_code error;
+    const auto file_size = fs::file_size(path, error);
+    if (error || file_size != sizeof(CheckpointHeader) + header.payload_size) return false;
+    payload.resize(header.payload_size);
+    if (!in.read(payload.data(), static_cast<streamsize>(payload.size()))) return false;
+    return checksum(payload) == header.checksum;
+}
+
+AsyncCheckpointWriter::AsyncCheckpointWriter() : thread_(&AsyncCheckpointWriter::loop, this) {}
+
+AsyncCheckpointWriter::~AsyncCheckpointWriter() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void AsyncCheckpointWriter::submit(const string& path, const uint64_t fingerprint, vector<char> payload,
+                                   std::function<void()> barrier) {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        path_ = path;
+        fingerprint_ = fingerprint;
+        payload_ = std::move(payload);
+        barrier_ = std::move(barrier);
+        pending_ = true;
+    }
+    wake_.notify_one();
+}
+
+void AsyncCheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return !pending_ && !writing_; });
+}
+
+long AsyncCheckpointWriter::num_written() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+void AsyncCheckpointWriter::loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return pending_ || stopping_; });
+        if (!pending_) return;
+
+        // Write outside the lock, so that a submit never waits for the disk
+        const string path = std::move(path_);
+        const uint64_t fingerprint = fingerprint_;
+        const vector<char> payload = std::move(payload_);
+        const std::function<void()> barrier = std::move(barrier_);
+        barrier_ = nullptr;
+        pending_ = false;
+        writing_ = true;
+        lock.unlock();
+        if (barrier) barrier();
+        const bool ok = CheckpointFile::write(path, fingerprint, payload);
+        lock.lock();
+        writing_ = false;
+        written_ += ok;
+        idle_.notify_all();
+    }
+}
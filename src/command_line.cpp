@@ -22,18 +22,38 @@ CommandLine::CommandLine(const int argc, char* argv[]) {
     }
 }
 
+CommandLine::CommandLine(std::unordered_map<std::string, std::string> arguments) : arguments(std::move(arguments)) {}
+
 void CommandLine::parse_parameters(Parameters& params) const {
     try {
         params.algorithm = string_to_algorithm(get_string("alg", "Lahc"));
+        params.plan = get_string("plan", params.plan);
         params.instance = get_string("ins", params.instance);
         params.enable_logging = get_bool("log", params.enable_logging);
+        params.trace_interval = get_int("trace", params.trace_interval);
         params.stop_criteria = get_int("stp", params.stop_criteria);
+        params.time_limit = get_double("time_limit", params.time_limit);
         params.enable_multithreading = get_bool("mth", params.enable_multithreading);
         params.seed = get_int("seed", params.seed);
+        params.num_trials = get_int("trials", params.num_trials);
+        params.num_workers = get_int("workers", params.num_workers);
+        params.pin_workers = get_bool("pin", params.pin_workers);
+        params.cooperative = get_bool("coop", params.cooperative);
+        if (const std::string islands = get_string("islands", ""); !islands.empty()) params.topology = string_to_topology(islands);
+        params.migration_interval = get_int("migration_interval", params.migration_interval);
+        params.checkpoint_interval = get_int("checkpoint", params.checkpoint_interval);
+        params.resume = get_bool("resume", params.resume);
+        params.enable_instance_cache = get_bool("cache", params.enable_instance_cache);
+        params.pad_distance_rows = get_bool("pad_rows", params.pad_distance_rows);
+        params.enable_huge_pages = get_bool("huge_pages", params.enable_huge_pages);
+        params.matrix_free_threshold = get_int("matrix_free_threshold", params.matrix_free_threshold);
+        params.renumber_nodes = get_bool("renumber", params.renumber_nodes);
+        params.build_threads = get_int("build_threads", params.build_threads);
         params.nb_granular = get_int("nb_granular", params.nb_granular);
         params.is_hard_constraint = get_bool("is_hard_constraint", params.is_hard_constraint);
         params.is_duration_constraint = get_bool("is_duration_constraint", params.is_duration_constraint);
         params.history_length = get_int("history_length", params.history_length);
+        params.route_cache_size = get_int("route_cache", params.route_cache_size);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         display_help();
@@ -48,14 +68,32 @@ void CommandLine::display_help() {
               << "Options:\n"
               << "  -alg [enum]                  : Algorithm name (e.g., Cbma, Lahc)\n"
               << "  -ins [filename]              : Problem instance filename\n"
+              << "  -plan [filename]             : Batch plan of instances x seeds x parameter grids, run in one process\n"
               << "  -log [0|1]                   : Enable logging (default: 0)\n"
+              << "  -trace [int]                 : Write a binary trace row every n LAHC iterations, 0 for none (default: 0)\n"
               << "  -stp [0|1|2]                 : Stopping criteria, 0: max-evals, 1: max-time, 2: obj-converge (default: 0)\n"
+              << "  -time_limit [double]         : Time budget in seconds with -stp 1, 0 for the instance default (default: 0)\n"
               << "  -mth [0|1]                   : Enable multi-threading (default: 1)\n"
               << "  -seed [int]                  : Random seed (default: 0)\n"
+              << "  -trials [int]                : Number of trials with multi-threading (default: 10)\n"
+              << "  -workers [int]               : Threads running the trials or batch jobs, 0 for all cores (default: 0)\n"
+              << "  -pin [0|1]                   : Pin each trial thread to its own CPU, Linux only (default: 0)\n"
+              << "  -coop [0|1]                  : Trials share their best solution and restart from it (default: 0)\n"
+              << "  -islands [enum]              : Island model migration topology (none, ring, random) (default: none)\n"
+              << "  -migration_interval [int]    : LAHC iterations between two migrations of an island (default: 1000)\n"
+              << "  -checkpoint [int]            : Seconds between two checkpoints of each trial in ../checkpoints, 0 for none (default: 0)\n"
+              << "  -resume [0|1]                : Start each trial from its checkpoint if there is one (default: 0)\n"
+              << "  -cache [0|1]                 : Reuse the preprocessed instance tables cached in ../cache (default: 0)\n"
+              << "  -pad_rows [0|1]              : Pad the distance matrix rows to whole cache lines (default: 1)\n"
+              << "  -huge_pages [0|1]            : Back large distance matrices with huge pages, Linux only (default: 1)\n"
+              << "  -matrix_free_threshold [int] : Compute distances on the fly above this many nodes (default: 20000)\n"
+              << "  -renumber [0|1]              : Renumber the nodes along a Hilbert curve for cache locality (default: 0)\n"
+              << "  -build_threads [int]         : Threads building the instance tables, 0 for all cores (default: 0)\n"
               << "  -nb_granular [int]           : Granular search parameter (default: 20)\n"
               << "  -is_hard_constraint [0|1]    : Whether to use hard constraint (default: 1)\n"
               << "  -is_duration_constraint [0|1]: Whether to consider duration constraint (default: 0)\n"
-              << "  -history_length [int]        : LAHC history length (default: 5000)\n";
+              << "  -history_length [int]        : LAHC history length (default: 5000)\n"
+              << "  -route_cache [int]           : Routes whose charging decisions are cached, 0 for none (default: 16384)\n";
     std::cout << "-------------------------------------------------------------------------------------------------------------------------------" << std::endl;
 }
 
@@ -116,3 +154,14 @@ Algorithm CommandLine::string_to_algorithm(const std::string& algo_str) {
     std::cerr << "Warning: Unknown algorithm '" << algo_str << "', defaulting to Lahc.\n";
     return Algorithm::LAHC; // Default to Lahc if input is invalid
 }
+
+Topology CommandLine::string_to_topology(const std::string& topology_str) {
+    const std::string lower_topology = to_lowercase(topology_str);
+
+    if (lower_topology == "none") return Topology::NONE;
+    if (lower_topology == "ring") return Topology::RING;
+    if (lower_topology == "random") return Topology::RANDOM;
+
+    std::cerr << "Warning: Unknown topology '" << topology_str << "', defaulting to none.\n";
+    return Topology::NONE;
+}
@@ -0,0 +1,41 @@
+#include "deadline.hpp"
+#include <chrono>
+#include <csignal>
+#include <ctime>
+
+namespace {
+
+std::atomic<CancellationToken*> signal_token{nullptr};
+
+extern "C" void cancel_signal_token(int) {
+    if (CancellationToken* token = signal_token.load(std::memory_order_relaxed)) token->cancel();
+}
+
+} // namespace
+
+void cancel_on_signals(CancellationToken* token) {
+    signal_token.store(token, std::memory_order_relaxed);
+    const auto handler = token != nullptr ? cancel_signal_token : SIG_DFL;
+    std::signal(SIGINT, handler);
+    std::signal(SIGTERM, handler);
+}
+
+double coarse_seconds() {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+Deadline::Deadline(const double seconds, const CancellationToken* token) {
+    this->end_ = seconds == std::numeric_limits<double>::infinity() ? seconds : coarse_seconds() + seconds;
+    this->token_ = token;
+}
+
+double Deadline::remaining() const {
+    if (end_ == std::numeric_limits<double>::infinity()) return end_;
+    return end_ - coarse_seconds();
+}
@@ -0,0 +1,29 @@
+#include "evaluation_budget.hpp"
+#include <cmath>
+
+EvaluationBudget::EvaluationBudget(const int lookups_per_evaluation, const double max_evals) {
+    this->lookups_per_evaluation_ = lookups_per_evaluation > 0 ? lookups_per_evaluation : 1;
+    this->max_lookups_ = static_cast<uint64_t>(std::ceil(max_evals * static_cast<double>(lookups_per_evaluation_)));
+}
+
+EvaluationCounter& EvaluationBudget::add_counter() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return counters_.emplace_back();
+}
+
+uint64_t EvaluationBudget::lookups() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t total = 0;
+    for (const auto& counter : counters_) {
+        total += counter.lookups();
+    }
+    return total;
+}
+
+double EvaluationBudget::evaluations() const {
+    return static_cast<double>(lookups()) / static_cast<double>(lookups_per_evaluation_);
+}
+
+bool EvaluationBudget::exhausted() const {
+    return lookups() >= max_lookups_;
+}
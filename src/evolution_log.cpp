@@ -0,0 +1,105 @@
+#include "evolution_log.hpp"
+#include <algorithm>
+#include <filesystem>
+
+const size_t EvolutionLog::kCapacity = 4096;
+const double EvolutionLog::kFlushInterval = 1.0;
+
+EvolutionLog::EvolutionLog(const string& path, const string& header, const size_t capacity, const double flush_interval,
+                           const long resume_rows)
+    : rows_(capacity), flush_interval_(flush_interval) {
+    if (resume_rows >= 0 && std::filesystem::exists(path)) {
+        // Rows written after the checkpoint are dropped, the resumed run writes them again
+        long kept = -1;                         // the header is not a row
+        std::streamoff size = 0;
+        {
+            ifstream in(path, std::ios::binary);
+            string line;
+            while (kept < resume_rows && std::getline(in, line) && !in.eof()) {
+                size += static_cast<std::streamoff>(line.size()) + 1;
+                ++kept;
+            }
+        }
+        std::filesystem::resize_file(path, static_cast<uintmax_t>(size));
+        file_.open(path, std::ios::app);
+        if (kept < 0) file_ << header << "\n" << std::flush;
+        appended_.store(std::max(kept, 0L), std::memory_order_relaxed);
+        written_.store(std::max(kept, 0L), std::memory_order_relaxed);
+    } else {
+        file_.open(path);
+        file_ << header << "\n" << std::flush;
+    }
+    thread_ = std::thread(&EvolutionLog::loop, this);
+}
+
+EvolutionLog::~EvolutionLog() {
+    close();
+}
+
+bool EvolutionLog::append(EvolutionRow row) {
+    if (!rows_.try_push(row)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Wake the writer early when half of the buffer is used; notify_one does not take the mutex
+    const long pending = appended_.fetch_add(1, std::memory_order_relaxed) + 1 - written_.load(std::memory_order_relaxed);
+    if (pending >= static_cast<long>(rows_.capacity() / 2)) {
+        wake_requested_.store(true, std::memory_order_relaxed);
+        wake_.notify_one();
+    }
+    return true;
+}
+
+void EvolutionLog::wait_written(const long rows) {
+    // The writer notifies after every drain, and its last drain writes every row appended before close()
+    std::unique_lock<std::mutex> lock(mutex_);
+    synced_.wait(lock, [this, rows] {
+        return written_.load(std::memory_order_acquire) >= rows || stopped_;
+    });
+}
+
+void EvolutionLog::close() {
+    if (!thread_.joinable()) return;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stopping_.store(true, std::memory_order_relaxed);
+    }
+    wake_.notify_one();
+    thread_.join();
+    file_.close();
+}
+
+void EvolutionLog::loop() {
+    const auto interval = std::chrono::duration<double>(flush_interval_);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, interval, [this] {
+                return stopping_.load(std::memory_order_relaxed) || wake_requested_.load(std::memory_order_relaxed);
+            });
+            wake_requested_.store(false, std::memory_order_relaxed);
+        }
+        // Rows appended before close() are in the buffer by now, so the last drain writes all of them
+        const bool stopping = stopping_.load(std::memory_order_relaxed);
+        drain();
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = stopping;
+        }
+        synced_.notify_all();
+        if (stopping) return;
+    }
+}
+
+void EvolutionLog::drain() {
+    long count = 0;
+    while (auto row = rows_.try_pop()) {
+        file_ << row->iter << "," << row->global_best << "," << row->history.min << "," << row->history.max << ","
+              << row->history.avg << "," << row->history.std << "\n";
+        ++count;
+    }
+    if (count > 0) {
+        file_.flush();
+        written_.fetch_add(count, std::memory_order_release);
+    }
+}
@@ -3,8 +3,11 @@
 //
 
 #include "follower.hpp"
+#include "evaluation_budget.hpp"
+#include <cmath>
+#include <limits>
 
-Follower::Follower(Case* instance, Preprocessor* preprocessor) {
+Follower::Follower(const Case* instance, const Preprocessor* preprocessor) {
     this->instance = instance;
     this->preprocessor = preprocessor;
 
@@ -20,6 +23,11 @@ Follower::Follower(Case* instance, Preprocessor* preprocessor) {
     this->lower_num_nodes_per_route = new int [route_cap];
     memset(this->lower_num_nodes_per_route, 0, sizeof(int) * route_cap);
     this->lower_cost = 0;
+    this->route_cache.resize(preprocessor->params.route_cache_size);
+    this->route_key.reserve(node_cap);
+    this->scratch.reserve(node_cap);
+    this->route_costs.assign(route_cap, 0.0);
+    this->route_lookups.assign(route_cap, 0);
 }
 
 Follower::~Follower() {
@@ -30,8 +38,27 @@ Follower::~Follower() {
     delete[] this->lower_num_nodes_per_route;
 }
 
+void FollowerScratch::reserve(const int node_cap) {
+    route.reserve(node_cap);
+    accumulated_distance.reserve(node_cap);
+    arc_station.reserve(node_cap);
+    chosen_pos.reserve(node_cap);
+    best_chosen_pos.reserve(node_cap);
+    chosen_sta.reserve(node_cap);
+    inserted.reserve(node_cap);
+    candidates_by_saving.reserve(node_cap);
+    states.reserve(node_cap + 1);
+    best.chosen_pos.reserve(node_cap);
+    best.chosen_sta.reserve(node_cap);
+    labels.reserve(4 * node_cap);
+    candidates.reserve(node_cap);
+    front.reserve(node_cap);
+    stations.reserve(node_cap);
+}
+
 void Follower::refine(Individual* ind) {
     load_individual(ind);
+    synced = nullptr;
 
     lower_cost = 0.0;
     for (int i = 0; i < num_routes; ++i) {
@@ -41,25 +68,106 @@ void Follower::refine(Individual* ind) {
     export_individual(ind);
 }
 
+void Follower::optimise(Individual* ind) {
+    load_individual(ind);
+    synced = nullptr;
+
+    lower_cost = 0.0;
+    for (int i = 0; i < num_routes; ++i) {
+        const double cost = insert_station_by_dp(lower_routes[i], lower_num_nodes_per_route[i]);
+        lower_cost += cost == -1 ? INFEASIBLE : cost;
+    }
+
+    export_individual(ind);
+}
+
 void Follower::run(Individual *ind) {
     load_individual(ind);
 
     for (int i = 0; i < num_routes; ++i) {
-        double cost_SE = insert_station_by_simple_enum( lower_routes[i], lower_num_nodes_per_route[i]);
+        route_costs[i] = repair_route(i);
+        lower_cost += route_costs[i];
+    }
 
-        if (cost_SE == -1) {
-            double cost_RE = insert_station_by_remove_enum( lower_routes[i], lower_num_nodes_per_route[i]);
-            if (cost_RE == -1) {
-                lower_cost += INFEASIBLE;
-            } else {
-                lower_cost += cost_RE;
-            }
+    synced = ind;
+    export_individual(ind);
+}
+
+void Follower::run(Individual* ind, const DirtyRoutes& dirty) {
+    if (dirty.all() || synced != ind) {
+        run(ind);
+        return;
+    }
+
+    // Only the routes the leader changed are loaded and repaired again, the others are as the last run left them
+    const uint64_t lookups_before = num_lookups;
+    const int new_num_routes = ind->upper_cost.nb_routes;
+    for (const int i : dirty.ids()) {
+        if (i >= new_num_routes) continue;
+        const int length = static_cast<int>(ind->chromR[i].size()) + 2;
+        memset(lower_routes[i], 0, sizeof(int) * std::max(length, lower_num_nodes_per_route[i]));
+        memcpy(&lower_routes[i][1], ind->chromR[i].data(), ind->chromR[i].size() * sizeof(int));
+        lower_num_nodes_per_route[i] = length;
+        route_costs[i] = repair_route(i);
+    }
+    for (int i = new_num_routes; i < num_routes; ++i) {
+        memset(lower_routes[i], 0, sizeof(int) * lower_num_nodes_per_route[i]);
+        lower_num_nodes_per_route[i] = 0;
+        route_costs[i] = 0.0;
+        route_lookups[i] = 0;
+    }
+    num_routes = new_num_routes;
+
+    // Summed in route order as in the full run, so that both give the same lower cost to the last bit. The lookups of
+    // the unchanged routes are charged again, as with the route cache, so that the evaluation budget is the same too.
+    lower_cost = 0.0;
+    uint64_t lookups = 0;
+    for (int i = 0; i < num_routes; ++i) {
+        lower_cost += route_costs[i];
+        lookups += route_lookups[i];
+    }
+    num_lookups = lookups_before + lookups;
+
+    export_individual(ind);
+}
+
+double Follower::repair_route(const int i) {
+    // A route met before gets the same repair, and is charged the lookups the repair took, so that the evaluation
+    // budget and the search are the same as without the cache
+    uint64_t hash = 0;
+    if (route_cache.enabled()) {
+        hash = RouteCache::hash(lower_routes[i], lower_num_nodes_per_route[i]);
+        if (const RouteCache::Entry* entry = route_cache.find(hash, lower_routes[i], lower_num_nodes_per_route[i])) {
+            memcpy(lower_routes[i], entry->repaired(), sizeof(int) * entry->repaired_length);
+            lower_num_nodes_per_route[i] = entry->repaired_length;
+            num_lookups += entry->lookups;
+            route_lookups[i] = entry->lookups;
+            return entry->cost;
+        }
+        route_key.assign(lower_routes[i], lower_routes[i] + lower_num_nodes_per_route[i]);
+    }
+    const uint64_t lookups_before = num_lookups;
+
+    double route_cost;
+    double cost_SE = insert_station_by_simple_enum( lower_routes[i], lower_num_nodes_per_route[i]);
+
+    if (cost_SE == -1) {
+        double cost_RE = insert_station_by_remove_enum( lower_routes[i], lower_num_nodes_per_route[i]);
+        if (cost_RE == -1) {
+            route_cost = INFEASIBLE;
         } else {
-            lower_cost += cost_SE;
+            route_cost = cost_RE;
         }
+    } else {
+        route_cost = cost_SE;
     }
 
-    export_individual(ind);
+    route_lookups[i] = num_lookups - lookups_before;
+    if (route_cache.enabled()) {
+        route_cache.insert(hash, route_key.data(), static_cast<int>(route_key.size()), lower_routes[i],
+                           lower_num_nodes_per_route[i], route_cost, route_lookups[i]);
+    }
+    return route_cost;
 }
 
 void Follower::load_individual(const Individual* ind) {
@@ -86,35 +194,42 @@ void Follower::export_individual(Individual* ind) const {
 
 double Follower::insert_station_by_simple_enum(int* repaired_route, int& repaired_length) {
     const int length = repaired_length;
-    int* route = new int[length];
-    memcpy(route, repaired_route, sizeof(int) * length);
+    scratch.route.assign(repaired_route, repaired_route + length);
+    int* route = scratch.route.data();
 
-    vector<double> accumulated_distance(length, 0);
+    vector<double>& accumulated_distance = scratch.accumulated_distance;
+    accumulated_distance.assign(length, 0);
     for (int i = 1; i < length; i++) {
-        accumulated_distance[i] = accumulated_distance[i - 1] + instance->get_distance(route[i], route[i - 1]);
+        accumulated_distance[i] = accumulated_distance[i - 1] + metered_distance(route[i], route[i - 1]);
     }
     if (accumulated_distance.back() <= preprocessor->max_cruise_distance_) {
-        delete[] route;
         return accumulated_distance.back();
     }
 
+    // Best station of each arc of the route, looked up once instead of at every step of the enumeration
+    vector<int>& arc_station = scratch.arc_station;
+    arc_station.resize(length - 1);
+    for (int i = 0; i < length - 1; i++) {
+        arc_station[i] = preprocessor->best_station(route[i], route[i + 1]);
+    }
+
     int upper_bound = (int)(accumulated_distance.back() / preprocessor->max_cruise_distance_ + 1);
     int lower_bound = (int)(accumulated_distance.back() / preprocessor->max_cruise_distance_);
-    int* chosen_pos = new int[length];
-    int* best_chosen_pos = new int[length]; // customized variable
+    scratch.chosen_pos.resize(length);
+    scratch.best_chosen_pos.resize(length);
+    int* chosen_pos = scratch.chosen_pos.data();
+    int* best_chosen_pos = scratch.best_chosen_pos.data(); // customized variable
     double final_cost = numeric_limits<double>::max();
     double best_cost = final_cost; // customized variable
     for (int i = lower_bound; i <= upper_bound; i++) {
-        recursive_charging_placement(0, i, chosen_pos, best_chosen_pos, final_cost, i, route, length, accumulated_distance);
+        recursive_charging_placement(0, i, chosen_pos, best_chosen_pos, final_cost, i, route, length, accumulated_distance, arc_station);
 
         if (final_cost < best_cost) {
             memset(repaired_route, 0, sizeof(int) * repaired_length);
             int currentIndex = 0;
             int idx = 0;
             for (int j = 0; j < i; ++j) {
-                int from = route[best_chosen_pos[j]];
-                int to = route[best_chosen_pos[j] + 1];
-                int station = preprocessor->best_station_[from][to];
+                int station = arc_station[best_chosen_pos[j]];
 
                 int numElementsToCopy = best_chosen_pos[j] + 1 - idx;
                 memcpy(&repaired_route[currentIndex], &route[idx], numElementsToCopy * sizeof(int));
@@ -132,128 +247,142 @@ double Follower::insert_station_by_simple_enum(int* repaired_route, int& repaire
             best_cost = final_cost;
         }
     }
-    delete[] chosen_pos;
-    delete[] best_chosen_pos;
-    delete[] route;
     return (final_cost != std::numeric_limits<double>::max()) ? final_cost : -1;
 }
 
 double Follower::insert_station_by_remove_enum(int* repaired_route, int& repaired_length) const {
     const int length = repaired_length;
-    int* route = new int [length];
-    memcpy(route, repaired_route, sizeof(int) * length);
-
-    list<pair<int, int>> stationInserted;
-    for (int i = 0; i < length - 1; i++) {
-        double allowedDis = preprocessor->max_cruise_distance_;
+    scratch.route.assign(repaired_route, repaired_route + length);
+    const int* route = scratch.route.data();
+    const double max_range = preprocessor->max_cruise_distance_;
+
+    // A station on every arc, each the best one the battery left by the previous station can reach; station i is on
+    // arc i, and the stations left form a list linked through prev and next
+    const int n = length - 1;
+    vector<InsertedStation>& inserted = scratch.inserted;
+    inserted.clear();
+    for (int i = 0; i < n; i++) {
+        double allowedDis = max_range;
         if (i != 0) {
-            allowedDis = preprocessor->max_cruise_distance_ - instance->get_distance(stationInserted.back().second, route[i]);
+            inserted.back().tail = metered_distance(inserted.back().station, route[i]);
+            allowedDis = max_range - inserted.back().tail;
         }
         int onestation = preprocessor->get_best_and_feasible_station(route[i], route[i + 1], allowedDis);
         if (onestation == -1) {
-            delete[] route;
             return -1;
         }
-        stationInserted.emplace_back(i, onestation);
-    }
-    while (!stationInserted.empty())
-    {
-        bool change = false;
-        auto delone = stationInserted.begin();
-        double savedis = 0;
-        auto itr = stationInserted.begin();
-        auto next = itr;
-        next++;
-        if (next != stationInserted.end()) {
-            int endInd = next->first;
-            int endstation = next->second;
-            double sumdis = 0;
-            for (int i = 0; i < endInd; i++) {
-                sumdis += instance->get_distance(route[i], route[i + 1]);
-            }
-            sumdis += instance->get_distance(route[endInd], endstation);
-            if (sumdis <= preprocessor->max_cruise_distance_) {
-                savedis = instance->get_distance(route[itr->first], itr->second)
-                          + instance->get_distance(itr->second, route[itr->first + 1])
-                          - instance->get_distance(route[itr->first], route[itr->first + 1]);
+        inserted.push_back({i, onestation});
+    }
+    inserted.back().tail = instance->distance(inserted.back().station, route[n]);
+
+    // accumulated_distance[i]: distance from the depot to route[i], without stations
+    vector<double>& accumulated_distance = scratch.accumulated_distance;
+    accumulated_distance.assign(length, 0);
+    for (int i = 0; i < n; i++) {
+        accumulated_distance[i + 1] = accumulated_distance[i] + instance->distance(route[i], route[i + 1]);
+    }
+
+    // Station i can be removed if the battery covers the stretch from the previous station (or the depot) to the next
+    // one (or the depot) without it. From the depot the stretch is a prefix sum, as when it was summed arc by arc. From
+    // a station the difference of two prefix sums can round differently from that sum, by less than tolerance, so a
+    // stretch that close to max_range is summed arc by arc again and the decision is the same as before.
+    const double tolerance = 4.0 * length * numeric_limits<double>::epsilon() * (accumulated_distance[n] + max_range);
+    auto removable = [&](const int i) {
+        const InsertedStation& e = inserted[i];
+        const int startInd = e.prev >= 0 ? inserted[e.prev].pos + 1 : 0;
+        const int endInd = e.next < n ? inserted[e.next].pos : n;
+        double sumdis = e.prev >= 0 ? inserted[e.prev].tail + (accumulated_distance[endInd] - accumulated_distance[startInd])
+                                    : accumulated_distance[endInd];
+        if (e.prev >= 0 && std::abs(sumdis + (e.next < n ? inserted[e.next].head : 0.0) - max_range) <= tolerance) {
+            sumdis = inserted[e.prev].tail;
+            for (int j = startInd; j < endInd; j++) {
+                sumdis += instance->distance(route[j], route[j + 1]);
             }
         }
-        else {
-            double sumdis = 0;
-            for (int i = 0; i < length - 1; i++) {
-                sumdis += instance->get_distance(route[i], route[i + 1]);
-            }
-            if (sumdis <= preprocessor->max_cruise_distance_) {
-                savedis = instance->get_distance(route[itr->first], itr->second)
-                          + instance->get_distance(itr->second, route[itr->first + 1])
-                          - instance->get_distance(route[itr->first], route[itr->first + 1]);
-            }
+        if (e.next < n) sumdis += inserted[e.next].head;
+        return sumdis <= max_range;
+    };
+
+    // Removable stations in a max-heap by saving, ties to the first on the route. Removing a station only changes
+    // whether its two neighbours are removable; an entry that stopped being removable is dropped when it comes on top
+    // and pushed again if its station becomes removable later.
+    vector<InsertedStation::Candidate>& heap = scratch.candidates_by_saving;
+    heap.clear();
+    int num_removable = 0;
+    for (int i = 0; i < n; i++) {
+        InsertedStation& e = inserted[i];
+        e.prev = i - 1;
+        e.next = i + 1;
+        e.head = instance->distance(route[i], e.station);
+        e.saving = e.head + e.tail - instance->distance(route[i], route[i + 1]);
+    }
+    for (int i = 0; i < n; i++) {
+        inserted[i].removable = inserted[i].queued = removable(i);
+        if (inserted[i].removable) {
+            heap.push_back({inserted[i].saving, i});
+            num_removable++;
         }
-        itr++;
-        while (itr != stationInserted.end())
-        {
-            int startInd, endInd;
-            next = itr;
-            next++;
-            auto prev = itr;
-            prev--;
-            double sumdis = 0;
-            if (next != stationInserted.end()) {
-                startInd = prev->first + 1;
-                endInd = next->first;
-                sumdis += instance->get_distance(prev->second, route[startInd]);
-                for (int i = startInd; i < endInd; i++) {
-                    sumdis += instance->get_distance(route[i], route[i + 1]);
-                }
-                sumdis += instance->get_distance(route[endInd], next->second);
-                if (sumdis <= preprocessor->max_cruise_distance_) {
-                    double savedistemp = instance->get_distance(route[itr->first], itr->second)
-                                         + instance->get_distance(itr->second, route[itr->first + 1])
-                                         - instance->get_distance(route[itr->first], route[itr->first + 1]);
-                    if (savedistemp > savedis) {
-                        savedis = savedistemp;
-                        delone = itr;
-                    }
-                }
-            }
-            else {
-                startInd = prev->first + 1;
-                sumdis += instance->get_distance(prev->second, route[startInd]);
-                for (int i = startInd; i < length - 1; i++) {
-                    sumdis += instance->get_distance(route[i], route[i + 1]);
-                }
-                if (sumdis <= preprocessor->max_cruise_distance_) {
-                    double savedistemp = instance->get_distance(route[itr->first], itr->second)
-                                         + instance->get_distance(itr->second, route[itr->first + 1])
-                                         - instance->get_distance(route[itr->first], route[itr->first + 1]);
-                    if (savedistemp > savedis) {
-                        savedis = savedistemp;
-                        delone = itr;
-                    }
-                }
-            }
-            itr++;
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    // Remove, one per round, the removable station saving the most distance, as long as it saves some: the first
+    // station is taken even at a negative saving, the others need a positive one. A round takes O(log k) instead of
+    // summing every stretch again, and is charged by RepairCostModel::remove_enum_round.
+    int first = 0;
+    int last = n - 1;
+    uint64_t lookups = 0;
+    for (int k = n; k > 0; k--) {
+        lookups += RepairCostModel::remove_enum_round(n, inserted[first].pos, inserted[last].pos, k, num_removable);
+
+        while (!heap.empty() && !inserted[heap.front().station].removable) {
+            inserted[heap.front().station].queued = false;
+            std::pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
         }
-        if (savedis != 0) {
-            stationInserted.erase(delone);
-            change = true;
+        if (heap.empty()) {
+            break;
         }
-        if (!change) {
+        const double savedis = heap.front().saving;
+        if (inserted[first].removable ? savedis == 0 : savedis <= 0) {
             break;
         }
+        const int delone = heap.front().station;
+        std::pop_heap(heap.begin(), heap.end());
+        heap.pop_back();
+
+        // Unlink it, then update its neighbours
+        InsertedStation& e = inserted[delone];
+        e.removable = e.queued = false;
+        num_removable--;
+        if (e.prev >= 0) inserted[e.prev].next = e.next; else first = e.next;
+        if (e.next < n) inserted[e.next].prev = e.prev; else last = e.prev;
+        for (const int neighbour : {e.prev, e.next}) {
+            if (neighbour < 0 || neighbour >= n) continue;
+            InsertedStation& f = inserted[neighbour];
+            const bool was_removable = f.removable;
+            f.removable = removable(neighbour);
+            num_removable += static_cast<int>(f.removable) - static_cast<int>(was_removable);
+            if (f.removable && !f.queued) {
+                f.queued = true;
+                heap.push_back({f.saving, neighbour});
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
     }
+    num_lookups += lookups;
+
     double sum = 0;
     for (int i = 0; i < length - 1; i++) {
-        sum += instance->get_distance(route[i], route[i + 1]);
+        sum += metered_distance(route[i], route[i + 1]);
     }
     int currentIndex = 0;
     int idx = 0;
-    for (auto& e : stationInserted) {
-        int pos = e.first;
-        int stat = e.second;
-        sum -= instance->get_distance(route[pos], route[pos + 1]);
-        sum += instance->get_distance(route[pos], stat);
-        sum += instance->get_distance(stat, route[pos + 1]);
+    for (int i = first; i >= 0 && i < n; i = inserted[i].next) {
+        int pos = inserted[i].pos;
+        int stat = inserted[i].station;
+        sum -= metered_distance(route[pos], route[pos + 1]);
+        sum += metered_distance(route[pos], stat);
+        sum += metered_distance(stat, route[pos + 1]);
 
         int numElementsToCopy = pos + 1 - idx;
         memcpy(&repaired_route[currentIndex], &route[idx], numElementsToCopy * sizeof(int));
@@ -267,28 +396,27 @@ double Follower::insert_station_by_remove_enum(int* repaired_route, int& repaire
     memcpy(&repaired_route[currentIndex], &route[idx], remainingElementsToCopy * sizeof(int));
     repaired_length = currentIndex + remainingElementsToCopy;
 
-    delete[] route;
     return sum;
 }
 
-void Follower::recursive_charging_placement(int m_len, int n_len, int* chosen_pos, int* best_chosen_pos, double& final_cost, int cur_upper_bound, int* route, int length, vector<double>& accumulated_distance) {
+void Follower::recursive_charging_placement(int m_len, int n_len, int* chosen_pos, int* best_chosen_pos, double& final_cost, int cur_upper_bound, int* route, int length, vector<double>& accumulated_distance, const vector<int>& arc_station) {
     for (int i = m_len; i <= length - 1 - n_len; i++) {
         if (cur_upper_bound == n_len) {
-            double one_dis = instance->get_distance(route[i], preprocessor->best_station_[route[i]][route[i + 1]]);
+            double one_dis = metered_distance(route[i], arc_station[i]);
             if (accumulated_distance[i] + one_dis > preprocessor->max_cruise_distance_) {
                 break;
             }
         }
         else {
             int last_pos = chosen_pos[cur_upper_bound - n_len - 1];
-            double one_dis = instance->get_distance(route[last_pos + 1], preprocessor->best_station_[route[last_pos]][route[last_pos + 1]]);
-            double two_dis = instance->get_distance(route[i], preprocessor->best_station_[route[i]][route[i + 1]]);
+            double one_dis = metered_distance(route[last_pos + 1], arc_station[last_pos]);
+            double two_dis = metered_distance(route[i], arc_station[i]);
             if (accumulated_distance[i] - accumulated_distance[last_pos + 1] + one_dis + two_dis > preprocessor->max_cruise_distance_) {
                 break;
             }
         }
         if (n_len == 1) {
-            double one_dis = accumulated_distance.back() - accumulated_distance[i + 1] + instance->get_distance(preprocessor->best_station_[route[i]][route[i + 1]], route[i + 1]);
+            double one_dis = accumulated_distance.back() - accumulated_distance[i + 1] + metered_distance(arc_station[i], route[i + 1]);
             if (one_dis > preprocessor->max_cruise_distance_) {
                 continue;
             }
@@ -296,17 +424,17 @@ void Follower::recursive_charging_placement(int m_len, int n_len, int* chosen_po
 
         chosen_pos[cur_upper_bound - n_len] = i;
         if (n_len > 1) {
-            recursive_charging_placement(i + 1, n_len - 1, chosen_pos,  best_chosen_pos, final_cost, cur_upper_bound, route, length, accumulated_distance);
+            recursive_charging_placement(i + 1, n_len - 1, chosen_pos,  best_chosen_pos, final_cost, cur_upper_bound, route, length, accumulated_distance, arc_station);
         }
         else {
             double dis_sum = accumulated_distance.back();
             for (int j = 0; j < cur_upper_bound; j++) {
                 int first_node = route[chosen_pos[j]];
                 int second_node = route[chosen_pos[j] + 1];
-                int the_station = preprocessor->best_station_[first_node][second_node];
-                dis_sum -= instance->get_distance(first_node, second_node);
-                dis_sum += instance->get_distance(first_node, the_station);
-                dis_sum += instance->get_distance(second_node, the_station);
+                int the_station = arc_station[chosen_pos[j]];
+                dis_sum -= metered_distance(first_node, second_node);
+                dis_sum += metered_distance(first_node, the_station);
+                dis_sum += metered_distance(second_node, the_station);
             }
             if (dis_sum < final_cost) {
                 final_cost = dis_sum;
@@ -320,34 +448,30 @@ void Follower::recursive_charging_placement(int m_len, int n_len, int* chosen_po
 
 double Follower::insert_station_by_all_enumeration(int* repaired_route, int& repaired_length) const {
     const int length = repaired_length;
-    int* route = new int[length];
-    memcpy(route, repaired_route, sizeof(int) * length);
+    scratch.route.assign(repaired_route, repaired_route + length);
+    int* route = scratch.route.data();
 
-    vector<double> accumulated_distance(length, 0);
+    vector<double>& accumulated_distance = scratch.accumulated_distance;
+    accumulated_distance.assign(length, 0);
     for (int i = 1; i < length; i++) {
-        accumulated_distance[i] = accumulated_distance[i - 1] + instance->get_distance(route[i], route[i - 1]);
+        accumulated_distance[i] = accumulated_distance[i - 1] + metered_distance(route[i], route[i - 1]);
     }
     if (accumulated_distance.back() <= preprocessor->max_cruise_distance_) {
-        delete[] route;
         return accumulated_distance.back();
     }
 
     const int upper_bound = ceil(accumulated_distance.back() / preprocessor->max_cruise_distance_);
     const int lower_bound = floor(accumulated_distance.back() / preprocessor->max_cruise_distance_);
-    int* chosen_pos = new int[length];
-    int* chosen_sta = new int[length];
+    scratch.chosen_pos.resize(length);
+    scratch.chosen_sta.resize(length);
     double cost = numeric_limits<double>::max();
-    ChargingMeta meta;
+    // The plan of the lowest cost over all station counts, updated by the enumeration whenever it lowers cost
+    ChargingMeta& meta = scratch.best;
     meta.cost = numeric_limits<double>::max();
+    meta.num_stations = 0;
     for (int i = lower_bound; i <= upper_bound; i++) {
-        ChargingMeta iter_meta = try_enumerate_n_stations_to_route(0, i, chosen_sta, chosen_pos,cost, i, route, length, accumulated_distance);
-        if (cost != numeric_limits<double>::max() && cost < meta.cost) {
-            meta = iter_meta;
-        }
+        try_enumerate_n_stations_to_route(0, i, scratch.chosen_sta.data(), scratch.chosen_pos.data(), cost, i, route, length, accumulated_distance, meta);
     }
-    delete[] chosen_pos;
-    delete[] chosen_sta;
-    delete[] route;
 
     if (cost != numeric_limits<double>::max()) {
         for (int k = meta.num_stations - 1; k >= 0; k--) {
@@ -366,35 +490,101 @@ double Follower::insert_station_by_all_enumeration(int* repaired_route, int& rep
     }
 }
 
-ChargingMeta Follower::try_enumerate_n_stations_to_route(int m_len, int n_len, int *chosen_sta, int *chosen_pos,
-                                                         double &cost, int cur_upper_bound, int *route, int length,
-                                                         vector<double> &accumulated_distance) const {
-    ChargingMeta meta;
+double Follower::insert_station_by_dp(int* repaired_route, int& repaired_length) const {
+    // Label-setting over the route positions: the labels of a node are the Pareto-optimal (cost, remaining range)
+    // plans reaching it, with at most one station per arc as in the enumerations. Leaving a node, a label either
+    // drives the arc, or visits a station s and reaches the next node with a full battery minus d(s, next); for a
+    // station only the cheapest label able to reach it matters, so an arc costs O(S log labels), not O(S labels).
+    const int length = repaired_length;
+    const double max_range = preprocessor->max_cruise_distance_;
+
+    vector<ChargingLabel>& labels = scratch.labels;
+    vector<int>& front = scratch.front;     // labels of the current node, by increasing cost and remaining range
+    vector<ChargingLabel>& candidates = scratch.candidates;
+    labels.assign(1, {0.0, max_range, -1, -1});
+    front.assign(1, 0);
+    for (int i = 0; i + 1 < length; ++i) {
+        const int from = repaired_route[i];
+        const int to = repaired_route[i + 1];
+        const double arc = metered_distance(from, to);
+        const double max_remaining = labels[front.back()].remaining;
+
+        candidates.clear();
+        for (const int l : front) {
+            if (labels[l].remaining >= arc) candidates.push_back({labels[l].cost + arc, labels[l].remaining - arc, l, -1});
+        }
+        for (const int station : preprocessor->station_ids_) {
+            const double to_station = metered_distance(from, station);
+            if (to_station > max_remaining) continue;
+            const double from_station = metered_distance(station, to);
+            if (from_station > max_range) continue;
+            const int l = *std::lower_bound(front.begin(), front.end(), to_station,
+                                            [&](const int label, const double dis) { return labels[label].remaining < dis; });
+            candidates.push_back({labels[l].cost + to_station + from_station, max_range - from_station, l, station});
+        }
+        if (candidates.empty()) return -1;
+
+        // Keep the labels no other label beats on both cost and remaining range
+        std::sort(candidates.begin(), candidates.end(), [](const ChargingLabel& a, const ChargingLabel& b) {
+            return a.cost != b.cost ? a.cost < b.cost : a.remaining > b.remaining;
+        });
+        front.clear();
+        for (const auto& candidate : candidates) {
+            if (!front.empty() && candidate.remaining <= labels[front.back()].remaining) continue;
+            front.push_back(static_cast<int>(labels.size()));
+            labels.push_back(candidate);
+        }
+    }
+
+    // The cheapest plan at the depot, rebuilt backwards through the parents
+    vector<int>& stations = scratch.stations;
+    stations.assign(length, -1);            // stations[i]: station visited on the arc (i - 1, i)
+    int num_stations = 0;
+    for (int l = front.front(), i = length - 1; l > 0; l = labels[l].parent, --i) {
+        stations[i] = labels[l].station;
+        num_stations += labels[l].station >= 0;
+    }
+    if (length + num_stations > node_cap) return -1;
 
-    stack<State> stk;
+    const double cost = labels[front.front()].cost;
+    int index = length + num_stations;
+    for (int i = length - 1; i >= 0; --i) {
+        repaired_route[--index] = repaired_route[i];
+        if (stations[i] >= 0) repaired_route[--index] = stations[i];
+    }
+    repaired_length = length + num_stations;
+    return cost;
+}
+
+void Follower::try_enumerate_n_stations_to_route(int m_len, int n_len, int *chosen_sta, int *chosen_pos,
+                                                 double &cost, int cur_upper_bound, int *route, int length,
+                                                 vector<double> &accumulated_distance, ChargingMeta& meta) const {
+    // The stack never holds more than n_len + 1 states, within the capacity reserved from node_cap
+    vector<State>& stk = scratch.states;
+    stk.clear();
 
     // Push the initial state
-    stk.push({m_len, n_len, m_len, 0});
+    stk.push_back({m_len, n_len, m_len, 0});
 
     while (!stk.empty()) {
-        auto& s = stk.top(); // Get the current state
+        auto& s = stk.back(); // Get the current state
 
         // If n_len == 0, evaluate the solution
         if (s.n_len == 0) {
-            stk.pop(); // Backtrack
+            stk.pop_back(); // Backtrack
             bool feasible = true;
-            double piece_distance = accumulated_distance[chosen_pos[0]] + instance->get_distance(route[chosen_pos[0]], chosen_sta[0]);
+            double piece_distance = accumulated_distance[chosen_pos[0]] + metered_distance(route[chosen_pos[0]], chosen_sta[0]);
             if (piece_distance > preprocessor->max_cruise_distance_) feasible = false;
 
             for (int k = 1; feasible && k < cur_upper_bound; k++) {
                 piece_distance = accumulated_distance[chosen_pos[k]] - accumulated_distance[chosen_pos[k - 1] + 1];
-                piece_distance += instance->get_distance(chosen_sta[k - 1], route[chosen_pos[k - 1] + 1]);
-                piece_distance += instance->get_distance(chosen_sta[k], route[chosen_pos[k]]);
+                piece_distance += metered_distance(chosen_sta[k - 1], route[chosen_pos[k - 1] + 1]);
+                piece_distance += metered_distance(chosen_sta[k], route[chosen_pos[k]]);
                 if (piece_distance > preprocessor->max_cruise_distance_) feasible = false;
             }
 
             piece_distance = accumulated_distance.back() - accumulated_distance[chosen_pos[cur_upper_bound - 1] + 1];
-            piece_distance += instance->get_distance(route[chosen_pos[cur_upper_bound - 1] + 1], chosen_sta[cur_upper_bound - 1]);
+            piece_distance += metered_distance(route[chosen_pos[cur_upper_bound - 1] + 1], chosen_sta[cur_upper_bound - 1]);
             if (piece_distance > preprocessor->max_cruise_distance_) feasible = false;
 
             if (feasible) {
@@ -402,9 +592,9 @@ ChargingMeta Follower::try_enumerate_n_stations_to_route(int m_len, int n_len, i
                 for (int k = 0; k < cur_upper_bound; k++) {
                     int first_node = route[chosen_pos[k]];
                     int second_node = route[chosen_pos[k] + 1];
-                    total_distance -= instance->get_distance(first_node, second_node);
-                    total_distance += instance->get_distance(first_node, chosen_sta[k]);
-                    total_distance += instance->get_distance(chosen_sta[k], second_node);
+                    total_distance -= metered_distance(first_node, second_node);
+                    total_distance += metered_distance(first_node, chosen_sta[k]);
+                    total_distance += metered_distance(chosen_sta[k], second_node);
                 }
                 // produce the repaired route
                 if (total_distance < cost) {
@@ -440,14 +630,13 @@ ChargingMeta Follower::try_enumerate_n_stations_to_route(int m_len, int n_len, i
             }
 
             // Iterate through stations
-            while (s.stationIdx < instance->num_station_) {
+            bool deeper = false;
+            const State next{s.i + 1, s.n_len - 1, s.i + 1, 0};
+            if (s.stationIdx < instance->num_station_) {
                 chosen_sta[cur_upper_bound - s.n_len] = preprocessor->station_ids_[s.stationIdx];
                 chosen_pos[cur_upper_bound - s.n_len] = s.i;
-
-                // Push the next state for further exploration
-                stk.push({s.i + 1, s.n_len - 1, s.i + 1, 0});
                 s.stationIdx++;
-                break; // Go deeper
+                deeper = true;
             }
 
             // If all stations are processed for the current position
@@ -455,12 +644,13 @@ ChargingMeta Follower::try_enumerate_n_stations_to_route(int m_len, int n_len, i
                 s.stationIdx = 0; // Reset for the next iteration
                 s.i++;            // Move to the next route position
             }
+
+            // Push the next state for further exploration, last as it may move s
+            if (deeper) stk.push_back(next);
         } else {
-            stk.pop(); // Backtrack if no more positions are left
+            stk.pop_back(); // Backtrack if no more positions are left
         }
     }
-
-    return std::move(meta);
 }
 
 std::ostream& operator<<(std::ostream& os, const Follower& follower) {
@@ -0,0 +1,81 @@
+#include "history_stats.hpp"
+#include <limits>
+
+const size_t HistoryStats::kResyncInterval = 1 << 20;
+
+void HistoryStats::assign(const size_t size, const double value) {
+    assign(vector<double>(size, value));
+}
+
+void HistoryStats::assign(const vector<double>& values) {
+    size_ = values.size();
+    leaves_ = 1;
+    while (leaves_ < size_) leaves_ <<= 1;
+    tree_.assign(2 * leaves_, {numeric_limits<double>::infinity(), -numeric_limits<double>::infinity()});
+    for (size_t i = 0; i < size_; ++i) tree_[leaves_ + i] = {values[i], values[i]};
+    for (size_t node = leaves_ - 1; node >= 1; --node) {
+        tree_[node] = {std::min(tree_[2 * node].min, tree_[2 * node + 1].min),
+                       std::max(tree_[2 * node].max, tree_[2 * node + 1].max)};
+    }
+    resync();
+}
+
+void HistoryStats::replace(const size_t slot, const double value) {
+    size_t node = leaves_ + slot;
+    const double old_value = tree_[node].min;
+    if (value == old_value) return;
+
+    // Welford update of the moments for one value swapped for another in a list of constant size
+    const double delta = value - old_value;
+    const double old_mean = mean_;
+    mean_ += delta / static_cast<double>(size_);
+    m2_ += delta * ((value - mean_) + (old_value - old_mean));
+
+    // Only the ancestors whose range changes are updated
+    tree_[node] = {value, value};
+    for (node >>= 1; node >= 1; node >>= 1) {
+        const Range range{std::min(tree_[2 * node].min, tree_[2 * node + 1].min),
+                          std::max(tree_[2 * node].max, tree_[2 * node + 1].max)};
+        if (range.min == tree_[node].min && range.max == tree_[node].max) break;
+        tree_[node] = range;
+    }
+
+    if (++num_replaced_ >= kResyncInterval) resync();
+}
+
+void HistoryStats::restore_moments(const double mean, const double m2, const size_t num_replaced) {
+    mean_ = mean;
+    m2_ = m2;
+    num_replaced_ = num_replaced;
+}
+
+double HistoryStats::variance() const {
+    if (size_ < 2) return 0.0;
+    return std::max(m2_, 0.0) / static_cast<double>(size_ - 1);
+}
+
+Indicators HistoryStats::indicators() const {
+    Indicators indicators;
+    if (size_ == 0) return indicators;
+
+    indicators.size = size_;
+    indicators.min = min();
+    indicators.max = max();
+    indicators.avg = mean_;
+    indicators.std = std::sqrt(variance());
+    return indicators;
+}
+
+void HistoryStats::resync() {
+    num_replaced_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+    if (size_ == 0) return;
+
+    for (size_t i = 0; i < size_; ++i) mean_ += tree_[leaves_ + i].min;
+    mean_ /= static_cast<double>(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        const double deviation = tree_[leaves_ + i].min - mean_;
+        m2_ += deviation * deviation;
+    }
+}
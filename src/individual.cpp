@@ -12,6 +12,7 @@ Individual::Individual() {
 
 Individual::Individual(const Individual &ind) {
     this->instance = ind.instance;
+    this->preprocessor = ind.preprocessor;
     this->predecessors = ind.predecessors;
     this->chromT = ind.chromT;
     this->chromR = ind.chromR;
@@ -24,7 +25,7 @@ Individual::Individual(const Individual &ind) {
     this->proximate_individuals = ind.proximate_individuals;
 }
 
-Individual::Individual(Case* instance, Preprocessor *preprocessor) {
+Individual::Individual(const Case* instance, const Preprocessor* preprocessor) {
     this->instance = instance;
     this->preprocessor = preprocessor;
 
@@ -34,12 +35,12 @@ Individual::Individual(Case* instance, Preprocessor *preprocessor) {
     this->chromT = vector<int>(instance->num_customer_);
 }
 
-Individual::Individual(Case* instance, Preprocessor* preprocessor, const vector<int>& chromT)
+Individual::Individual(const Case* instance, const Preprocessor* preprocessor, const vector<int>& chromT)
 : Individual(instance, preprocessor) {
     this->chromT = chromT;
 }
 
-Individual::Individual(Case* instance, Preprocessor* preprocessor, const vector<int>& chromT, const vector<vector<int>>& chromR, double upper_cost)
+Individual::Individual(const Case* instance, const Preprocessor* preprocessor, const vector<int>& chromT, const vector<vector<int>>& chromR, double upper_cost)
 : Individual(instance, preprocessor) {
     this->chromT = chromT;
     for (int i = 0; i < chromR.size(); ++i) {
@@ -76,23 +77,25 @@ double Individual::average_broken_pairs_distance_closest(const int nb_closest) c
     return result/static_cast<double>(max_size) ;
 }
 
-void Individual::evaluate_upper_cost() {
+int Individual::evaluate_upper_cost() {
     upper_cost.reset();
+    int num_lookups = 0;
     for (int r = 0; r < preprocessor->route_cap_; r++) {
         if (!chromR[r].empty()) {
-            double distance = instance->get_distance(instance->depot_, chromR[r][0]);
+            double distance = instance->distance(instance->depot_, chromR[r][0]);
             double load = preprocessor->customers_[chromR[r][0]].demand;
             double service = preprocessor->customers_[chromR[r][0]].service_duration;
             predecessors[chromR[r][0]] = instance->depot_;
             for (int i = 1; i < static_cast<int>(chromR[r].size()); i++) {
-                distance += instance->get_distance(chromR[r][i-1], chromR[r][i]);
+                distance += instance->distance(chromR[r][i-1], chromR[r][i]);
                 load += preprocessor->customers_[chromR[r][i]].demand;
                 service += preprocessor->customers_[chromR[r][i]].service_duration;
                 predecessors[chromR[r][i]] = chromR[r][i-1];
                 successors[chromR[r][i-1]] = chromR[r][i];
             }
             successors[chromR[r][chromR[r].size() - 1]] = instance->depot_;
-            distance += instance->get_distance(chromR[r][chromR[r].size() - 1], instance->depot_);
+            distance += instance->distance(chromR[r][chromR[r].size() - 1], instance->depot_);
+            num_lookups += static_cast<int>(chromR[r].size()) + 1;
             upper_cost.distance += distance;
             upper_cost.nb_routes++;
             if (load > instance->max_vehicle_capa_) upper_cost.capacity_excess += load - instance->max_vehicle_capa_;
@@ -104,6 +107,7 @@ void Individual::evaluate_upper_cost() {
 
     upper_cost.penalised_cost = upper_cost.distance + upper_cost.capacity_excess * preprocessor->penalty_capacity_ + upper_cost.duration_excess * preprocessor->penalty_duration_;
     is_upper_feasible = (upper_cost.capacity_excess < MY_EPSILON && upper_cost.duration_excess < MY_EPSILON);
+    return num_lookups;
 }
 
 std::ostream& operator<<(std::ostream& os, const Individual& individual) {
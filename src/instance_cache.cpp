@@ -0,0 +1,226 @@
+#include "instance_cache.hpp"
+#include "preprocessor.hpp"
+#include <filesystem>
+#include <random>
+
+namespace fs = std::filesystem;
+
+const uint32_t InstanceCache::kVersion = 4;
+
+namespace {
+
+const char kMagic[8] = {'F', 'R', 'O', 'G', 'S', 'I', 'C', '\0'};
+
+uint64_t align_section(const uint64_t offset) {
+    return (offset + 63) & ~static_cast<uint64_t>(63);
+}
+
+// 64-bit FNV-1a
+void hash_bytes(uint64_t& hash, const void* data, const size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1'099'511'628'211ULL;
+    }
+}
+
+template <typename T>
+void hash_value(uint64_t& hash, const T& value) {
+    hash_bytes(hash, &value, sizeof(T));
+}
+
+// Number of entries of a table stored as row offsets + values
+uint64_t total_size(const vector<vector<int>>& rows) {
+    uint64_t size = 0;
+    for (const auto& row : rows) size += row.size();
+    return size;
+}
+
+void write_padding(ofstream& out, const uint64_t target) {
+    static const char zeros[64] = {};
+    const auto position = static_cast<uint64_t>(out.tellp());
+    if (target > position) out.write(zeros, static_cast<streamsize>(target - position));
+}
+
+void write_rows(ofstream& out, const vector<vector<int>>& rows, const uint64_t offsets_offset, const uint64_t values_offset) {
+    write_padding(out, offsets_offset);
+    uint64_t offset = 0;
+    out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    for (const auto& row : rows) {
+        offset += row.size();
+        out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+
+    write_padding(out, values_offset);
+    for (const auto& row : rows) {
+        vector<int32_t> values(row.begin(), row.end());
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(int32_t)));
+    }
+}
+
+} // namespace
+
+uint64_t InstanceCache::fingerprint(const Case& c, const int nb_granular) {
+    uint64_t hash = 14'695'981'039'346'656'037ULL;
+    hash_value(hash, kVersion);
+    hash_value(hash, nb_granular);
+    hash_value(hash, static_cast<uint32_t>(sizeof(distance_t)));
+    hash_value(hash, c.num_customer_);
+    hash_value(hash, c.num_station_);
+    hash_value(hash, c.num_vehicle_);
+    hash_value(hash, c.max_vehicle_capa_);
+    hash_value(hash, c.max_battery_capa_);
+    hash_value(hash, c.energy_consumption_rate_);
+    for (const auto& [x, y] : c.positions_) {
+        hash_value(hash, x);
+        hash_value(hash, y);
+    }
+    for (const int demand : c.demand_) {
+        hash_value(hash, demand);
+    }
+
+    return hash;
+}
+
+string InstanceCache::file_path(const Case& c, const int nb_granular) {
+    std::ostringstream oss;
+    oss << kCachePath << c.instance_name_ << "." << hex << fingerprint(c, nb_granular) << ".bin";
+    return oss.str();
+}
+
+bool InstanceCache::save(const Case& c, const Preprocessor& preprocessor) {
+    const int n = c.problem_size_;
+    const int m = c.num_customer_ + 1;
+
+    InstanceCacheHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(InstanceCacheHeader);
+    header.fingerprint = fingerprint(c, preprocessor.nb_granular_);
+    header.problem_size = n;
+    header.num_customer = c.num_customer_;
+    header.num_station = c.num_station_;
+    header.nb_granular = preprocessor.nb_granular_;
+    header.distance_size = sizeof(distance_t);
+    header.max_distance = preprocessor.max_distance_;
+    header.distances_offset = align_section(sizeof(InstanceCacheHeader));
+    header.nearby_offsets_offset = align_section(header.distances_offset + sizeof(distance_t) * n * n);
+    header.nearby_values_offset = align_section(header.nearby_offsets_offset + sizeof(uint64_t) * (m + 1));
+    header.correlated_offsets_offset = align_section(header.nearby_values_offset + sizeof(int32_t) * total_size(preprocessor.sorted_nearby_customers_));
+    header.correlated_values_offset = align_section(header.correlated_offsets_offset + sizeof(uint64_t) * (m + 1));
+    header.best_station_offset = align_section(header.correlated_values_offset + sizeof(int32_t) * total_size(preprocessor.correlated_vertices_));
+    header.file_size = header.best_station_offset + sizeof(uint16_t) * preprocessor.best_station_.size();
+
+    // Several trials may write the same file concurrently, so each one writes its own temporary file and renames it
+    const string path = file_path(c, preprocessor.nb_granular_);
+    const string tmp_path = path + ".tmp" + to_string(std::random_device{}());
+    try {
+        fs::create_directories(kCachePath);
+
+        ofstream out(tmp_path, ios::binary | ios::trunc);
+        if (!out) return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_padding(out, header.distances_offset);
+        for (int i = 0; i < n; ++i) {
+            out.write(reinterpret_cast<const char*>(c.distance_row(i)), static_cast<streamsize>(sizeof(distance_t) * n));
+        }
+        write_rows(out, preprocessor.sorted_nearby_customers_, header.nearby_offsets_offset, header.nearby_values_offset);
+        write_rows(out, preprocessor.correlated_vertices_, header.correlated_offsets_offset, header.correlated_values_offset);
+        write_padding(out, header.best_station_offset);
+        vector<uint16_t> codes(preprocessor.best_station_.size());
+        preprocessor.best_station_.store(codes.data());
+        out.write(reinterpret_cast<const char*>(codes.data()), static_cast<streamsize>(sizeof(uint16_t) * codes.size()));
+        out.close();
+
+        if (!out) {
+            fs::remove(tmp_path);
+            return false;
+        }
+        fs::rename(tmp_path, path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error writing the instance cache: " << e.what() << std::endl;
+        std::error_code ec;
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+bool InstanceCache::open(const Case& c, const int nb_granular) {
+    header_ = nullptr;
+    if (!file_.open(file_path(c, nb_granular)) || file_.size() < sizeof(InstanceCacheHeader)) {
+        file_.close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const InstanceCacheHeader*>(file_.data());
+    const uint64_t n = c.problem_size_;
+    const uint64_t m = c.num_customer_ + 1;
+    const bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                       header->version == kVersion &&
+                       header->header_size == sizeof(InstanceCacheHeader) &&
+                       header->fingerprint == fingerprint(c, nb_granular) &&
+                       header->problem_size == c.problem_size_ &&
+                       header->num_customer == c.num_customer_ &&
+                       header->num_station == c.num_station_ &&
+                       header->nb_granular == nb_granular &&
+                       header->distance_size == sizeof(distance_t) &&
+                       header->file_size == file_.size() &&
+                       header->distances_offset + sizeof(distance_t) * n * n <= header->nearby_offsets_offset &&
+                       header->nearby_offsets_offset + sizeof(uint64_t) * (m + 1) <= header->nearby_values_offset &&
+                       header->nearby_values_offset <= header->correlated_offsets_offset &&
+                       header->correlated_offsets_offset + sizeof(uint64_t) * (m + 1) <= header->correlated_values_offset &&
+                       header->correlated_values_offset <= header->best_station_offset &&
+                       header->best_station_offset + sizeof(uint16_t) * m * (m + 1) / 2 == header->file_size;
+    if (!valid) {
+        file_.close();
+        return false;
+    }
+
+    // The row offsets must be increasing and stay inside their value sections
+    auto valid_rows = [&](const uint64_t offsets_offset, const uint64_t values_offset, const uint64_t values_end) {
+        const auto* offsets = reinterpret_cast<const uint64_t*>(file_.data() + offsets_offset);
+        for (uint64_t i = 0; i < m; ++i) {
+            if (offsets[i] > offsets[i + 1]) return false;
+        }
+        return offsets[0] == 0 && values_offset + sizeof(int32_t) * offsets[m] <= values_end;
+    };
+    if (!valid_rows(header->nearby_offsets_offset, header->nearby_values_offset, header->correlated_offsets_offset) ||
+        !valid_rows(header->correlated_offsets_offset, header->correlated_values_offset, header->best_station_offset)) {
+        file_.close();
+        return false;
+    }
+
+    header_ = header;
+    return true;
+}
+
+const distance_t* InstanceCache::distances() const {
+    return reinterpret_cast<const distance_t*>(file_.data() + header_->distances_offset);
+}
+
+vector<vector<int>> InstanceCache::sorted_nearby_customers() const {
+    return read_rows(header_->nearby_offsets_offset, header_->nearby_values_offset);
+}
+
+vector<vector<int>> InstanceCache::correlated_vertices() const {
+    return read_rows(header_->correlated_offsets_offset, header_->correlated_values_offset);
+}
+
+const uint16_t* InstanceCache::best_station() const {
+    return reinterpret_cast<const uint16_t*>(file_.data() + header_->best_station_offset);
+}
+
+vector<vector<int>> InstanceCache::read_rows(const uint64_t offsets_offset, const uint64_t values_offset) const {
+    const int m = header_->num_customer + 1;
+    const auto* offsets = reinterpret_cast<const uint64_t*>(file_.data() + offsets_offset);
+    const auto* values = reinterpret_cast<const int32_t*>(file_.data() + values_offset);
+
+    vector<vector<int>> rows(m);
+    for (int i = 0; i < m; ++i) {
+        rows[i].assign(values + offsets[i], values + offsets[i + 1]);
+    }
+    return rows;
+}
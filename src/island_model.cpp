@@ -0,0 +1,39 @@
+#include "island_model.hpp"
+
+const int IslandModel::kInboxCapacity = 8;
+
+IslandModel::IslandModel(const int num_islands, const Topology topology, const int migration_interval) {
+    this->topology_ = topology;
+    this->migration_interval_ = std::max(1, migration_interval);
+    for (int i = 0; i < num_islands; ++i) {
+        inboxes_.push_back(make_unique<BoundedQueue<unique_ptr<Individual>>>(kInboxCapacity));
+    }
+}
+
+int IslandModel::neighbour(const int island, std::default_random_engine& engine) const {
+    const int n = num_islands();
+    if (n < 2) return island;
+    if (topology_ == Topology::RANDOM) {
+        // Any island but this one
+        const int other = std::uniform_int_distribution<int>(0, n - 2)(engine);
+        return other < island ? other : other + 1;
+    }
+    return (island + 1) % n;
+}
+
+bool IslandModel::emigrate(const int island, const Individual& migrant, std::default_random_engine& engine) {
+    const int to = neighbour(island, engine);
+    if (to == island) return false;
+    auto copy = make_unique<Individual>(migrant);
+    if (!inboxes_[to]->try_push(copy)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+unique_ptr<Individual> IslandModel::immigrate(const int island) {
+    auto migrant = inboxes_[island]->try_pop();
+    return migrant ? std::move(*migrant) : nullptr;
+}
@@ -3,16 +3,26 @@
 //
 
 #include "lahc.hpp"
+#include "instance_cache.hpp"
+#include "evolution_log.hpp"
+#include <filesystem>
 
 const std::string ALGORITHM = "Lahc";
+const double Lahc::kSharedRestartRate = 0.5;
+const int Lahc::kDeadlineCheckInterval = 16;
 
-Lahc::Lahc(int seed_val, Case* instance, Preprocessor* preprocessor) : HeuristicInterface("LAHC", seed_val, instance, preprocessor) {
-    enable_logging = preprocessor->params.enable_logging;
-    stop_criteria = preprocessor->params.stop_criteria;
+Lahc::Lahc(int seed_val, const Case* instance, const Preprocessor* preprocessor) : Lahc(seed_val, instance, preprocessor, preprocessor->params) {}
+
+Lahc::Lahc(int seed_val, const Case* instance, const Preprocessor* preprocessor, const Parameters& params) : HeuristicInterface("LAHC", seed_val, instance, preprocessor) {
+    enable_logging = params.enable_logging;
+    trace_interval = params.trace_interval;
+    stop_criteria = params.stop_criteria;
+    if (params.time_limit > 0.0) max_exec_time = params.time_limit;
 
     iter = 0L;
     idle_iter = 0L;
-    history_length = static_cast<long>(preprocessor->params.history_length);
+    iteration_limit = numeric_limits<long>::max();
+    history_length = static_cast<long>(params.history_length);
     history_list = vector<double>(history_length);
     current = nullptr;
     global_best = make_unique<Individual>();
@@ -21,6 +31,12 @@ Lahc::Lahc(int seed_val, Case* instance, Preprocessor* preprocessor) : Heuristic
 //    leader = new LeaderLahc(seed_val, instance, preprocessor);
     leader = new LeaderArray(seed_val, instance, preprocessor);
     follower = new Follower(instance, preprocessor);
+    follower->route_cache.resize(params.route_cache_size);
+
+    output_label = params.output_label;
+    if (params.checkpoint_interval > 0) enable_checkpoints(checkpoint_file(), params.checkpoint_interval);
+    resume = params.resume;
+    if (resume && checkpoint_path.empty()) checkpoint_path = checkpoint_file();
 }
 
 Lahc::~Lahc() {
@@ -32,18 +48,37 @@ Lahc::~Lahc() {
 
 void Lahc::initialize_heuristic() {
     delete current;
-    current = new Individual(instance, preprocessor);
 
-    split->initIndividualWithHienClustering(current);
+    // In the cooperative mode, part of the restarts continue from the best solution of the group
+    bool restarted = false;
+    if (shared_best && shared_restart_rate > 0.0) {
+        const SharedBest::Reader best(*shared_best);
+        if (best.get() != nullptr && uniform_real_dist(random_engine) < shared_restart_rate) {
+            current = new Individual(best->solution);
+            restarted = true;
+        }
+    }
+    if (!restarted) {
+        current = new Individual(instance, preprocessor);
+        split->initIndividualWithHienClustering(current);
+        charge_evaluations();
+    }
     history_list.assign(history_length, current->upper_cost.penalised_cost);
+    history_stats.assign(history_list);
     this->iter = 0L;
     this->idle_iter = 0L;
 }
 
 void Lahc::run_heuristic() {
-    leader->load_individual(current);
+    if (leader_loaded) {
+        leader_loaded = false;
+    } else {
+        leader->load_individual(current);
+    }
 
     do {
+        // At the top of an iteration the state is complete: current is the leader's solution and all lookups are charged
+        if (checkpoint_writer && iter % kDeadlineCheckInterval == 0 && coarse_seconds() >= next_checkpoint) save_checkpoint();
 
         double current_cost = leader->upper_cost;
 
@@ -57,21 +92,36 @@ void Lahc::run_heuristic() {
         // idle judgement and counting
         idle_iter = candidate_cost >= current_cost ? idle_iter + 1 : 0;
         // update the history list
-        history_list[v] = candidate_cost < history_cost ? candidate_cost : history_cost;
+        if (candidate_cost < history_cost) {
+            history_list[v] = candidate_cost;
+            history_stats.replace(v, candidate_cost);
+        }
 
         if (v == 0L) {
-            history_list_metrics = StatsInterface::calculate_statistical_indicators(history_list);
+            history_list_metrics = history_stats.indicators();
             flush_row_into_evol_log();
         }
 
         iter++;
 
-        follower->run(current);
+        follower->run(current, leader->dirty_routes);
+        leader->dirty_routes.clear();
+        charge_evaluations();
         if (current->lower_cost < global_best->lower_cost) {
             global_best = std::move(make_unique<Individual>(*current));
+            if (shared_best) shared_best->publish(*global_best, seed);
         }
+        if (trace && iter % trace_interval == 0) {
+            trace->append({iter, evaluations.lookups(), current_cost, candidate_cost, history_cost,
+                           global_best->lower_cost, history_stats.min(), history_stats.max(), history_stats.mean(),
+                           std::sqrt(history_stats.variance())});
+        }
+        if (islands && iter % islands->migration_interval() == 0) migrate();
+
+        // A restart can take minutes on large instances, so the deadline is also checked inside it
+        if (iter % kDeadlineCheckInterval == 0 && deadline.expired()) break;
 
-    } while (iter < 100'000L || idle_iter < iter / 5);
+    } while ((iter < 100'000L || idle_iter < iter / 5) && iter < iteration_limit);
 }
 
 void Lahc::run() {
@@ -79,20 +129,33 @@ void Lahc::run() {
     start = std::chrono::high_resolution_clock::now();
     duration = std::chrono::duration<double>::zero();
 
+    // A resumed run continues the restart of its checkpoint, with the time and the evaluations it had already used, and
+    // its log and trace are cut back to the rows written before the checkpoint
+    if (resume && resume_from_checkpoint()) {
+        start -= std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(duration);
+    }
+
     if (enable_logging) {
         open_log_for_evolution();  // Open log if logging is enabled
     }
+    if (trace_interval > 0) open_trace();
+    deadline = Deadline(stop_criteria == 1 ? max_exec_time - duration.count() : numeric_limits<double>::infinity(), cancellation);
 
+    // The stopping criteria are checked between restarts, so a resumed restart is finished first, as without the break
+    if (leader_loaded) {
+        run_heuristic();
+        duration = std::chrono::high_resolution_clock::now() - start;
+    }
 
     switch (stop_criteria) {
         case 0:
-            while (!stop_criteria_max_evals()) {
+            while (!stop_criteria_max_evals() && !deadline.expired()) {
                 initialize_heuristic();
                 run_heuristic();
             }
             break;
         case 1:
-            while (!stop_criteria_max_exec_time(duration)) {
+            while (!stop_criteria_max_exec_time(duration) && !deadline.expired()) {
                 initialize_heuristic();
                 run_heuristic();
                 duration = std::chrono::high_resolution_clock::now() - start;
@@ -104,6 +167,29 @@ void Lahc::run() {
             break;
     }
 
+    if (checkpoint_writer) {
+        // A cancelled run keeps its latest state for a resume, a finished one removes it
+        if (deadline.cancelled()) save_checkpoint();
+        checkpoint_writer->flush();             // before the log its barriers wait for is closed
+        if (!deadline.cancelled()) {
+            std::error_code ignored;
+            std::filesystem::remove(checkpoint_path, ignored);
+        }
+    }
+
+#ifdef FROGS_FLOAT_DISTANCES
+    // The search compared costs built from the single-precision matrix, report the exact objective of the best solution
+    follower->run(global_best.get());
+    if (global_best->lower_cost < INFEASIBLE) {
+        global_best->lower_cost = instance->calculate_exact_dist_follower(follower->lower_routes, follower->num_routes, follower->lower_num_nodes_per_route);
+    }
+#endif
+
+    if (trace) {
+        trace->close();
+        trace.reset();
+    }
+
     if (enable_logging) {
         flush_row_into_evol_log();
         close_log_for_evolution();  // Close log if logging is enabled
@@ -111,28 +197,275 @@ void Lahc::run() {
     }
 }
 
-void Lahc::open_log_for_evolution() {
-    const string directory = kStatsPath + "/" + this->name + "/" + instance->instance_name_ + "/" + to_string(seed);
+void Lahc::charge_evaluations() {
+    evaluations.charge(split->num_lookups + leader->num_lookups + follower->num_lookups);
+    split->num_lookups = 0;
+    leader->num_lookups = 0;
+    follower->num_lookups = 0;
+}
+
+void Lahc::share_best(SharedBest* shared, const double restart_rate) {
+    this->shared_best = shared;
+    this->shared_restart_rate = restart_rate;
+}
+
+void Lahc::join_islands(IslandModel* model, const int index) {
+    this->islands = model;
+    this->island = index;
+    this->emigrated_cost = numeric_limits<double>::max();
+}
+
+void Lahc::migrate() {
+    if (global_best->lower_cost < emigrated_cost && islands->emigrate(island, *global_best, random_engine)) {
+        emigrated_cost = global_best->lower_cost;
+    }
+
+    unique_ptr<Individual> best_immigrant;
+    while (auto immigrant = islands->immigrate(island)) {
+        if (!best_immigrant || immigrant->lower_cost < best_immigrant->lower_cost) best_immigrant = std::move(immigrant);
+    }
+    if (!best_immigrant || !(best_immigrant->lower_cost < global_best->lower_cost)) return;
+
+    // The search continues from the immigrant, which is now the best solution of this island
+    global_best = make_unique<Individual>(*best_immigrant);
+    emigrated_cost = global_best->lower_cost;   // no need to send it back
+    delete current;
+    current = best_immigrant.release();
+    leader->load_individual(current);
+    idle_iter = 0L;
+}
+
+void Lahc::enable_checkpoints(const string& path, const double interval) {
+    this->checkpoint_path = path;
+    this->checkpoint_interval = interval;
+    this->next_checkpoint = coarse_seconds() + interval;
+    if (!checkpoint_writer) checkpoint_writer = make_unique<AsyncCheckpointWriter>();
+}
+
+string Lahc::checkpoint_file() const {
+    ostringstream oss;
+    oss << kCheckpointPath << instance->instance_name_ << "/" << (output_label.empty() ? "" : output_label + "/") << name << "." << seed << "." << hex << checkpoint_fingerprint() << ".ckpt";
+    return oss.str();
+}
+
+uint64_t Lahc::checkpoint_fingerprint() const {
+    uint64_t hash = InstanceCache::fingerprint(*instance, preprocessor->nb_granular_);
+    for (const uint64_t value : {static_cast<uint64_t>(seed), static_cast<uint64_t>(history_length),
+                                 static_cast<uint64_t>(leader->route_cap), static_cast<uint64_t>(leader->node_cap)}) {
+        hash = (hash ^ value) * 1'099'511'628'211ULL;
+    }
+    return hash;
+}
+
+namespace {
+
+void encode_individual(CheckpointEncoder& out, const Individual& individual) {
+    out.put_vector(individual.chromT);
+    out.put<uint64_t>(individual.chromR.size());
+    for (const auto& route : individual.chromR) out.put_vector(route);
+    out.put(individual.upper_cost);
+    out.put(individual.is_upper_feasible);
+    out.put(individual.lower_cost);
+}
+
+void decode_individual(CheckpointDecoder& in, Individual& individual) {
+    individual.chromT = in.get_vector<int>();
+    individual.chromR.resize(in.get<uint64_t>());
+    for (auto& route : individual.chromR) route = in.get_vector<int>();
+    individual.upper_cost = in.get<UpperCost>();
+    individual.is_upper_feasible = in.get<bool>();
+    individual.lower_cost = in.get<double>();
+}
+
+string engine_state(const std::default_random_engine& engine) {
+    ostringstream oss;
+    oss << engine;
+    return oss.str();
+}
+
+void restore_engine(const string& state, std::default_random_engine& engine) {
+    istringstream iss(state);
+    if (!(iss >> engine)) throw runtime_error("checkpoint: bad random engine state");
+}
+
+} // namespace
+
+vector<char> Lahc::encode_state() const {
+    CheckpointEncoder out;
+    out.put(iter);
+    out.put(idle_iter);
+    out.put(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+    out.put(evaluations.lookups());
+    // Only the row counts of the outputs: the checkpoint writer waits for the log, the trace keeps its current block here
+    out.put(log_evolution ? log_evolution->num_appended() : -1L);
+    out.put(trace ? trace->num_written() : -1L);
+    out.put_vector(trace ? trace->pending_rows() : vector<uint64_t>());
+    out.put_string(engine_state(random_engine));
+    out.put_string(engine_state(split->random_engine));     // the start solutions of the next restarts
+    out.put_vector(history_list);
+    out.put(history_stats.mean());
+    out.put(history_stats.m2());
+    out.put(static_cast<uint64_t>(history_stats.num_replaced()));
+    encode_individual(out, *current);
+    encode_individual(out, *global_best);
+
+    // The leader's routes as they are, empty slots included, so that the moves continue exactly as without a break
+    out.put_string(engine_state(leader->random_engine));
+    out.put(leader->num_routes);
+    out.put(leader->upper_cost);
+    out.put(leader->history_cost);
+    out.put_array(leader->num_nodes_per_route, leader->route_cap);
+    out.put_array(leader->demand_sum_per_route, leader->route_cap);
+    for (int i = 0; i < leader->route_cap; ++i) {
+        out.put_array(leader->routes[i], std::max(0, leader->num_nodes_per_route[i]));
+    }
+    return out.release();
+}
+
+void Lahc::decode_state(const vector<char>& payload) {
+    // Everything is decoded before the run is touched, so that a malformed payload leaves it as it was
+    CheckpointDecoder in(payload.data(), payload.size());
+    const auto saved_iter = in.get<long>();
+    const auto saved_idle_iter = in.get<long>();
+    const auto elapsed = in.get<double>();
+    const auto lookups = in.get<uint64_t>();
+    const auto log_rows = in.get<long>();
+    const auto trace_rows = in.get<long>();
+    vector<uint64_t> trace_pending = in.get_vector<uint64_t>();
+    std::default_random_engine engine, split_engine, leader_engine;
+    restore_engine(in.get_string(), engine);
+    restore_engine(in.get_string(), split_engine);
+    vector<double> history = in.get_vector<double>();
+    if (static_cast<long>(history.size()) != history_length) throw runtime_error("checkpoint: history length mismatch");
+    const auto history_mean = in.get<double>();
+    const auto history_m2 = in.get<double>();
+    const auto history_replaced = in.get<uint64_t>();
+    auto saved_current = make_unique<Individual>(instance, preprocessor);
+    decode_individual(in, *saved_current);
+    auto saved_best = make_unique<Individual>(instance, preprocessor);
+    decode_individual(in, *saved_best);
+
+    restore_engine(in.get_string(), leader_engine);
+    const auto num_routes = in.get<int>();
+    const auto upper_cost = in.get<double>();
+    const auto history_cost = in.get<double>();
+    vector<int> num_nodes(leader->route_cap), demand_sums(leader->route_cap);
+    in.get_array(num_nodes.data(), num_nodes.size());
+    in.get_array(demand_sums.data(), demand_sums.size());
+    vector<vector<int>> routes(leader->route_cap);
+    for (int i = 0; i < leader->route_cap; ++i) {
+        if (num_nodes[i] < 0 || num_nodes[i] > leader->node_cap) throw runtime_error("checkpoint: bad route length");
+        routes[i].resize(num_nodes[i]);
+        in.get_array(routes[i].data(), routes[i].size());
+    }
+    if (!in.at_end()) throw runtime_error("checkpoint: trailing data");
+
+    iter = saved_iter;
+    idle_iter = saved_idle_iter;
+    duration = std::chrono::duration<double>(elapsed);
+    resumed_log_rows = log_rows;
+    resumed_trace_rows = trace_rows;
+    resumed_trace_pending = std::move(trace_pending);
+    random_engine = engine;
+    split->random_engine = split_engine;
+    history_list = std::move(history);
+    history_stats.assign(history_list);
+    history_stats.restore_moments(history_mean, history_m2, history_replaced);
+    delete current;
+    current = saved_current.release();
+    global_best = std::move(saved_best);
+
+    leader->random_engine = leader_engine;
+    leader->num_routes = num_routes;
+    leader->upper_cost = upper_cost;
+    leader->history_cost = history_cost;
+    for (int i = 0; i < leader->route_cap; ++i) {
+        leader->num_nodes_per_route[i] = num_nodes[i];
+        leader->demand_sum_per_route[i] = demand_sums[i];
+        memset(leader->routes[i], 0, sizeof(int) * leader->node_cap);
+        std::copy(routes[i].begin(), routes[i].end(), leader->routes[i]);
+    }
+    leader->dirty_routes.mark_all();
+
+    if (lookups > evaluations.lookups()) evaluations.charge(lookups - evaluations.lookups());
+    leader_loaded = true;
+}
+
+void Lahc::save_checkpoint() {
+    // The search thread does not wait for the log: the checkpoint is put in place once the rows it counts are written
+    std::function<void()> barrier;
+    if (log_evolution) {
+        barrier = [log = log_evolution.get(), rows = log_evolution->num_appended()] { log->wait_written(rows); };
+    }
+    checkpoint_writer->submit(checkpoint_path, checkpoint_fingerprint(), encode_state(), std::move(barrier));
+    next_checkpoint = coarse_seconds() + checkpoint_interval;
+}
+
+bool Lahc::resume_from_checkpoint() {
+    vector<char> payload;
+    if (!CheckpointFile::read(checkpoint_path, checkpoint_fingerprint(), payload)) return false;
+    try {
+        decode_state(payload);
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring the checkpoint " << checkpoint_path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+string Lahc::output_directory() const {
+    string directory = kStatsPath + "/" + this->name + "/" + instance->instance_name_ + "/";
+    if (!output_label.empty()) directory += output_label + "/";
+    directory += to_string(seed);
     create_directories_if_not_exists(directory);
+    return directory;
+}
+
+void Lahc::open_log_for_evolution() {
+    const string directory = output_directory();
 
     const string file_name = "evols." + instance->instance_name_ + ".csv";
-    log_evolution.open(directory + "/" + file_name);
-    log_evolution << "iters,global_best,min,max,mean,std\n";
+    log_evolution = make_unique<EvolutionLog>(directory + "/" + file_name, "iters,global_best,min,max,mean,std",
+                                              EvolutionLog::kCapacity, EvolutionLog::kFlushInterval, resumed_log_rows);
 }
 
 void Lahc::close_log_for_evolution() {
-    log_evolution << oss_row_evol.str();
-    oss_row_evol.clear();
-    log_evolution.close();
+    if (!log_evolution) return;
+    log_evolution->close();
+    if (log_evolution->num_dropped() > 0) {
+        std::cerr << "Evolution log: " << log_evolution->num_dropped() << " rows dropped, the writer fell behind" << std::endl;
+    }
+    log_evolution.reset();
 }
 
 void Lahc::flush_row_into_evol_log() {
-    oss_row_evol << iter << "," << global_best->lower_cost << "," << history_list_metrics.min << "," <<
-        history_list_metrics.max <<"," << history_list_metrics.avg << "," << history_list_metrics.std << "\n";
+    if (log_evolution) log_evolution->append({iter, global_best->lower_cost, history_list_metrics});
+}
+
+void Lahc::open_trace() {
+    const string directory = output_directory();
+
+    const vector<TraceColumn> columns = {
+            {"iter", TraceType::INT64}, {"evaluations", TraceType::INT64}, {"current"}, {"candidate"}, {"history"},
+            {"global_best"}, {"history_min"}, {"history_max"}, {"history_mean"}, {"history_std"}};
+    const string path = directory + "/trace." + instance->instance_name_ + ".bin";
+    if (resumed_trace_rows >= 0) {
+        try {
+            trace = make_unique<TraceWriter>(path, columns, TraceWriter::kBlockRows, resumed_trace_rows, resumed_trace_pending);
+            return;
+        } catch (const std::exception& e) {
+            std::cerr << "Starting a new trace: " << e.what() << std::endl;
+        }
+    }
+    try {
+        trace = make_unique<TraceWriter>(path, columns);
+    } catch (const std::exception& e) {
+        std::cerr << "No trace: " << e.what() << std::endl;
+    }
 }
 
 void Lahc::save_log_for_solution() {
-    const string directory = kStatsPath + "/" + this->name + "/" + instance->instance_name_ + "/" + to_string(seed);
+    const string directory = output_directory();
 
     const string file_name = "solution." + instance->instance_name_ + ".txt";
 
@@ -141,7 +474,7 @@ void Lahc::save_log_for_solution() {
     follower->run(global_best.get());
     for (int i = 0; i < follower->num_routes; ++i) {
         for (int j = 0; j < follower->lower_num_nodes_per_route[i]; ++j) {
-            log_solution << follower->lower_routes[i][j] << ",";
+            log_solution << instance->original_id(follower->lower_routes[i][j]) << ",";
         }
         log_solution << endl;
     }
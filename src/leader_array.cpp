@@ -3,7 +3,7 @@
 //
 #include "leader_array.hpp"
 
-LeaderArray::LeaderArray(int seed_val, Case *instance, Preprocessor *preprocessor) : instance(instance), preprocessor(preprocessor) {
+LeaderArray::LeaderArray(int seed_val, const Case* instance, const Preprocessor* preprocessor) : instance(instance), preprocessor(preprocessor) {
     this->random_engine = std::default_random_engine(seed_val);
     this->uniform_int_dis = std::uniform_int_distribution<int>(0, 5); // 6 moves
 
@@ -23,6 +23,7 @@ LeaderArray::LeaderArray(int seed_val, Case *instance, Preprocessor *preprocesso
     memset(this->num_nodes_per_route, 0, sizeof(int) * route_cap);
     this->demand_sum_per_route = new int [route_cap];
     memset(this->demand_sum_per_route, 0, sizeof(int) * route_cap);
+    this->dirty_routes.resize(route_cap);
 }
 
 LeaderArray::~LeaderArray() {
@@ -79,6 +80,7 @@ void LeaderArray::load_individual(Individual* ind) {
 
         memcpy(&this->routes[i][1], ind->chromR[i].data(),ind->chromR[i].size() * sizeof(int));
     }
+    dirty_routes.mark_all();
 }
 
 void LeaderArray::export_individual(Individual* ind) const {
@@ -115,9 +117,10 @@ bool LeaderArray::two_opt_for_single_route(int* route, int length) {
     int j = distJ(random_engine);
 
     // Calculate the cost difference between the old route and the new route obtained by swapping arcs
-    double original_cost = instance->get_distance(route[i - 1], route[i]) + instance->get_distance(route[j], route[j + 1]);
-    double modified_cost = instance->get_distance(route[i - 1], route[j]) + instance->get_distance(route[i], route[j + 1]);
+    double original_cost = instance->distance(route[i - 1], route[i]) + instance->distance(route[j], route[j + 1]);
+    double modified_cost = instance->distance(route[i - 1], route[j]) + instance->distance(route[i], route[j + 1]);
 
+    num_lookups += 4;
     double change = modified_cost - original_cost; // negative represents the cost reduction
     if (is_accepted(change)) {
         // update current solution
@@ -140,6 +143,7 @@ bool LeaderArray::two_opt_intra_for_individual() {
 
         isMoved = two_opt_for_single_route(routes[random_route_idx], num_nodes_per_route[random_route_idx]);
 
+        if (isMoved) dirty_routes.mark(random_route_idx);
         searchDepth++;
     }
 
@@ -166,9 +170,10 @@ bool LeaderArray::two_opt_star_between_two_routes(int *route1, int *route2, int
         partial_dem_r2 += instance->get_customer_demand_(route2[n2]);
 
         if (partial_dem_r1 + loading2 - partial_dem_r2 <= instance->max_vehicle_capa_ && partial_dem_r2 + loading1 - partial_dem_r1 <= instance->max_vehicle_capa_) {
-            double old_cost = instance->get_distance(route1[n1], route1[n1 + 1]) + instance->get_distance(route2[n2], route2[n2 + 1]);
-            double new_cost = instance->get_distance(route1[n1], route2[n2 + 1]) + instance->get_distance(route2[n2], route1[n1 + 1]);
+            double old_cost = instance->distance(route1[n1], route1[n1 + 1]) + instance->distance(route2[n2], route2[n2 + 1]);
+            double new_cost = instance->distance(route1[n1], route2[n2 + 1]) + instance->distance(route2[n2], route1[n1 + 1]);
 
+            num_lookups += 4;
             double change = new_cost - old_cost;
             if (is_accepted(change)) {
                 // update
@@ -194,9 +199,10 @@ bool LeaderArray::two_opt_star_between_two_routes(int *route1, int *route2, int
             }
 
         } else if (partial_dem_r1 + partial_dem_r2 <= instance->max_vehicle_capa_ && loading1 - partial_dem_r1 + loading2 - partial_dem_r2 <= instance->max_vehicle_capa_) {
-            double old_cost = instance->get_distance(route1[n1], route1[n1 + 1]) + instance->get_distance(route2[n2], route2[n2 + 1]);
-            double new_cost = instance->get_distance(route1[n1], route2[n2]) + instance->get_distance(route1[n1 + 1], route2[n2 + 1]);
+            double old_cost = instance->distance(route1[n1], route1[n1 + 1]) + instance->distance(route2[n2], route2[n2 + 1]);
+            double new_cost = instance->distance(route1[n1], route2[n2]) + instance->distance(route1[n1 + 1], route2[n2 + 1]);
 
+            num_lookups += 4;
             double change = new_cost - old_cost;
             if (is_accepted(change)) {
                 // update
@@ -255,6 +261,11 @@ bool LeaderArray::two_opt_inter_for_individual() {
         }
 
         isMoved = two_opt_star_between_two_routes(routes[r1], routes[r2], num_nodes_per_route[r1], num_nodes_per_route[r2], demand_sum_per_route[r1], demand_sum_per_route[r2], temp_r1, temp_r2);
+        if (isMoved) {
+            // an emptied route is replaced by the last one below, so only r1 and r2 change among the remaining routes
+            dirty_routes.mark(r1);
+            dirty_routes.mark(r2);
+        }
 
         // remove empty routes
         if (demand_sum_per_route[r1] == 0) {
@@ -306,21 +317,22 @@ bool LeaderArray::node_relocation_for_single_route(int *route, int length) {
 
     double original_cost, modified_cost;
     if (i < j) {
-        original_cost = instance->get_distance(route[i - 1], route[i]) +
-                        instance->get_distance(route[i], route[i + 1]) +
-                        instance->get_distance(route[j], route[j + 1]);
-        modified_cost = instance->get_distance(route[i - 1], route[i + 1]) +
-                        instance->get_distance(route[j], route[i]) +
-                        instance->get_distance(route[i], route[j + 1]);
+        original_cost = instance->distance(route[i - 1], route[i]) +
+                        instance->distance(route[i], route[i + 1]) +
+                        instance->distance(route[j], route[j + 1]);
+        modified_cost = instance->distance(route[i - 1], route[i + 1]) +
+                        instance->distance(route[j], route[i]) +
+                        instance->distance(route[i], route[j + 1]);
     } else {
-        original_cost = instance->get_distance(route[i - 1], route[i]) +
-                        instance->get_distance(route[i], route[i + 1]) +
-                        instance->get_distance(route[j - 1], route[j]);
-        modified_cost = instance->get_distance(route[j - 1], route[i]) +
-                        instance->get_distance(route[i], route[j]) +
-                        instance->get_distance(route[i - 1], route[i + 1]);
+        original_cost = instance->distance(route[i - 1], route[i]) +
+                        instance->distance(route[i], route[i + 1]) +
+                        instance->distance(route[j - 1], route[j]);
+        modified_cost = instance->distance(route[j - 1], route[i]) +
+                        instance->distance(route[i], route[j]) +
+                        instance->distance(route[i - 1], route[i + 1]);
     }
 
+    num_lookups += 6;
     double change = modified_cost - original_cost;
     if (is_accepted(change)) {
         moveItoJ(route, i, j);
@@ -342,6 +354,7 @@ bool LeaderArray::node_relocation_intra_for_individual() {
 
         isMoved = node_relocation_for_single_route(routes[random_route_idx], num_nodes_per_route[random_route_idx]);
 
+        if (isMoved) dirty_routes.mark(random_route_idx);
         searchDepth++;
     }
 
@@ -383,9 +396,10 @@ bool LeaderArray::node_relocation_between_two_routes(int *route1, int *route2, i
     // 我们还是想希望有更多的move被接受，所以此处还是使用for loop去遍历更多可接受的move
     // TODO: 之后可以把这个for loop去掉看看会发生什么
     for (int j = 0; j < length2 - 1; ++j) {
-        double old_cost = instance->get_distance(route1[i - 1], route1[i]) + instance->get_distance(route1[i], route1[i + 1]) + instance->get_distance(route2[j], route2[j + 1]);
-        double new_cost = instance->get_distance(route1[i - 1], route1[i + 1]) + instance->get_distance(route2[j], route1[i]) + instance->get_distance(route1[i], route2[j + 1]);
+        double old_cost = instance->distance(route1[i - 1], route1[i]) + instance->distance(route1[i], route1[i + 1]) + instance->distance(route2[j], route2[j + 1]);
+        double new_cost = instance->distance(route1[i - 1], route1[i + 1]) + instance->distance(route2[j], route1[i]) + instance->distance(route1[i], route2[j + 1]);
 
+        num_lookups += 6;
         double change = new_cost - old_cost;
         if (is_accepted(change)) {
             int x = route1[i];
@@ -430,6 +444,10 @@ bool LeaderArray::node_relocation_inter_for_individual() {
 
         isMoved = node_relocation_between_two_routes(routes[r1], routes[r2], num_nodes_per_route[r1], num_nodes_per_route[r2],
                                                      demand_sum_per_route[r1], demand_sum_per_route[r2]);
+        if (isMoved) {
+            dirty_routes.mark(r1);
+            dirty_routes.mark(r2);
+        }
 
         searchDepth++;
 
@@ -471,11 +489,12 @@ bool LeaderArray::node_exchange_for_single_route(int *route, int length) {
     double original_cost, modified_cost;
     // TODO: 考虑去掉这个for loop
     for (int j = i + 2; j < length - 1; ++j) {
-        original_cost = instance->get_distance(route[i - 1], route[i]) + instance->get_distance(route[i], route[i + 1])
-                        + instance->get_distance(route[j - 1], route[j]) + instance->get_distance(route[j], route[j + 1]);
-        modified_cost = instance->get_distance(route[i - 1], route[j]) + instance->get_distance(route[j], route[i + 1])
-                        + instance->get_distance(route[j - 1], route[i]) + instance->get_distance(route[i], route[j + 1]);
+        original_cost = instance->distance(route[i - 1], route[i]) + instance->distance(route[i], route[i + 1])
+                        + instance->distance(route[j - 1], route[j]) + instance->distance(route[j], route[j + 1]);
+        modified_cost = instance->distance(route[i - 1], route[j]) + instance->distance(route[j], route[i + 1])
+                        + instance->distance(route[j - 1], route[i]) + instance->distance(route[i], route[j + 1]);
 
+        num_lookups += 8;
         double change = modified_cost - original_cost;
         if (is_accepted(change)) {
             swap(route[i], route[j]);
@@ -500,6 +519,7 @@ bool LeaderArray::node_exchange_intra_for_individual() {
 
         isMoved = node_exchange_for_single_route(routes[random_route_idx], num_nodes_per_route[random_route_idx]);
 
+        if (isMoved) dirty_routes.mark(random_route_idx);
         searchDepth++;
     }
 
@@ -519,11 +539,12 @@ bool LeaderArray::node_exchange_between_two_routes(int* route1, int* route2, int
         int demand_I = instance->get_customer_demand_(route1[i]);
         int demand_J = instance->get_customer_demand_(route2[j]);
         if (loading1 - demand_I + demand_J <= instance->max_vehicle_capa_ && loading2 - demand_J + demand_I <= instance->max_vehicle_capa_) {
-            double original_cost = instance->get_distance(route1[i - 1], route1[i]) + instance->get_distance(route1[i], route1[i + 1]) +
-                                   instance->get_distance(route2[j - 1], route2[j]) + instance->get_distance(route2[j], route2[j + 1]);
-            double modified_cost = instance->get_distance(route1[i - 1], route2[j]) + instance->get_distance(route2[j], route1[i + 1]) +
-                                   instance->get_distance(route2[j - 1], route1[i]) + instance->get_distance(route1[i], route2[j + 1]);
+            double original_cost = instance->distance(route1[i - 1], route1[i]) + instance->distance(route1[i], route1[i + 1]) +
+                                   instance->distance(route2[j - 1], route2[j]) + instance->distance(route2[j], route2[j + 1]);
+            double modified_cost = instance->distance(route1[i - 1], route2[j]) + instance->distance(route2[j], route1[i + 1]) +
+                                   instance->distance(route2[j - 1], route1[i]) + instance->distance(route1[i], route2[j + 1]);
 
+            num_lookups += 8;
             double change = modified_cost - original_cost;
             if (is_accepted(change)) {
                 swap(route1[i], route2[j]);
@@ -561,6 +582,10 @@ bool LeaderArray::node_exchange_inter_for_individual() {
 
         isMoved = node_exchange_between_two_routes(routes[r1], routes[r2], num_nodes_per_route[r1], num_nodes_per_route[r2],
                                                    demand_sum_per_route[r1], demand_sum_per_route[r2]);
+        if (isMoved) {
+            dirty_routes.mark(r1);
+            dirty_routes.mark(r2);
+        }
 
         searchDepth++;
     }
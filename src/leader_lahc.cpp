@@ -11,18 +11,18 @@ int LeaderLahc::getRandomCustomerNodeU() {
 }
 
 int LeaderLahc::getRandomCorrelatedNodeV(const int &customerNode) {
-    std::uniform_int_distribution<int> dis(0, static_cast<int>(preprocessor->correlated_vertices_[customerNode].size()) - 1);
+    std::uniform_int_distribution<int> dis(0, static_cast<int>(correlatedVertices[customerNode].size()) - 1);
 
-    return preprocessor->correlated_vertices_[customerNode][dis(random_engine)];
+    return correlatedVertices[customerNode][dis(random_engine)];
 }
 
 Node* LeaderLahc::getNodeVFromCustomersAndDepots(const int &customerNode, int numNonEmptyRoutes) {
-    int correlated_vertices_size = static_cast<int>(preprocessor->correlated_vertices_[customerNode].size());
+    int correlated_vertices_size = static_cast<int>(correlatedVertices[customerNode].size());
     std::uniform_int_distribution<int> dis(0, correlated_vertices_size + numNonEmptyRoutes - 1);
     int random = dis(random_engine);
 
     if (random < correlated_vertices_size) {
-        return &clients[preprocessor->correlated_vertices_[customerNode][random]];
+        return &clients[correlatedVertices[customerNode][random]];
     } else {
         int NonEmptyRouteIndex = 0;
         for (auto & route : routes) {
@@ -104,7 +104,7 @@ void LeaderLahc::run(Individual * indiv, double penaltyCapacityLS, double penalt
     for (int i = 1; i <= instance->num_customer_; i++) {
         std::uniform_int_distribution<int> distribution(0, preprocessor->nb_granular_ - 1);
         if (distribution(random_engine) == 0) { // Random condition check
-            std::shuffle(preprocessor->correlated_vertices_[i].begin(),  preprocessor->correlated_vertices_[i].end(), random_engine);
+            std::shuffle(correlatedVertices[i].begin(),  correlatedVertices[i].end(), random_engine);
         }
     }
 
@@ -121,9 +121,9 @@ void LeaderLahc::run(Individual * indiv, double penaltyCapacityLS, double penalt
             nodeU = &clients[orderNodes[posU]];
             int lastTestRINodeU = nodeU->whenLastTestedRI;
             nodeU->whenLastTestedRI = nbMoves;
-            for (int posV = 0; posV < (int)preprocessor->correlated_vertices_[nodeU->cour].size(); posV++)
+            for (int posV = 0; posV < (int)correlatedVertices[nodeU->cour].size(); posV++)
             {
-                nodeV = &clients[preprocessor->correlated_vertices_[nodeU->cour][posV]];
+                nodeV = &clients[correlatedVertices[nodeU->cour][posV]];
                 if (loopID == 0 || std::max<int>(nodeU->route->whenLastModified, nodeV->route->whenLastModified) > lastTestRINodeU) // only evaluate moves involving routes that have been modified since last move evaluations for nodeU
                 {
                     // Randomizing the order of the neighborhoods within this loop does not matter much as we are already randomizing the order of the node pairs (and it's not very common to find improving moves of different types for the same node pair)
@@ -207,8 +207,8 @@ bool LeaderLahc::move1_intra() {
     if (routeU->nbCustomers <= 2) return false; // A route with less than 2 customers don't need to be modified
     if (nodeUIndex == nodeYIndex) return false;
 
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-    double costSuppV = instance->get_distance(nodeVIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+    double costSuppV = metered_distance(nodeVIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     double change = costSuppU + costSuppV;
     if (!isAccepted(change)) return false;
@@ -224,8 +224,8 @@ bool LeaderLahc::move1_intra() {
 bool LeaderLahc::move1_inter() {
     if (routeV->load + loadU > instance->max_vehicle_capa_) return false;
 
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-    double costSuppV = instance->get_distance(nodeVIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+    double costSuppV = metered_distance(nodeVIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     double change = costSuppU + costSuppV;
     if (!isAccepted(change)) return false;
@@ -241,8 +241,8 @@ bool LeaderLahc::move1_inter() {
 
 bool LeaderLahc::move1()
 {
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-    double costSuppV = instance->get_distance(nodeVIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+    double costSuppV = metered_distance(nodeVIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     if (routeU != routeV)
     {
@@ -268,16 +268,16 @@ bool LeaderLahc::move1()
 
 bool LeaderLahc::move2()
 {
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-    double costSuppV = instance->get_distance(nodeVIndex, nodeUIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+    double costSuppV = metered_distance(nodeVIndex, nodeUIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     if (routeU != routeV)
     {
-        costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - instance->get_distance(nodeUIndex, nodeXIndex) - serviceU - serviceX)
+        costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - metered_distance(nodeUIndex, nodeXIndex) - serviceU - serviceX)
                      + penaltyExcessLoad(routeU->load - loadU - loadX)
                      - routeU->penalty;
 
-        costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + instance->get_distance(nodeUIndex, nodeXIndex) + serviceU + serviceX)
+        costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + metered_distance(nodeUIndex, nodeXIndex) + serviceU + serviceX)
                      + penaltyExcessLoad(routeV->load + loadU + loadX)
                      - routeV->penalty;
     }
@@ -296,8 +296,8 @@ bool LeaderLahc::move2()
 
 bool LeaderLahc::move3()
 {
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-    double costSuppV = instance->get_distance(nodeVIndex, nodeXIndex) + instance->get_distance(nodeXIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+    double costSuppV = metered_distance(nodeVIndex, nodeXIndex) + metered_distance(nodeXIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     if (routeU != routeV)
     {
@@ -325,8 +325,8 @@ bool LeaderLahc::move3()
 bool LeaderLahc::move4_intra() {
     if (nodeUIndex == nodeVPrevIndex || nodeUIndex == nodeYIndex) return false;
 
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-    double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+    double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     double change = costSuppU + costSuppV;
     if (!isAccepted(change)) return false;
@@ -342,8 +342,8 @@ bool LeaderLahc::move4_intra() {
 bool LeaderLahc::move4_inter() {
     if (routeU->load + loadV - loadU > instance->max_vehicle_capa_ || routeV->load + loadU - loadV > instance->max_vehicle_capa_) return false;
 
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-    double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+    double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     double change = costSuppU + costSuppV;
     if (!isAccepted(change)) return false;
@@ -359,8 +359,8 @@ bool LeaderLahc::move4_inter() {
 
 bool LeaderLahc::move4()
 {
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeUIndex, nodeXIndex);
-    double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeUIndex, nodeYIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeUIndex, nodeXIndex);
+    double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeUIndex, nodeYIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     if (routeU != routeV)
     {
@@ -386,16 +386,16 @@ bool LeaderLahc::move4()
 
 bool LeaderLahc::move5()
 {
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeVIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-    double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeVIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+    double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     if (routeU != routeV)
     {
-        costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - instance->get_distance(nodeUIndex, nodeXIndex) + serviceV - serviceU - serviceX)
+        costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - metered_distance(nodeUIndex, nodeXIndex) + serviceV - serviceU - serviceX)
                      + penaltyExcessLoad(routeU->load + loadV - loadU - loadX)
                      - routeU->penalty;
 
-        costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + instance->get_distance(nodeUIndex, nodeXIndex) - serviceV + serviceU + serviceX)
+        costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + metered_distance(nodeUIndex, nodeXIndex) - serviceV + serviceU + serviceX)
                      + penaltyExcessLoad(routeV->load + loadU + loadX - loadV)
                      - routeV->penalty;
     }
@@ -414,16 +414,16 @@ bool LeaderLahc::move5()
 
 bool LeaderLahc::move6()
 {
-    double costSuppU = instance->get_distance(nodeUPrevIndex, nodeVIndex) + instance->get_distance(nodeYIndex, nodeXNextIndex) - instance->get_distance(nodeUPrevIndex, nodeUIndex) - instance->get_distance(nodeXIndex, nodeXNextIndex);
-    double costSuppV = instance->get_distance(nodeVPrevIndex, nodeUIndex) + instance->get_distance(nodeXIndex, nodeYNextIndex) - instance->get_distance(nodeVPrevIndex, nodeVIndex) - instance->get_distance(nodeYIndex, nodeYNextIndex);
+    double costSuppU = metered_distance(nodeUPrevIndex, nodeVIndex) + metered_distance(nodeYIndex, nodeXNextIndex) - metered_distance(nodeUPrevIndex, nodeUIndex) - metered_distance(nodeXIndex, nodeXNextIndex);
+    double costSuppV = metered_distance(nodeVPrevIndex, nodeUIndex) + metered_distance(nodeXIndex, nodeYNextIndex) - metered_distance(nodeVPrevIndex, nodeVIndex) - metered_distance(nodeYIndex, nodeYNextIndex);
 
     if (routeU != routeV)
     {
-        costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - instance->get_distance(nodeUIndex, nodeXIndex) + instance->get_distance(nodeVIndex, nodeYIndex) + serviceV + serviceY - serviceU - serviceX)
+        costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - metered_distance(nodeUIndex, nodeXIndex) + metered_distance(nodeVIndex, nodeYIndex) + serviceV + serviceY - serviceU - serviceX)
                      + penaltyExcessLoad(routeU->load + loadV + loadY - loadU - loadX)
                      - routeU->penalty;
 
-        costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex) - serviceV - serviceY + serviceU + serviceX)
+        costSuppV += penaltyExcessDuration(routeV->duration + costSuppV + metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex) - serviceV - serviceY + serviceU + serviceX)
                      + penaltyExcessLoad(routeV->load + loadU + loadX - loadV - loadY)
                      - routeV->penalty;
     }
@@ -444,7 +444,7 @@ bool LeaderLahc::move7_intra() {
     if (nodeU->position > nodeV->position) return false;
     if (nodeU->next == nodeV) return false;
 
-    double change = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex) + nodeV->cumulatedReversalDistance - nodeX->cumulatedReversalDistance;
+    double change = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex) + nodeV->cumulatedReversalDistance - nodeX->cumulatedReversalDistance;
 
     if (!isAccepted(change)) return false;
 
@@ -476,7 +476,7 @@ bool LeaderLahc::move7()
 {
     if (nodeU->position > nodeV->position) return false;
 
-    double cost = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex) + nodeV->cumulatedReversalDistance - nodeX->cumulatedReversalDistance;
+    double cost = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex) + nodeV->cumulatedReversalDistance - nodeX->cumulatedReversalDistance;
 
     if (cost > -MY_EPSILON) return false;
     if (nodeU->next == nodeV) return false;
@@ -508,9 +508,9 @@ bool LeaderLahc::move8_inter() {
     if (nodeU->cumulatedLoad + nodeV->cumulatedLoad > instance->max_vehicle_capa_ ||
         routeU->load - nodeU->cumulatedLoad + routeV->load - nodeV->cumulatedLoad > instance->max_vehicle_capa_) return false;
 
-    double change = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double change = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex);
     // this calculation actually has another version, which supports the asymmetric scenario! As shown in the following snippet:
-//    double change = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex)
+//    double change = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex)
 //                  + nodeV->cumulatedReversalDistance + routeU->reversalDistance - nodeX->cumulatedReversalDistance;
 
     if (!isAccepted(change)) return false;
@@ -581,9 +581,9 @@ bool LeaderLahc::move8_inter() {
 
 bool LeaderLahc::move8()
 {
-    double cost = instance->get_distance(nodeUIndex, nodeVIndex) + instance->get_distance(nodeXIndex, nodeYIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex)
-                  + penaltyExcessDuration(nodeU->cumulatedTime + nodeV->cumulatedTime + nodeV->cumulatedReversalDistance + instance->get_distance(nodeUIndex, nodeVIndex))
-                  + penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - instance->get_distance(nodeUIndex, nodeXIndex) + routeU->reversalDistance - nodeX->cumulatedReversalDistance + routeV->duration - nodeV->cumulatedTime - instance->get_distance(nodeVIndex, nodeYIndex) + instance->get_distance(nodeXIndex, nodeYIndex))
+    double cost = metered_distance(nodeUIndex, nodeVIndex) + metered_distance(nodeXIndex, nodeYIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex)
+                  + penaltyExcessDuration(nodeU->cumulatedTime + nodeV->cumulatedTime + nodeV->cumulatedReversalDistance + metered_distance(nodeUIndex, nodeVIndex))
+                  + penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - metered_distance(nodeUIndex, nodeXIndex) + routeU->reversalDistance - nodeX->cumulatedReversalDistance + routeV->duration - nodeV->cumulatedTime - metered_distance(nodeVIndex, nodeYIndex) + metered_distance(nodeXIndex, nodeYIndex))
                   + penaltyExcessLoad(nodeU->cumulatedLoad + nodeV->cumulatedLoad)
                   + penaltyExcessLoad(routeU->load + routeV->load - nodeU->cumulatedLoad - nodeV->cumulatedLoad)
                   - routeU->penalty - routeV->penalty
@@ -659,7 +659,7 @@ bool LeaderLahc::move9_inter() {
     if (nodeU->cumulatedLoad + routeV->load - nodeV->cumulatedLoad > instance->max_vehicle_capa_ ||
         nodeV->cumulatedLoad + routeU->load - nodeU->cumulatedLoad > instance->max_vehicle_capa_) return false;
 
-    double change = instance->get_distance(nodeUIndex, nodeYIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex);
+    double change = metered_distance(nodeUIndex, nodeYIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex);
 
     if (!isAccepted(change)) return false;
 
@@ -712,9 +712,9 @@ bool LeaderLahc::move9_inter() {
 
 bool LeaderLahc::move9()
 {
-    double cost = instance->get_distance(nodeUIndex, nodeYIndex) + instance->get_distance(nodeVIndex, nodeXIndex) - instance->get_distance(nodeUIndex, nodeXIndex) - instance->get_distance(nodeVIndex, nodeYIndex)
-                  + penaltyExcessDuration(nodeU->cumulatedTime + routeV->duration - nodeV->cumulatedTime - instance->get_distance(nodeVIndex, nodeYIndex) + instance->get_distance(nodeUIndex, nodeYIndex))
-                  + penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - instance->get_distance(nodeUIndex, nodeXIndex) + nodeV->cumulatedTime + instance->get_distance(nodeVIndex, nodeXIndex))
+    double cost = metered_distance(nodeUIndex, nodeYIndex) + metered_distance(nodeVIndex, nodeXIndex) - metered_distance(nodeUIndex, nodeXIndex) - metered_distance(nodeVIndex, nodeYIndex)
+                  + penaltyExcessDuration(nodeU->cumulatedTime + routeV->duration - nodeV->cumulatedTime - metered_distance(nodeVIndex, nodeYIndex) + metered_distance(nodeUIndex, nodeYIndex))
+                  + penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - metered_distance(nodeUIndex, nodeXIndex) + nodeV->cumulatedTime + metered_distance(nodeVIndex, nodeXIndex))
                   + penaltyExcessLoad(nodeU->cumulatedLoad + routeV->load - nodeV->cumulatedLoad)
                   + penaltyExcessLoad(nodeV->cumulatedLoad + routeU->load - nodeU->cumulatedLoad)
                   - routeU->penalty - routeV->penalty;
@@ -815,7 +815,7 @@ bool LeaderLahc::swapStar()
         SwapStarElement mySwapStar;
         mySwapStar.U = nodeU;
         mySwapStar.bestPositionU = bestInsertClient[routeV->cour][nodeU->cour].bestLocation[0];
-        double deltaDistRouteU = instance->get_distance(nodeU->prev->cour, nodeU->next->cour) - instance->get_distance(nodeU->prev->cour, nodeU->cour) - instance->get_distance(nodeU->cour, nodeU->next->cour);
+        double deltaDistRouteU = metered_distance(nodeU->prev->cour, nodeU->next->cour) - metered_distance(nodeU->prev->cour, nodeU->cour) - metered_distance(nodeU->cour, nodeU->next->cour);
         double deltaDistRouteV = bestInsertClient[routeV->cour][nodeU->cour].bestCost[0];
         mySwapStar.moveCost = deltaDistRouteU + deltaDistRouteV
                               + penaltyExcessLoad(routeU->load - preprocessor->customers_[nodeU->cour].demand) - routeU->penalty
@@ -834,7 +834,7 @@ bool LeaderLahc::swapStar()
         mySwapStar.V = nodeV;
         mySwapStar.bestPositionV = bestInsertClient[routeU->cour][nodeV->cour].bestLocation[0];
         double deltaDistRouteU = bestInsertClient[routeU->cour][nodeV->cour].bestCost[0];
-        double deltaDistRouteV = instance->get_distance(nodeV->prev->cour, nodeV->next->cour) - instance->get_distance(nodeV->prev->cour, nodeV->cour) - instance->get_distance(nodeV->cour, nodeV->next->cour);
+        double deltaDistRouteV = metered_distance(nodeV->prev->cour, nodeV->next->cour) - metered_distance(nodeV->prev->cour, nodeV->cour) - metered_distance(nodeV->cour, nodeV->next->cour);
         mySwapStar.moveCost = deltaDistRouteU + deltaDistRouteV
                               + penaltyExcessLoad(routeU->load + preprocessor->customers_[nodeV->cour].demand) - routeU->penalty
                               + penaltyExcessLoad(routeV->load - preprocessor->customers_[nodeV->cour].demand) - routeV->penalty
@@ -880,7 +880,7 @@ double LeaderLahc::getCheapestInsertSimultRemoval(Node * U, Node * V, Node *& be
     }
 
     // Compute insertion in the place of V
-    double deltaCost = instance->get_distance(V->prev->cour, U->cour) + instance->get_distance(U->cour, V->next->cour) - instance->get_distance(V->prev->cour, V->next->cour);
+    double deltaCost = metered_distance(V->prev->cour, U->cour) + metered_distance(U->cour, V->next->cour) - metered_distance(V->prev->cour, V->next->cour);
     if (!found || deltaCost < bestCost)
     {
         bestPosition = V->prev;
@@ -895,16 +895,16 @@ void LeaderLahc::preprocessInsertions(Route * R1, Route * R2)
     for (Node * U = R1->depot->next; !U->isDepot; U = U->next)
     {
         // Performs the preprocessing
-        U->deltaRemoval = instance->get_distance(U->prev->cour, U->next->cour) - instance->get_distance(U->prev->cour, U->cour) - instance->get_distance(U->cour, U->next->cour);
+        U->deltaRemoval = metered_distance(U->prev->cour, U->next->cour) - metered_distance(U->prev->cour, U->cour) - metered_distance(U->cour, U->next->cour);
         if (R2->whenLastModified > bestInsertClient[R2->cour][U->cour].whenLastCalculated)
         {
             bestInsertClient[R2->cour][U->cour].reset();
             bestInsertClient[R2->cour][U->cour].whenLastCalculated = nbMoves;
-            bestInsertClient[R2->cour][U->cour].bestCost[0] = instance->get_distance(0, U->cour) + instance->get_distance(U->cour, R2->depot->next->cour) - instance->get_distance(0, R2->depot->next->cour);
+            bestInsertClient[R2->cour][U->cour].bestCost[0] = metered_distance(0, U->cour) + metered_distance(U->cour, R2->depot->next->cour) - metered_distance(0, R2->depot->next->cour);
             bestInsertClient[R2->cour][U->cour].bestLocation[0] = R2->depot;
             for (Node * V = R2->depot->next; !V->isDepot; V = V->next)
             {
-                double deltaCost = instance->get_distance(V->cour, U->cour) + instance->get_distance(U->cour, V->next->cour) - instance->get_distance(V->cour, V->next->cour);
+                double deltaCost = metered_distance(V->cour, U->cour) + metered_distance(U->cour, V->next->cour) - metered_distance(V->cour, V->next->cour);
                 bestInsertClient[R2->cour][U->cour].compareAndAdd(deltaCost, V);
             }
         }
@@ -967,8 +967,8 @@ void LeaderLahc::updateRouteData(Route * myRoute)
         myplace++;
         mynode->position = myplace;
         myload += preprocessor->customers_[mynode->cour].demand;
-        mytime += instance->get_distance(mynode->prev->cour, mynode->cour) + preprocessor->customers_[mynode->cour].service_duration;
-        myReversalDistance += instance->get_distance(mynode->cour, mynode->prev->cour) - instance->get_distance(mynode->prev->cour, mynode->cour) ;
+        mytime += metered_distance(mynode->prev->cour, mynode->cour) + preprocessor->customers_[mynode->cour].service_duration;
+        myReversalDistance += metered_distance(mynode->cour, mynode->prev->cour) - metered_distance(mynode->prev->cour, mynode->cour) ;
         mynode->cumulatedLoad = myload;
         mynode->cumulatedTime = mytime;
         mynode->cumulatedReversalDistance = myReversalDistance;
@@ -1069,7 +1069,7 @@ void LeaderLahc::exportIndividual(Individual * indiv)
         }
     }
 
-    indiv->evaluate_upper_cost();
+    num_lookups += indiv->evaluate_upper_cost();
 }
 
 void LeaderLahc::exportChromosome(Individual *ind) {
@@ -1109,7 +1109,7 @@ double LeaderLahc::getUpperCost() const {
     return upperCost;
 }
 
-LeaderLahc::LeaderLahc(int seed, Case* instance, Preprocessor* preprocessor) : instance(instance), preprocessor(preprocessor)
+LeaderLahc::LeaderLahc(int seed, const Case* instance, const Preprocessor* preprocessor) : instance(instance), preprocessor(preprocessor)
 {
     clients = std::vector < Node >(instance->num_customer_ + 1);
     routes = std::vector < Route >(preprocessor->route_cap_);
@@ -1134,6 +1134,7 @@ LeaderLahc::LeaderLahc(int seed, Case* instance, Preprocessor* preprocessor) : i
         depotsEnd[i].route = &routes[i];
     }
     for (int i = 1 ; i <= instance->num_customer_ ; i++) orderNodes.push_back(i);
+    correlatedVertices = preprocessor->correlated_vertices_;
     for (int r = 0 ; r < preprocessor->route_cap_ ; r++) orderRoutes.push_back(r);
 
     random_engine = std::default_random_engine(seed);
@@ -0,0 +1,96 @@
+#include "mapped_file.hpp"
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FROGS_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& file_path) {
+    open(file_path);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          opened_(std::exchange(other.opened_, false)),
+          is_mapped_(std::exchange(other.is_mapped_, false)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        opened_ = std::exchange(other.opened_, false);
+        is_mapped_ = std::exchange(other.is_mapped_, false);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& file_path) {
+    close();
+
+#ifdef FROGS_HAS_MMAP
+    const int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    opened_ = true;
+    if (size_ > 0) {
+        void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            opened_ = false;
+            return false;
+        }
+        madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+        is_mapped_ = true;
+    }
+    ::close(fd); // the mapping keeps its own reference to the file
+    return true;
+#else
+    std::ifstream infile(file_path, std::ios::binary | std::ios::ate);
+    if (!infile) return false;
+
+    size_ = static_cast<std::size_t>(infile.tellg());
+    opened_ = true;
+    if (size_ > 0) {
+        char* buffer = new char[size_];
+        infile.seekg(0);
+        infile.read(buffer, static_cast<std::streamsize>(size_));
+        data_ = buffer;
+    }
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+#ifdef FROGS_HAS_MMAP
+        if (is_mapped_) munmap(const_cast<char*>(data_), size_);
+#else
+        delete[] data_;
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+    is_mapped_ = false;
+}
@@ -3,8 +3,13 @@
 //
 
 #include "preprocessor.hpp"
+#include "instance_cache.hpp"
+#include "parallel.hpp"
 
 const int Preprocessor::MAX_EVALUATION_FACTOR = 25'000;
+const int Preprocessor::kScannedStations = 128;
+const int Preprocessor::kNearbyCustomers = 64;
+const int Preprocessor::kLazyStationsPerNode = 8;
 
 Preprocessor::Preprocessor(const Case &c, const Parameters &params) : c(c), params(params) {
 
@@ -25,22 +30,6 @@ Preprocessor::Preprocessor(const Case &c, const Parameters &params) : c(c), para
     this->route_cap_ = 3 * c.num_vehicle_;
     this->node_cap_ = c.num_customer_ * 2; // for the boarder condition, for example E-n23-k3, a route almost contains all the customers
     this->max_cruise_distance_ = c.max_battery_capa_ / c.energy_consumption_rate_;
-    for (int i = 0; i < c.problem_size_; i++) {
-        for (int j = 0; j < c.problem_size_; j++) {
-            if (c.distances_[i][j] > max_distance_) max_distance_ = c.distances_[i][j];
-        }
-    }
-
-    if (params.is_hard_constraint) {
-        // A great penalty for the hard constraint
-        this->penalty_capacity_ = 1e10;
-        this->penalty_duration_ = 1e10;
-    } else {
-        // A reasonable scale for the initial values of the penalties
-        this->penalty_capacity_ = std::max<double>(0.1, std::min<double>(1000., max_distance_ / max_demand_));
-        this->penalty_duration_ = 1;
-    }
-    this->is_duration_constraint_ = params.is_duration_constraint;
 
     this->customers_ = vector<Customer>(c.num_customer_ + 1);
     customers_[0].coord_x = c.positions_[0].first;
@@ -57,33 +46,76 @@ Preprocessor::Preprocessor(const Case &c, const Parameters &params) : c(c), para
         station_ids_.push_back(i);
     }
 
-    this->sorted_nearby_customers_ = vector<vector<int>>(c.num_customer_ + 1);
-    for (int i = 1; i <= c.num_customer_; i++) {
-        for (auto node : customer_ids_) {
-            if (node == i) continue;
-            sorted_nearby_customers_[i].push_back(node);
-        }
+    this->station_index_.build(c, station_ids_);
+    this->customer_index_.build(c, customer_ids_);
+
+    // The O(n^2) tables are either read from the instance cache or built, and then cached for the next runs
+    InstanceCache cache;
+    const bool use_cache = params.enable_instance_cache && !c.matrix_free_;
+    if (use_cache && cache.open(c, nb_granular_)) {
+        PhaseTimer timer;
+        load_tables(cache);
+        timer.lap("cached tables");
+        this->startup_phases_ = timer.phases();
+    } else {
+        build_tables();
+        if (use_cache) InstanceCache::save(c, *this);
+    }
 
-        sort(sorted_nearby_customers_[i].begin(), sorted_nearby_customers_[i].end(), [&](const int a, const int b) {
-            return c.distances_[i][a] < c.distances_[i][b];
-        });
+    if (params.is_hard_constraint) {
+        // A great penalty for the hard constraint
+        this->penalty_capacity_ = 1e10;
+        this->penalty_duration_ = 1e10;
+    } else {
+        // A reasonable scale for the initial values of the penalties
+        this->penalty_capacity_ = std::max<double>(0.1, std::min<double>(1000., max_distance_ / max_demand_));
+        this->penalty_duration_ = 1;
     }
+    this->is_duration_constraint_ = params.is_duration_constraint;
+}
+
+void Preprocessor::build_tables() {
+    // Rows are independent: each block of rows is handled by one thread, reading distances through
+    // Case::distances_from so the same code runs on both distance backends
+    PhaseTimer timer;
+    const int num_threads = params.build_threads;
+    const int grain = 16;
+
+    // The matrix is symmetric, so the maximum is taken over the upper triangle only
+    vector<double> row_max(c.problem_size_, 0.0);
+    parallel_for_blocks(0, c.problem_size_, grain, [&](const int first, const int last) {
+        vector<double> row(c.problem_size_);
+        for (int i = first; i < last; i++) {
+            c.distances_from(i, i, c.problem_size_, row.data());
+            row_max[i] = *std::max_element(row.begin(), row.begin() + (c.problem_size_ - i));
+        }
+    }, num_threads);
+    max_distance_ = std::max(max_distance_, *std::max_element(row_max.begin(), row_max.end()));
+    timer.lap("max distance");
+
+    // Only the nearest customers are kept, from the k-d tree instead of sorting whole rows; Hien's clustering asks
+    // nearby_customers() for more in the rare cases it needs them
+    const int num_nearby = std::min<int>(kNearbyCustomers, std::max(c.num_customer_ - 1, 0));
+    this->sorted_nearby_customers_ = vector<vector<int>>(c.num_customer_ + 1);
+    parallel_for(1, c.num_customer_ + 1, [&](const int i) {
+        customer_index_.nearest(i, num_nearby, sorted_nearby_customers_[i]);
+    }, num_threads, grain);
+    timer.lap("nearby customers");
 
     // Local search (acceleration), Calculation of the correlated vertices for each customer (for the granular restriction)
+    const int nb_correlated = std::min<int>(nb_granular_, c.num_customer_ - 1);
+    vector<vector<int>> nearest(c.num_customer_ + 1);
+    parallel_for(1, c.num_customer_ + 1, [&](const int i) {
+        customer_index_.nearest(i, nb_correlated, nearest[i]);
+    }, num_threads, grain);
+
     correlated_vertices_ = vector<vector<int>>(c.num_customer_ + 1);
     vector<set<int>> set_correlated_vertices = vector<set<int>>(c.num_customer_ + 1);
-    vector<pair<double, int>> order_proximity;
     for (int i = 1; i <= c.num_customer_; i++) {
-        order_proximity.clear();
-        for (int j = 1; j <= c.num_customer_; j++) {
-            if (i == j) continue;
-            order_proximity.emplace_back(c.distances_[i][j], j);
-        }
-        std::sort(order_proximity.begin(), order_proximity.end());
-        for (int j = 0; j < std::min<int>(nb_granular_, c.num_customer_ - 1); ++j) {
+        for (const int x : nearest[i]) {
             //  if i is correlated with j, then j should be correlated with i
-            set_correlated_vertices[i].insert(order_proximity[j].second);
-            set_correlated_vertices[order_proximity[j].second].insert(i);
+            set_correlated_vertices[i].insert(x);
+            set_correlated_vertices[x].insert(i);
         }
     }
     for (int i = 1; i <= c.num_customer_; i++) {
@@ -91,22 +123,83 @@ Preprocessor::Preprocessor(const Case &c, const Parameters &params) : c(c), para
             correlated_vertices_[i].push_back(x);
         }
     }
+    timer.lap("correlated vertices");
 
-    // Make charging decision, filling the vector with correlated vertices
-    this->best_station_ = std::vector<std::vector<int>>(c.num_depot_ + c.num_customer_,std::vector<int>(c.num_depot_ + c.num_customer_));
-    for (int i = 0; i < c.num_depot_ + c.num_customer_ - 1; i++) {
-        for (int j = i + 1; j < c.num_depot_ + c.num_customer_; j++) {
-            this->best_station_[i][j] = this->best_station_[j][i] = get_best_station(i, j);
-        }
+    // Make charging decision. The search only asks for arcs between nearby customers and for the arcs of the depot,
+    // so those are computed here, the others on their first lookup through best_station()
+    const int num_nodes = c.num_depot_ + c.num_customer_;
+    if (c.matrix_free_) {
+        this->best_station_.resize_sparse(num_nodes, correlated_vertices_, static_cast<size_t>(kLazyStationsPerNode) * num_nodes);
+    } else {
+        this->best_station_.resize(num_nodes, c.problem_size_);
     }
+    if (c.num_station_ > kScannedStations) {
+        parallel_for(0, num_nodes, [&](const int i) {
+            best_station_.set(i, i, 0);
+            if (i != 0) best_station_.set(0, i, get_best_station(0, i));
+            for (const int x : correlated_vertices_[i]) best_station_.set(i, x, get_best_station(i, x));
+        }, num_threads, grain);
+    } else {
+        // Same choice as get_best_station (the smallest id among the smallest detours), from a table of the
+        // customer-to-station distances computed once
+        const int first_station = c.num_customer_ + 1;
+        const int num_station = c.problem_size_ - first_station;
+        vector<double> station_distances(static_cast<size_t>(num_nodes) * num_station);
+        parallel_for(0, num_nodes, [&](const int i) {
+            c.distances_from(i, first_station, c.problem_size_, station_distances.data() + static_cast<size_t>(i) * num_station);
+        }, num_threads, grain);
+        auto scan = [&](const int i, const int j) {
+            const double* from_row = station_distances.data() + static_cast<size_t>(i) * num_station;
+            const double* to_row = station_distances.data() + static_cast<size_t>(j) * num_station;
+            int target_station = -1;
+            double min_dis = std::numeric_limits<double>::max();
+            for (int s = 0; s < num_station; ++s) {
+                if (const double dis = from_row[s] + to_row[s]; min_dis > dis) {
+                    target_station = first_station + s;
+                    min_dis = dis;
+                }
+            }
+            best_station_.set(i, j, target_station);
+        };
+        parallel_for(0, num_nodes, [&](const int i) {
+            best_station_.set(i, i, 0);
+            if (i != 0) scan(0, i);
+            for (const int x : correlated_vertices_[i]) scan(i, x);
+        }, num_threads, grain);
+    }
+    timer.lap("best stations");
+
+    this->startup_phases_ = timer.phases();
+}
+
+void Preprocessor::load_tables(const InstanceCache& cache) {
+    this->max_distance_ = cache.header().max_distance;
+    this->sorted_nearby_customers_ = cache.sorted_nearby_customers();
+    this->correlated_vertices_ = cache.correlated_vertices();
+    this->best_station_.resize(c.num_depot_ + c.num_customer_, c.problem_size_);
+    this->best_station_.load(cache.best_station());
+}
+
+const vector<int>& Preprocessor::nearby_customers(const int customer, const int count, vector<int>& extended) const {
+    const vector<int>& row = sorted_nearby_customers_[customer];
+    const int num_others = std::max(c.num_customer_ - 1, 0);
+    if (count <= static_cast<int>(row.size()) || static_cast<int>(row.size()) == num_others) return row;
+    customer_index_.nearest(customer, std::min(count, num_others), extended);
+    return extended;
+}
+
+int Preprocessor::fill_best_station(const int from, const int to) const {
+    return best_station_.set(from, to, from == to ? 0 : get_best_station(from, to));
 }
 
 int Preprocessor::get_best_station(const int from, const int to) const {
+    if (c.num_station_ > kScannedStations) return station_index_.best_detour(from, to);
+
     int target_station = -1;
     double min_dis = std::numeric_limits<double>::max();
 
     for (int i = c.num_customer_ + 1 ; i < c.problem_size_; ++i) {
-        if (const double dis = c.distances_[from][i] + c.distances_[to][i]; min_dis > dis && from != i && to != i) {
+        if (const double dis = c.distance(from, i) + c.distance(to, i); min_dis > dis && from != i && to != i) {
             target_station = i;
             min_dis = dis;
         }
@@ -116,19 +209,21 @@ int Preprocessor::get_best_station(const int from, const int to) const {
 }
 
 int Preprocessor::get_best_and_feasible_station(const int from, const int to, const double max_dis) const {
+    if (c.num_station_ > kScannedStations) return station_index_.best_detour(from, to, max_dis, max_cruise_distance_);
+
     int target_station = -1;
     double min_dis = std::numeric_limits<double>::max();
 
     for (int i = c.num_customer_ + 1; i < c.problem_size_; ++i) {
-        if (c.distances_[from][i] < max_dis &&
-            min_dis > c.distances_[from][i]  + c.distances_[to][i]  &&
+        if (c.distance(from, i) < max_dis &&
+            min_dis > c.distance(from, i)  + c.distance(to, i)  &&
             from != i && to != i &&
-            c.distances_[i][to] < max_cruise_distance_) {
+            c.distance(i, to) < max_cruise_distance_) {
 
             target_station = i;
-            min_dis = c.distances_[from][i] + c.distances_[to][i];
+            min_dis = c.distance(from, i) + c.distance(to, i);
         }
     }
 
     return target_station;
-}
\ No newline at end of file
+}
@@ -0,0 +1,58 @@
+#include "route_cache.hpp"
+#include <algorithm>
+#include <cstring>
+
+const int RouteCache::kWays = 4;
+
+void RouteCache::resize(const size_t capacity) {
+    entries_.clear();
+    clock_ = 0;
+    hits_ = 0;
+    misses_ = 0;
+    if (capacity == 0) return;
+
+    size_t num_sets = 1;
+    while (num_sets * kWays < capacity) num_sets <<= 1;
+    entries_.resize(num_sets * kWays);
+    set_mask_ = num_sets - 1;
+}
+
+uint64_t RouteCache::hash(const int* route, const int length) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(length);
+    for (int i = 0; i < length; ++i) {
+        h = (h ^ static_cast<uint32_t>(route[i])) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+const RouteCache::Entry* RouteCache::find(const uint64_t hash, const int* route, const int length) {
+    Entry* set = &entries_[(hash & set_mask_) * kWays];
+    for (int way = 0; way < kWays; ++way) {
+        Entry& entry = set[way];
+        if (entry.stamp != 0 && entry.hash == hash && entry.length == length &&
+            std::memcmp(entry.nodes.data(), route, sizeof(int) * length) == 0) {
+            entry.stamp = ++clock_;
+            ++hits_;
+            return &entry;
+        }
+    }
+    ++misses_;
+    return nullptr;
+}
+
+void RouteCache::insert(const uint64_t hash, const int* route, const int length, const int* repaired,
+                        const int repaired_length, const double cost, const uint64_t lookups) {
+    // The empty or least recently used entry of the set; its buffer is reused, so a warm cache does not allocate
+    Entry* set = &entries_[(hash & set_mask_) * kWays];
+    Entry* victim = std::min_element(set, set + kWays, [](const Entry& a, const Entry& b) { return a.stamp < b.stamp; });
+    victim->hash = hash;
+    victim->stamp = ++clock_;
+    victim->cost = cost;
+    victim->lookups = lookups;
+    victim->length = length;
+    victim->repaired_length = repaired_length;
+    victim->nodes.resize(length + repaired_length);
+    std::memcpy(victim->nodes.data(), route, sizeof(int) * length);
+    std::memcpy(victim->nodes.data() + length, repaired, sizeof(int) * repaired_length);
+}
@@ -0,0 +1,74 @@
+#include "shared_best.hpp"
+
+SharedBest::Reader::Reader(const SharedBest& shared) : shared_(shared) {
+    // Sequentially consistent, so that a publisher that sees no reader after its swap knows none got the old snapshot
+    shared_.readers_.fetch_add(1, std::memory_order_seq_cst);
+    snapshot_ = shared_.best_.load(std::memory_order_seq_cst);
+}
+
+SharedBest::Reader::~Reader() {
+    shared_.readers_.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+SharedBest::~SharedBest() {
+    for (const Snapshot* snapshot : retired_) delete snapshot;
+    delete best_.load(std::memory_order_acquire);
+}
+
+bool SharedBest::publish(const Individual& solution, const int publisher) {
+    // Most candidates are not better than the group's best, reject them before copying
+    if (solution.lower_cost >= best_cost()) return false;
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start_).count();
+    const Snapshot* snapshot = keep_solutions_ ? new Snapshot{solution, solution.lower_cost, seconds, publisher} : nullptr;
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (solution.lower_cost >= best_cost_.load(std::memory_order_relaxed)) {
+        delete snapshot;
+        return false;
+    }
+    if (snapshot != nullptr) {
+        if (const Snapshot* replaced = best_.exchange(snapshot, std::memory_order_seq_cst)) retired_.push_back(replaced);
+    }
+    best_cost_.store(solution.lower_cost, std::memory_order_release);
+    improvements_.push_back({solution.lower_cost, seconds, publisher});
+    reclaim();
+    return true;
+}
+
+void SharedBest::reclaim() {
+    // A reader that comes after this check loads the snapshot swapped in before it, so none of the retired ones
+    if (retired_.empty() || readers_.load(std::memory_order_seq_cst) != 0) return;
+    for (const Snapshot* snapshot : retired_) delete snapshot;
+    retired_.clear();
+}
+
+SharedBest::Improvement SharedBest::best_improvement() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return improvements_.empty() ? Improvement() : improvements_.back();
+}
+
+vector<SharedBest::Improvement> SharedBest::improvements() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return improvements_;
+}
+
+double SharedBest::seconds_to_reach(const double target) const {
+    // Costs decrease in publish order, but a publisher may take its time after its clock read, take the earliest
+    const std::lock_guard<std::mutex> lock(mutex_);
+    double seconds = -1.0;
+    for (const Improvement& improvement : improvements_) {
+        if (improvement.cost <= target && (seconds < 0.0 || improvement.seconds < seconds)) seconds = improvement.seconds;
+    }
+    return seconds;
+}
+
+int SharedBest::num_improvements() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(improvements_.size());
+}
+
+size_t SharedBest::num_snapshots() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return retired_.size() + (best_.load(std::memory_order_acquire) != nullptr);
+}
@@ -0,0 +1,156 @@
+#include "spatial_index.hpp"
+
+const int SpatialIndex::kLeafSize = 8;
+
+namespace {
+
+// Lower bounds are shrunk by this factor before pruning, so that rounding in the bound (or a distance_t matrix
+// rounded below the exact value) never discards a node the linear scan would pick
+const double kBoundSlack = 1.0 - 1e-6;
+const int kMaxDepth = 64;
+
+} // namespace
+
+SpatialIndex::SpatialIndex(const Case& c, const vector<int>& nodes) {
+    build(c, nodes);
+}
+
+void SpatialIndex::build(const Case& c, const vector<int>& nodes) {
+    this->c_ = &c;
+    this->ids_ = nodes;
+    this->tree_.clear();
+    if (ids_.empty()) return;
+
+    tree_.reserve(2 * (ids_.size() / kLeafSize + 1));
+    build_subtree(0, static_cast<int>(ids_.size()));
+
+    xs_.resize(ids_.size());
+    ys_.resize(ids_.size());
+    for (size_t p = 0; p < ids_.size(); ++p) {
+        xs_[p] = c.positions_[ids_[p]].first;
+        ys_[p] = c.positions_[ids_[p]].second;
+    }
+}
+
+int SpatialIndex::build_subtree(const int begin, const int end) {
+    TreeNode box{numeric_limits<double>::max(), numeric_limits<double>::max(),
+                 numeric_limits<double>::lowest(), numeric_limits<double>::lowest(), begin, end, -1, -1};
+    for (int p = begin; p < end; ++p) {
+        const auto& [x, y] = c_->positions_[ids_[p]];
+        box.min_x = std::min(box.min_x, x);
+        box.min_y = std::min(box.min_y, y);
+        box.max_x = std::max(box.max_x, x);
+        box.max_y = std::max(box.max_y, y);
+    }
+
+    const int index = static_cast<int>(tree_.size());
+    tree_.push_back(box);
+    if (end - begin <= kLeafSize) return index;
+
+    // Split at the median of the wider side, ties ordered by id so that the tree does not depend on the input order
+    const bool split_x = box.max_x - box.min_x >= box.max_y - box.min_y;
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element(ids_.begin() + begin, ids_.begin() + middle, ids_.begin() + end, [&](const int a, const int b) {
+        const double ka = split_x ? c_->positions_[a].first : c_->positions_[a].second;
+        const double kb = split_x ? c_->positions_[b].first : c_->positions_[b].second;
+        return ka != kb ? ka < kb : a < b;
+    });
+    const int left = build_subtree(begin, middle);
+    const int right = build_subtree(middle, end);
+    tree_[index].left = left;
+    tree_[index].right = right;
+    return index;
+}
+
+double SpatialIndex::box_distance(const TreeNode& box, const int node) const {
+    const auto& [x, y] = c_->positions_[node];
+    const double dx = std::max({box.min_x - x, 0.0, x - box.max_x});
+    const double dy = std::max({box.min_y - y, 0.0, y - box.max_y});
+    return std::sqrt(dx * dx + dy * dy) * kBoundSlack;
+}
+
+int SpatialIndex::best_detour(const int from, const int to, const double max_from, const double max_to) const {
+    int best = -1;
+    double best_dis = numeric_limits<double>::max();
+    if (tree_.empty()) return best;
+
+    // Depth-first, closer child first; each entry carries the lower bound of the detour through its box
+    pair<int, double> stack[kMaxDepth + 1];
+    int top = 0;
+    stack[top++] = {0, 0.0};
+    while (top > 0) {
+        const auto [index, bound] = stack[--top];
+        if (bound > best_dis) continue;
+        const TreeNode& box = tree_[index];
+
+        if (box.left < 0) {
+            for (int p = box.begin; p < box.end; ++p) {
+                const int s = ids_[p];
+                if (s == from || s == to) continue;
+                const double from_dis = c_->distance(from, s);
+                if (!(from_dis < max_from) || !(c_->distance(s, to) < max_to)) continue;
+                if (const double dis = from_dis + c_->distance(to, s); dis < best_dis || (dis == best_dis && s < best)) {
+                    best = s;
+                    best_dis = dis;
+                }
+            }
+            continue;
+        }
+
+        double bounds[2];
+        const int children[2] = {box.left, box.right};
+        for (int k = 0; k < 2; ++k) {
+            const TreeNode& child = tree_[children[k]];
+            const double bound_from = box_distance(child, from);
+            const double bound_to = box_distance(child, to);
+            // boxes out of range get an infinite bound and are never pushed
+            bounds[k] = bound_from >= max_from || bound_to >= max_to ? numeric_limits<double>::infinity() : bound_from + bound_to;
+        }
+        const int first = bounds[0] <= bounds[1] ? 0 : 1;
+        if (bounds[1 - first] <= best_dis) stack[top++] = {children[1 - first], bounds[1 - first]};
+        if (bounds[first] <= best_dis) stack[top++] = {children[first], bounds[first]};
+    }
+
+    return best;
+}
+
+void SpatialIndex::nearest(const int node, const int k, vector<int>& out) const {
+    out.clear();
+    if (tree_.empty() || k <= 0) return;
+
+    // Max-heap of the k best (distance, id) pairs found so far
+    vector<pair<double, int>> heap;
+    heap.reserve(k + 1);
+    int stack[kMaxDepth + 1];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const TreeNode& box = tree_[stack[--top]];
+        if (static_cast<int>(heap.size()) == k && box_distance(box, node) > heap.front().first) continue;
+
+        if (box.left < 0) {
+            for (int p = box.begin; p < box.end; ++p) {
+                const int s = ids_[p];
+                if (s == node) continue;
+                const pair<double, int> candidate(c_->distance(node, s), s);
+                if (static_cast<int>(heap.size()) < k) {
+                    heap.push_back(candidate);
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (candidate < heap.front()) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = candidate;
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+            continue;
+        }
+
+        const double left_bound = box_distance(tree_[box.left], node);
+        const double right_bound = box_distance(tree_[box.right], node);
+        stack[top++] = left_bound <= right_bound ? box.right : box.left;
+        stack[top++] = left_bound <= right_bound ? box.left : box.right;
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto& [dis, id] : heap) out.push_back(id);
+}
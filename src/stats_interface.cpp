@@ -3,6 +3,9 @@
 //
 
 #include "stats_interface.hpp"
+#include "evolution_log.hpp"
+
+StatsInterface::~StatsInterface() = default;
 
 Indicators StatsInterface::calculate_statistical_indicators(const std::vector<double>& data) {
     Indicators indicators;
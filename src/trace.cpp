@@ -0,0 +1,220 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+const char TraceFormat::kMagic[8] = {'F', 'R', 'O', 'G', 'S', 'T', 'R', '\0'};
+const uint32_t TraceFormat::kVersion = 1;
+const size_t TraceFormat::kMaxNameLength = 23;
+const size_t TraceFormat::kHeaderSize = 32;
+const size_t TraceFormat::kColumnSize = 32;
+
+const size_t TraceWriter::kBlockRows = 4096;
+
+namespace {
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_columns;
+    uint64_t block_rows;
+    uint64_t reserved;
+};
+struct ColumnDescriptor {
+    char name[24];
+    uint32_t type;
+    uint32_t reserved;
+};
+static_assert(sizeof(Header) == 32 && sizeof(ColumnDescriptor) == 32, "trace descriptors must keep their on-disk size");
+
+} // namespace
+
+TraceWriter::TraceWriter(const string& path, const vector<TraceColumn>& columns, const size_t block_rows, const long resume_rows,
+                         const vector<uint64_t>& pending)
+    : num_columns_(columns.size()), block_rows_(block_rows) {
+    if (columns.empty() || block_rows == 0) throw runtime_error("trace: no columns or empty blocks");
+    block_.assign(1 + num_columns_ * block_rows_, 0);
+    block_offset_ = TraceFormat::data_offset(num_columns_);
+    if (resume_rows >= 0) {
+        reopen(path, columns, resume_rows, pending);
+        return;
+    }
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) throw runtime_error("trace: can not open " + path);
+    write_header(columns);
+}
+
+void TraceWriter::write_header(const vector<TraceColumn>& columns) {
+    Header header{};
+    std::memcpy(header.magic, TraceFormat::kMagic, sizeof(header.magic));
+    header.version = TraceFormat::kVersion;
+    header.num_columns = static_cast<uint32_t>(num_columns_);
+    header.block_rows = block_rows_;
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& column : columns) {
+        if (column.name.size() > TraceFormat::kMaxNameLength) throw runtime_error("trace: column name too long: " + column.name);
+        ColumnDescriptor descriptor{};
+        std::memcpy(descriptor.name, column.name.data(), column.name.size());
+        descriptor.type = static_cast<uint32_t>(column.type);
+        file_.write(reinterpret_cast<const char*>(&descriptor), sizeof(descriptor));
+    }
+    file_.flush();
+}
+
+void TraceWriter::reopen(const string& path, const vector<TraceColumn>& columns, const long resume_rows,
+                         const vector<uint64_t>& pending) {
+    if (resume_rows % static_cast<long>(block_rows_) != 0 || pending.size() % num_columns_ != 0 ||
+        pending.size() / num_columns_ >= block_rows_) {
+        throw runtime_error("trace: resumed rows do not fit the blocks of " + path);
+    }
+    {
+        const TraceReader reader(path);
+        bool same = reader.num_columns() == num_columns_ && reader.block_rows() == block_rows_;
+        for (size_t c = 0; same && c < num_columns_; ++c) {
+            same = reader.column(c).name == columns[c].name && reader.column(c).type == columns[c].type;
+        }
+        if (!same) throw runtime_error("trace: different layout in " + path);
+        if (reader.num_rows() < static_cast<size_t>(resume_rows)) throw runtime_error("trace: fewer rows than resumed in " + path);
+    }
+
+    // The full blocks stay, the rows of the current block come from the checkpoint
+    rows_in_block_ = pending.size() / num_columns_;
+    for (size_t c = 0; c < num_columns_; ++c) {
+        std::copy_n(pending.begin() + static_cast<long>(c * rows_in_block_), rows_in_block_, block_.begin() + 1 + static_cast<long>(c * block_rows_));
+    }
+    block_offset_ += resume_rows / block_rows_ * TraceFormat::block_bytes(num_columns_, block_rows_);
+    num_rows_ = resume_rows + static_cast<long>(rows_in_block_);
+    std::filesystem::resize_file(path, block_offset_);
+    file_.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file_) throw runtime_error("trace: can not open " + path);
+}
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+void TraceWriter::append(const std::initializer_list<TraceValue> row) {
+    // Column-major: value c of the row goes to the array of column c
+    uint64_t* cell = block_.data() + 1 + rows_in_block_;
+    size_t c = 0;
+    for (const TraceValue& value : row) {
+        if (c == num_columns_) break;
+        cell[c * block_rows_] = value.bits;
+        ++c;
+    }
+    ++num_rows_;
+    if (++rows_in_block_ == block_rows_) write_block();
+}
+
+vector<uint64_t> TraceWriter::pending_rows() const {
+    vector<uint64_t> values;
+    values.reserve(num_columns_ * rows_in_block_);
+    for (size_t c = 0; c < num_columns_; ++c) {
+        const auto column = block_.begin() + 1 + static_cast<long>(c * block_rows_);
+        values.insert(values.end(), column, column + static_cast<long>(rows_in_block_));
+    }
+    return values;
+}
+
+void TraceWriter::close() {
+    if (!file_.is_open()) return;
+    if (rows_in_block_ > 0) write_block();
+    file_.close();
+}
+
+void TraceWriter::write_block() {
+    block_[0] = rows_in_block_;
+    file_.seekp(static_cast<std::streamoff>(block_offset_));
+    file_.write(reinterpret_cast<const char*>(block_.data()), static_cast<std::streamsize>(block_.size() * sizeof(uint64_t)));
+    file_.flush();
+    if (rows_in_block_ < block_rows_) return;
+    block_offset_ += block_.size() * sizeof(uint64_t);
+    std::fill(block_.begin(), block_.end(), 0);
+    rows_in_block_ = 0;
+}
+
+TraceReader::TraceReader(const string& path) {
+    if (!file_.open(path)) throw runtime_error("trace: can not open " + path);
+    Header header{};
+    if (file_.size() < sizeof(header)) throw runtime_error("trace: truncated header in " + path);
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, TraceFormat::kMagic, sizeof(header.magic)) != 0) throw runtime_error("trace: not a trace file: " + path);
+    if (header.version != TraceFormat::kVersion) throw runtime_error("trace: unsupported version in " + path);
+    if (header.num_columns == 0 || header.block_rows == 0) throw runtime_error("trace: empty layout in " + path);
+
+    const size_t offset = TraceFormat::data_offset(header.num_columns);
+    if (file_.size() < offset) throw runtime_error("trace: truncated header in " + path);
+    for (uint32_t c = 0; c < header.num_columns; ++c) {
+        ColumnDescriptor descriptor{};
+        std::memcpy(&descriptor, file_.data() + TraceFormat::kHeaderSize + c * TraceFormat::kColumnSize, sizeof(descriptor));
+        descriptor.name[sizeof(descriptor.name) - 1] = '\0';
+        if (descriptor.type > static_cast<uint32_t>(TraceType::DOUBLE)) throw runtime_error("trace: unknown column type in " + path);
+        columns_.push_back({descriptor.name, static_cast<TraceType>(descriptor.type)});
+    }
+
+    block_rows_ = header.block_rows;
+    const size_t block_bytes = TraceFormat::block_bytes(columns_.size(), block_rows_);
+    const size_t num_blocks = (file_.size() - offset) / block_bytes;
+    for (size_t b = 0; b < num_blocks; ++b) {
+        uint64_t count;
+        std::memcpy(&count, file_.data() + offset + b * block_bytes, sizeof(count));
+        if (count == 0 || count > block_rows_ || (count < block_rows_ && b + 1 < num_blocks)) {
+            throw runtime_error("trace: bad block " + to_string(b) + " in " + path);
+        }
+        block_counts_.push_back(count);
+        num_rows_ += count;
+    }
+}
+
+int TraceReader::find_column(const string& name) const {
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        if (columns_[c].name == name) return static_cast<int>(c);
+    }
+    return -1;
+}
+
+const uint64_t* TraceReader::block_column(const size_t block, const size_t c) const {
+    const size_t block_bytes = TraceFormat::block_bytes(columns_.size(), block_rows_);
+    const char* start = file_.data() + TraceFormat::data_offset(columns_.size()) + block * block_bytes;
+    return reinterpret_cast<const uint64_t*>(start) + 1 + c * block_rows_;
+}
+
+uint64_t TraceReader::bits(const size_t row, const size_t c) const {
+    uint64_t value;
+    std::memcpy(&value, block_column(row / block_rows_, c) + row % block_rows_, sizeof(value));
+    return value;
+}
+
+double TraceReader::value(const size_t row, const size_t c) const {
+    const uint64_t word = bits(row, c);
+    if (columns_[c].type == TraceType::INT64) return static_cast<double>(static_cast<int64_t>(word));
+    double value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+int64_t TraceReader::integer(const size_t row, const size_t c) const {
+    if (columns_[c].type == TraceType::INT64) return static_cast<int64_t>(bits(row, c));
+    return static_cast<int64_t>(value(row, c));
+}
+
+void TraceReader::write_csv(ostream& out) const {
+    for (size_t c = 0; c < columns_.size(); ++c) out << (c > 0 ? "," : "") << columns_[c].name;
+    out << "\n";
+
+    // Doubles are printed with enough digits to read back the same value
+    out << std::setprecision(numeric_limits<double>::max_digits10);
+    for (size_t row = 0; row < num_rows_; ++row) {
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            if (c > 0) out << ",";
+            if (columns_[c].type == TraceType::INT64) {
+                out << integer(row, c);
+            } else {
+                out << value(row, c);
+            }
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,109 @@
+#include "trial_scheduler.hpp"
+#include "parallel.hpp"
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// CPU time consumed so far by the calling thread
+double thread_cpu_seconds() {
+#if defined(__linux__) || defined(__APPLE__)
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+// Binds the calling thread to one CPU, returns the CPU or -1 if pinning is not supported
+int pin_to_cpu(const int worker) {
+#ifdef __linux__
+    const int cpu = worker % std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) return cpu;
+#endif
+    (void) worker;
+    return -1;
+}
+
+} // namespace
+
+TrialScheduler::TrialScheduler(const int num_trials, const int num_workers, const bool pin_workers, const int base_seed) {
+    this->num_trials_ = std::max(0, num_trials);
+    this->num_workers_ = std::max(1, std::min(resolve_num_threads(num_workers), num_trials_));
+    this->pin_workers_ = pin_workers;
+    this->base_seed_ = base_seed;
+}
+
+int TrialScheduler::trial_seed(const int base_seed, const int trial) {
+    return base_seed + trial + 1;
+}
+
+vector<TrialReport> TrialScheduler::run(const Trial& trial) const {
+    vector<TrialReport> reports(num_trials_);
+    std::atomic<int> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&](const int worker) {
+        const int cpu = pin_workers_ ? pin_to_cpu(worker) : -1;
+        try {
+            for (int t = next.fetch_add(1); t < num_trials_; t = next.fetch_add(1)) {
+                TrialReport& report = reports[t];
+                report.trial = t;
+                report.seed = trial_seed(base_seed_, t);
+                report.worker = worker;
+                report.cpu = cpu;
+
+                const auto wall_start = std::chrono::steady_clock::now();
+                const double cpu_start = thread_cpu_seconds();
+                report.result = trial(t, report.seed);
+                report.cpu_seconds = thread_cpu_seconds() - cpu_start;
+                report.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+            }
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next = num_trials_;
+        }
+    };
+
+    // The calling thread is worker 0; it is only pinned on request, like the others
+    vector<std::thread> workers;
+    workers.reserve(num_workers_ - 1);
+    for (int w = 1; w < num_workers_; ++w) workers.emplace_back(work, w);
+    work(0);
+    for (auto& worker : workers) worker.join();
+    if (error) std::rethrow_exception(error);
+
+    return reports;
+}
+
+void TrialScheduler::print_reports(const vector<TrialReport>& reports, ostream& out) {
+    for (const auto& report : reports) {
+        out << "trial " << setw(3) << report.trial + 1 << "  seed " << setw(6) << report.seed
+            << "  worker " << setw(3) << report.worker << "  cpu " << setw(3) << report.cpu
+            << fixed << setprecision(2) << "  result " << setw(12) << report.result
+            << setprecision(3) << "  wall " << setw(9) << report.wall_seconds << " s  cpu " << setw(9) << report.cpu_seconds << " s\n";
+    }
+}
+
+void TrialScheduler::save_reports(const vector<TrialReport>& reports, const string& file_path) {
+    ofstream out(file_path);
+    out << "trial,seed,worker,cpu,result,wall_seconds,cpu_seconds\n";
+    for (const auto& report : reports) {
+        out << report.trial + 1 << "," << report.seed << "," << report.worker << "," << report.cpu << ","
+            << fixed << setprecision(2) << report.result << "," << setprecision(6) << report.wall_seconds << ","
+            << report.cpu_seconds << "\n";
+    }
+}
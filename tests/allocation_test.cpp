@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "follower.hpp"
+#include "Split.h"
+#include "leader_array.hpp"
+#include <cstdlib>
+#include <new>
+
+using namespace ::testing;
+
+// This binary replaces the global operator new to count the heap allocations of the calling thread; it is kept apart
+// from Tests so that the replacement does not apply to every other test.
+static thread_local long num_allocations = 0;
+
+void* operator new(const size_t size) {
+    ++num_allocations;
+    if (void* p = std::malloc(size > 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+class AllocationTest : public Test {
+protected:
+    const Case instance{"E-n22-k4.evrp"};
+    Parameters params;
+    const Preprocessor preprocessor{instance, params};
+};
+
+TEST_F(AllocationTest, RepairDoesNotAllocate) {
+    // Solutions along a walk of the leader, so that the routes need stations, and some need the remove enumeration
+    Split split(params.seed, &instance, &preprocessor);
+    Follower follower(&instance, &preprocessor);
+    vector<Individual> solutions;
+    Individual ind(&instance, &preprocessor);
+    split.initIndividualWithHienClustering(&ind);
+    LeaderArray leader_array(params.seed, &instance, &preprocessor);
+    leader_array.load_individual(&ind);
+    for (int i = 0; i < 60; i++) {
+        leader_array.neighbour_explore(leader_array.upper_cost * 1.05);
+        leader_array.export_individual(&ind);
+        solutions.push_back(ind);
+    }
+
+    // Without the route cache every route is repaired; once the scratch buffers are warm that takes no allocation
+    follower.route_cache.resize(0);
+    auto repair_all = [&]() {
+        for (auto& solution : solutions) {
+            follower.run(&solution);
+            follower.refine(&solution);
+            follower.optimise(&solution);
+        }
+    };
+    repair_all();
+    const long before = num_allocations;
+    repair_all();
+    EXPECT_EQ(num_allocations - before, 0);
+
+    // The allocation counter does see the follower allocate
+    const long before_construct = num_allocations;
+    Follower other(&instance, &preprocessor);
+    EXPECT_GT(num_allocations - before_construct, 0);
+}
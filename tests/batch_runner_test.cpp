@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include "batch_runner.hpp"
+#include "lahc.hpp"
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(BatchRunnerTest, ParsesPlan) {
+    SCOPED_TRACE("Plan file...");
+
+    istringstream in("# tuning\n"
+                     "instances E-n22-k4.evrp E-n23-k3.evrp\n"
+                     "seeds 1..3 7   # ranges and single seeds\n"
+                     "\n"
+                     "nb_granular 10 20\n"
+                     "-history_length 1000\n");
+    const BatchPlan plan = BatchPlan::parse(in);
+    EXPECT_EQ(plan.instances, vector<string>({"E-n22-k4.evrp", "E-n23-k3.evrp"}));
+    EXPECT_EQ(plan.seeds, vector<int>({1, 2, 3, 7}));
+    ASSERT_EQ(plan.grid.size(), 2u);
+    EXPECT_EQ(plan.grid[0].first, "nb_granular");
+    EXPECT_EQ(plan.grid[0].second, vector<string>({"10", "20"}));
+    EXPECT_EQ(plan.grid[1].first, "history_length");
+
+    for (const string text : {"seeds 1\n", "instances a.evrp\nseeds 3..1\n", "instances a.evrp\nseed 1\n",
+                              "instances a.evrp\nnb_granular\n", "instances a.evrp\nstp 0\nstp 1\n"}) {
+        istringstream bad(text);
+        EXPECT_THROW(BatchPlan::parse(bad), invalid_argument) << text;
+    }
+}
+
+TEST(BatchRunnerTest, SharesInstancesAcrossJobs) {
+    SCOPED_TRACE("Batch jobs...");
+
+    istringstream in("instances E-n22-k4.evrp E-n23-k3.evrp\n"
+                     "seeds 1..3\n"
+                     "nb_granular 5 10\n"
+                     "history_length 100 200\n");
+    Parameters base;
+    base.build_threads = 1;
+    BatchRunner runner(BatchPlan::parse(in), base);
+
+    // 2 instances x 2 x 2 settings x 3 seeds; nb_granular changes the preprocessing only, history_length neither
+    ASSERT_EQ(runner.jobs().size(), 24u);
+    EXPECT_EQ(runner.num_case_groups(), 2);
+    EXPECT_EQ(runner.num_table_groups(), 4);
+
+    std::mutex mutex;
+    set<tuple<string, string, int>> seen;
+    const auto results = runner.run([&](const BatchJob& job, const Case* instance, const Preprocessor* preprocessor) {
+        EXPECT_EQ(instance->instance_name_ + ".evrp", job.instance);
+        EXPECT_EQ(preprocessor->nb_granular_, job.params.nb_granular);
+        const std::lock_guard<std::mutex> lock(mutex);
+        seen.emplace(job.instance, job.settings_label(), job.seed);
+        return static_cast<double>(job.params.history_length + job.seed);
+    }, 3, false);
+
+    EXPECT_EQ(seen.size(), 24u);
+    ASSERT_EQ(results.size(), 24u);
+    for (const auto& result : results) {
+        EXPECT_DOUBLE_EQ(result.report.result, result.job->params.history_length + result.job->seed);
+        EXPECT_EQ(result.report.seed, result.job->seed);
+    }
+
+    ostringstream summary;
+    BatchRunner::print_summary(results, summary);
+    EXPECT_NE(summary.str().find("E-n23-k3.evrp  nb_granular=10 history_length=200  trials 3  mean 202.00"), string::npos);
+}
+
+TEST(BatchRunnerTest, SeparatesTheOutputsOfItsJobs) {
+    SCOPED_TRACE("Jobs of the same instance and seed run at the same time...");
+
+    istringstream in("instances E-n22-k4.evrp\n"
+                     "seeds 1\n"
+                     "log 1\n"
+                     "history_length 100 200\n");
+    Parameters base;
+    base.build_threads = 1;
+    BatchRunner runner(BatchPlan::parse(in), base);
+    ASSERT_EQ(runner.jobs().size(), 2u);
+    EXPECT_EQ(runner.jobs()[0].params.output_label, "log=1,history_length=100");
+
+    // ... so their log, trace, solution and checkpoint files must not be the same
+    std::mutex mutex;
+    set<string> directories, checkpoints;
+    runner.run([&](const BatchJob& job, const Case* instance, const Preprocessor* preprocessor) {
+        const Lahc lahc(job.seed, instance, preprocessor, job.params);
+        const std::lock_guard<std::mutex> lock(mutex);
+        directories.insert(lahc.output_directory());
+        checkpoints.insert(lahc.checkpoint_file());
+        return 0.0;
+    }, 2, false);
+    EXPECT_EQ(directories.size(), 2u);
+    EXPECT_EQ(checkpoints.size(), 2u);
+}
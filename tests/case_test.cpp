@@ -35,4 +35,123 @@ TEST_F(CaseTest, Construtor) {
     EXPECT_TRUE(instance->is_charging_station(29));
     EXPECT_FALSE(instance->is_charging_station(13));
     EXPECT_FALSE(instance->is_charging_station(30));
-}
\ No newline at end of file
+}
+
+TEST_F(CaseTest, ParseProblem) {
+    SCOPED_TRACE("Parsing the header and the sections...");
+
+    EXPECT_EQ(instance->num_vehicle_, 4);
+    EXPECT_EQ(instance->max_vehicle_capa_, 6000);
+    EXPECT_DOUBLE_EQ(instance->max_battery_capa_, 94);
+    EXPECT_DOUBLE_EQ(instance->energy_consumption_rate_, 1.2);
+    EXPECT_DOUBLE_EQ(instance->optimum_, 384.678035);
+    EXPECT_EQ(instance->positions_.size(), 30);
+    EXPECT_EQ(instance->positions_[0], make_pair(145.0, 215.0));
+    EXPECT_EQ(instance->demand_.size(), 22);
+    EXPECT_DOUBLE_EQ(instance->distance(0, 1), sqrt(6.0 * 6.0 + 49.0 * 49.0));
+
+    // Keywords are matched as whole tokens, with or without spaces around the colon
+    Case parsed;
+    const string content = "NAME: test\r\nCOMMENT: CAPACITY: 1\r\nDIMENSION : 3\r\nSTATIONS: 1\r\nVEHICLES: 2\r\n"
+                           "CAPACITY: 10\r\nENERGY_CAPACITY: 5.5\r\nENERGY_CONSUMPTION: 0.5\r\n"
+                           "NODE_COORD_SECTION\r\n1 0 0\r\n2 3 4\r\n3 1.5 2\r\n4 -1 -1\r\n"
+                           "DEMAND_SECTION\r\n1 0\r\n2 4\r\n3 6\r\nDEPOT_SECTION\r\n1\r\n-1\r\nEOF";
+    parsed.parse_problem(content.data(), content.data() + content.size());
+
+    EXPECT_EQ(parsed.num_customer_, 2);
+    EXPECT_EQ(parsed.num_station_, 1);
+    EXPECT_EQ(parsed.num_vehicle_, 2);
+    EXPECT_EQ(parsed.max_vehicle_capa_, 10);
+    EXPECT_DOUBLE_EQ(parsed.max_battery_capa_, 5.5);
+    EXPECT_DOUBLE_EQ(parsed.energy_consumption_rate_, 0.5);
+    EXPECT_EQ(parsed.problem_size_, 4);
+    EXPECT_EQ(parsed.positions_[2], make_pair(1.5, 2.0));
+    EXPECT_EQ(parsed.positions_[3], make_pair(-1.0, -1.0));
+    EXPECT_EQ(parsed.demand_, vector<int>({0, 4, 6}));
+    EXPECT_EQ(parsed.depot_, 0);
+}
+
+TEST_F(CaseTest, DistanceMatrixLayout) {
+    SCOPED_TRACE("Contiguous distance matrix...");
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(instance->distances_) % 64, 0);
+    EXPECT_EQ(instance->distance_stride_ % 8, 0);
+    EXPECT_GE(instance->distance_stride_, instance->problem_size_);
+    for (int i = 0; i < instance->problem_size_; ++i) {
+        EXPECT_EQ(instance->distance_row(i), instance->distances_ + i * instance->distance_stride_);
+        for (int j = 0; j < instance->problem_size_; ++j) {
+            EXPECT_EQ(instance->distance(i, j), instance->euclidean_distance(i, j));
+        }
+    }
+
+    Parameters params;
+    params.pad_distance_rows = false;
+    Case unpadded("E-n22-k4.evrp", params);
+    EXPECT_EQ(unpadded.distance_stride_, unpadded.problem_size_);
+    EXPECT_EQ(unpadded.distance(3, 17), instance->distance(3, 17));
+}
+
+TEST_F(CaseTest, MatrixFreeBackend) {
+    SCOPED_TRACE("Distances computed on the fly...");
+
+    Parameters params;
+    params.matrix_free_threshold = 0;
+    Case matrix_free("E-n51-k5.evrp", params);
+    Case dense("E-n51-k5.evrp");
+    EXPECT_TRUE(matrix_free.matrix_free_);
+    EXPECT_EQ(matrix_free.distances_, nullptr);
+    EXPECT_FALSE(dense.matrix_free_);
+
+    vector<double> batched(matrix_free.problem_size_);
+    vector<double> dense_row(dense.problem_size_);
+    for (int i = 0; i < matrix_free.problem_size_; ++i) {
+        matrix_free.distances_from(i, 0, matrix_free.problem_size_, batched.data());
+        dense.distances_from(i, 0, dense.problem_size_, dense_row.data());
+        for (int j = 0; j < matrix_free.problem_size_; ++j) {
+            EXPECT_EQ(matrix_free.distance(i, j), dense.distance(i, j));
+            EXPECT_EQ(batched[j], dense.distance(i, j));
+            EXPECT_EQ(dense_row[j], dense.distance(i, j));
+        }
+    }
+
+    // The nearest customers are the first num_nearest_ customers by (distance, id)
+    EXPECT_EQ(matrix_free.num_nearest_, std::min(32, matrix_free.num_customer_ - 1));
+    for (int i = 1; i <= matrix_free.num_customer_; ++i) {
+        vector<pair<double, int>> order;
+        for (int j = 1; j <= matrix_free.num_customer_; ++j) {
+            if (j != i) order.emplace_back(dense.distance(i, j), j);
+        }
+        sort(order.begin(), order.end());
+        for (int k = 0; k < matrix_free.num_nearest_; ++k) {
+            EXPECT_EQ(matrix_free.nearest_customers(i)[k], order[k].second);
+        }
+    }
+}
+
+TEST_F(CaseTest, RenumberNodes) {
+    SCOPED_TRACE("Hilbert renumbering...");
+
+    Parameters params;
+    params.renumber_nodes = true;
+    Case renumbered("X-n143-k7.evrp", params);
+    Case original("X-n143-k7.evrp");
+
+    ASSERT_EQ(renumbered.original_ids_.size(), static_cast<size_t>(original.problem_size_));
+    EXPECT_EQ(renumbered.original_id(0), 0);
+    vector<int> ids(renumbered.original_ids_);
+    sort(ids.begin(), ids.end());
+    for (int i = 0; i < original.problem_size_; ++i) {
+        EXPECT_EQ(ids[i], i);
+        EXPECT_EQ(original.original_id(i), i);
+        // customers stay customers and stations stay stations
+        EXPECT_EQ(renumbered.is_charging_station(i), original.is_charging_station(renumbered.original_id(i)));
+        EXPECT_EQ(renumbered.positions_[i], original.positions_[renumbered.original_id(i)]);
+        if (i <= original.num_customer_) {
+            EXPECT_EQ(renumbered.demand_[i], original.demand_[renumbered.original_id(i)]);
+        }
+        for (int j = 0; j < original.problem_size_; ++j) {
+            EXPECT_EQ(renumbered.distance(i, j), original.distance(renumbered.original_id(i), renumbered.original_id(j)));
+        }
+    }
+    EXPECT_NE(renumbered.original_ids_, ids);
+}
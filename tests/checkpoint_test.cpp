@@ -0,0 +1,252 @@
+#include "gtest/gtest.h"
+#include "checkpoint.hpp"
+#include "lahc.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace ::testing;
+
+namespace {
+
+const string kTestDirectory = "../checkpoints/test/";
+
+} // namespace
+
+TEST(CheckpointTest, EncoderRoundTrip) {
+    SCOPED_TRACE("Encode / decode...");
+
+    CheckpointEncoder out;
+    out.put(42L);
+    out.put(3.5);
+    out.put_vector(vector<int>({1, 2, 3}));
+    out.put_string("state");
+    const int array[2] = {7, 8};
+    out.put_array(array, 2);
+    const vector<char> bytes = out.release();
+
+    CheckpointDecoder in(bytes.data(), bytes.size());
+    EXPECT_EQ(in.get<long>(), 42L);
+    EXPECT_EQ(in.get<double>(), 3.5);
+    EXPECT_EQ(in.get_vector<int>(), vector<int>({1, 2, 3}));
+    EXPECT_EQ(in.get_string(), "state");
+    int back[2] = {};
+    in.get_array(back, 2);
+    EXPECT_EQ(back[1], 8);
+    EXPECT_TRUE(in.at_end());
+    EXPECT_THROW(in.get<int>(), runtime_error);
+
+    CheckpointDecoder truncated(bytes.data(), bytes.size() - 1);
+    truncated.get<long>();
+    truncated.get<double>();
+    truncated.get_vector<int>();
+    truncated.get_string();
+    EXPECT_THROW(truncated.get_array(back, 2), runtime_error);
+}
+
+TEST(CheckpointTest, FileRejectsStaleOrCorruptedData) {
+    SCOPED_TRACE("Checkpoint file...");
+
+    const string path = kTestDirectory + "file.ckpt";
+    const vector<char> payload = {'a', 'b', 'c', 'd'};
+    ASSERT_TRUE(CheckpointFile::write(path, 7, payload));
+
+    vector<char> read;
+    EXPECT_TRUE(CheckpointFile::read(path, 7, read));
+    EXPECT_EQ(read, payload);
+    EXPECT_FALSE(CheckpointFile::read(path, 8, read));
+    EXPECT_FALSE(CheckpointFile::read(kTestDirectory + "missing.ckpt", 7, read));
+
+    // Flip the last payload byte
+    {
+        fstream file(path, ios::in | ios::out | ios::binary);
+        file.seekp(-1, ios::end);
+        file.put('x');
+    }
+    EXPECT_FALSE(CheckpointFile::read(path, 7, read));
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, AsyncWriterKeepsTheLatest) {
+    SCOPED_TRACE("Async writer...");
+
+    const string path = kTestDirectory + "async.ckpt";
+    {
+        AsyncCheckpointWriter writer;
+        for (char c = 'a'; c <= 'z'; ++c) writer.submit(path, 1, vector<char>(1'000, c));
+        writer.flush();
+        EXPECT_GE(writer.num_written(), 1);
+
+        vector<char> read;
+        ASSERT_TRUE(CheckpointFile::read(path, 1, read));
+        EXPECT_EQ(read, vector<char>(1'000, 'z'));
+
+        writer.submit(path, 1, vector<char>(10, '!'));
+    }
+    // The destructor wrote the pending checkpoint
+    vector<char> read;
+    ASSERT_TRUE(CheckpointFile::read(path, 1, read));
+    EXPECT_EQ(read, vector<char>(10, '!'));
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, AsyncWriterWaitsForItsBarrier) {
+    const string path = kTestDirectory + "barrier.ckpt";
+    std::filesystem::remove(path);
+
+    std::mutex mutex;
+    std::condition_variable released;
+    bool open = false;
+    AsyncCheckpointWriter writer;
+    writer.submit(path, 1, vector<char>(10, 'b'), [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&] { return open; });
+    });
+
+    // Submitting did not wait, and the file is only put in place once the barrier returns
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(std::filesystem::exists(path));
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        open = true;
+    }
+    released.notify_one();
+    writer.flush();
+    vector<char> read;
+    ASSERT_TRUE(CheckpointFile::read(path, 1, read));
+    EXPECT_EQ(read, vector<char>(10, 'b'));
+    std::filesystem::remove(path);
+}
+
+class LahcCheckpointTest : public Test {
+protected:
+    const Case instance{"E-n22-k4.evrp"};
+    Parameters params;
+    const Preprocessor preprocessor{instance, params};
+};
+
+TEST_F(LahcCheckpointTest, ResumedRunContinuesExactly) {
+    Lahc original(3, &instance, &preprocessor);
+    original.initialize_heuristic();
+    original.iteration_limit = 300;
+    original.run_heuristic();
+
+    Lahc resumed(3, &instance, &preprocessor);
+    resumed.decode_state(original.encode_state());
+    EXPECT_EQ(resumed.iter, original.iter);
+    EXPECT_EQ(resumed.evaluations.lookups(), original.evaluations.lookups());
+    EXPECT_EQ(resumed.global_best->lower_cost, original.global_best->lower_cost);
+
+    // Both continue from the same leader state
+    original.leader_loaded = true;
+    original.iteration_limit = resumed.iteration_limit = 900;
+    original.run_heuristic();
+    resumed.run_heuristic();
+    EXPECT_EQ(resumed.iter, original.iter);
+    EXPECT_EQ(resumed.history_list, original.history_list);
+    EXPECT_EQ(resumed.current->chromT, original.current->chromT);
+    EXPECT_EQ(resumed.global_best->lower_cost, original.global_best->lower_cost);
+    EXPECT_EQ(resumed.evaluations.lookups(), original.evaluations.lookups());
+
+    // And the next restart starts from the same solution, and searches the same way
+    original.iteration_limit = resumed.iteration_limit = 300;
+    original.initialize_heuristic();
+    resumed.initialize_heuristic();
+    EXPECT_EQ(resumed.current->chromT, original.current->chromT);
+    original.run_heuristic();
+    resumed.run_heuristic();
+    EXPECT_EQ(resumed.current->chromT, original.current->chromT);
+    EXPECT_EQ(resumed.global_best->lower_cost, original.global_best->lower_cost);
+    EXPECT_EQ(resumed.evaluations.lookups(), original.evaluations.lookups());
+
+    // A payload of another run is rejected without touching the state
+    Lahc other(4, &instance, &preprocessor);
+    vector<char> payload = original.encode_state();
+    payload.pop_back();
+    EXPECT_THROW(other.decode_state(payload), runtime_error);
+    EXPECT_EQ(other.iter, 0L);
+    EXPECT_FALSE(other.leader_loaded);
+}
+
+TEST_F(LahcCheckpointTest, CancelledRunLeavesACheckpoint) {
+    const string path = kTestDirectory + "run.ckpt";
+    std::filesystem::remove(path);
+
+    CancellationToken token;
+    Lahc first(5, &instance, &preprocessor);
+    first.enable_checkpoints(path, 0.05);
+    first.cancellation = &token;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        token.cancel();
+    });
+    first.run();
+    canceller.join();
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    Lahc second(5, &instance, &preprocessor);
+    second.checkpoint_path = path;
+    ASSERT_TRUE(second.resume_from_checkpoint());
+    EXPECT_TRUE(second.leader_loaded);
+    EXPECT_EQ(second.global_best->lower_cost, first.global_best->lower_cost);
+    EXPECT_GT(second.iter, 0L);
+
+    // A checkpoint of another seed does not match
+    Lahc third(6, &instance, &preprocessor);
+    third.checkpoint_path = path;
+    EXPECT_FALSE(third.resume_from_checkpoint());
+    std::filesystem::remove(path);
+}
+
+TEST_F(LahcCheckpointTest, ResumedRunContinuesItsLogAndTrace) {
+    const string path = kTestDirectory + "logged.ckpt";
+    const auto contents = [](const string& file) {
+        ifstream in(file, std::ios::binary);
+        return string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    const auto logged_run = [&] {
+        auto run = make_unique<Lahc>(7, &instance, &preprocessor);
+        run->enable_logging = true;
+        run->trace_interval = 10;
+        return run;
+    };
+
+    auto uninterrupted = logged_run();
+    const string directory = kStatsPath + "/" + uninterrupted->name + "/" + instance.instance_name_ + "/7/";
+    const string log_path = directory + "evols." + instance.instance_name_ + ".csv";
+    const string trace_path = directory + "trace." + instance.instance_name_ + ".bin";
+    uninterrupted->run();
+    const string log = contents(log_path);
+    const string trace = contents(trace_path);
+    ASSERT_GT(std::count(log.begin(), log.end(), '\n'), 2);
+
+    // The cancelled run checkpoints and writes rows after it, as a run killed between two checkpoints would
+    std::filesystem::remove(path);
+    CancellationToken token;
+    auto first = logged_run();
+    first->enable_checkpoints(path, 0.05);
+    first->cancellation = &token;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        token.cancel();
+    });
+    first->run();
+    canceller.join();
+    ASSERT_TRUE(first->deadline.cancelled());
+    ASSERT_TRUE(std::filesystem::exists(path));
+    ofstream(log_path, std::ios::app) << "1,2,3,4,5,6\n";
+    ofstream(trace_path, std::ios::binary | std::ios::app) << string(4096, 'x');
+
+    // The resumed run drops them and continues the files, with one header and no repeated or missing row
+    auto second = logged_run();
+    second->checkpoint_path = path;
+    second->resume = true;
+    second->run();
+    EXPECT_EQ(contents(log_path), log);
+    EXPECT_EQ(contents(trace_path), trace);
+    std::filesystem::remove(path);
+}
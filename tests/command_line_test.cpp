@@ -37,4 +37,24 @@ TEST(CommandLine, DisplayHelp) {
 //    CommandLine::display_help();
 
     EXPECT_TRUE(true);
+}
+
+TEST(CommandLine, ParseTrialParameters) {
+    int argc = 9;
+    const char* argv[] = {
+            "./frogs",
+            "-seed", "7",
+            "-trials", "4",
+            "-workers", "2",
+            "-pin", "1"
+    };
+
+    CommandLine cmd(argc, const_cast<char**>(argv));
+    Parameters params;
+    cmd.parse_parameters(params);
+
+    EXPECT_EQ(params.seed, 7);
+    EXPECT_EQ(params.num_trials, 4);
+    EXPECT_EQ(params.num_workers, 2);
+    EXPECT_EQ(params.pin_workers, true);
 }
\ No newline at end of file
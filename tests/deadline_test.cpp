@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include "deadline.hpp"
+#include "lahc.hpp"
+#include <csignal>
+#include <thread>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(DeadlineTest, ExpiresAfterItsBudget) {
+    SCOPED_TRACE("Deadline...");
+
+    EXPECT_FALSE(Deadline().expired());
+    EXPECT_EQ(Deadline().remaining(), numeric_limits<double>::infinity());
+
+    const Deadline deadline(0.05, nullptr);
+    EXPECT_FALSE(deadline.expired());
+    EXPECT_GT(deadline.remaining(), 0.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_TRUE(deadline.expired());
+    EXPECT_LT(deadline.remaining(), 0.0);
+}
+
+TEST(DeadlineTest, Cancellation) {
+    SCOPED_TRACE("Cancellation token...");
+
+    CancellationToken token;
+    const Deadline deadline(numeric_limits<double>::infinity(), &token);
+    EXPECT_FALSE(deadline.expired());
+    std::thread([&] { token.cancel(); }).join();
+    EXPECT_TRUE(deadline.expired());
+    EXPECT_TRUE(deadline.cancelled());
+    token.reset();
+    EXPECT_FALSE(deadline.expired());
+
+    // A signal cancels the token registered for it
+    cancel_on_signals(&token);
+    std::raise(SIGTERM);
+    EXPECT_TRUE(token.cancelled());
+    cancel_on_signals(nullptr);
+}
+
+TEST(DeadlineTest, LahcStopsWithinItsTimeLimit) {
+    SCOPED_TRACE("Max-time run...");
+
+    const Case instance("E-n22-k4.evrp");
+    Parameters params;
+    params.stop_criteria = 1;
+    params.time_limit = 0.3;
+    const Preprocessor preprocessor(instance, params);
+
+    // A restart alone takes seconds in a debug build: the run must stop inside it
+    Lahc lahc(1, &instance, &preprocessor, params);
+    const auto start = std::chrono::steady_clock::now();
+    lahc.run();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_LT(seconds, 1.0);
+    EXPECT_LT(lahc.global_best->lower_cost, numeric_limits<double>::max());
+
+    // Cancelled from another thread while running the max-evals criterion
+    CancellationToken token;
+    params.stop_criteria = 0;
+    Lahc cancelled(1, &instance, &preprocessor, params);
+    cancelled.cancellation = &token;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        token.cancel();
+    });
+    const auto cancel_start = std::chrono::steady_clock::now();
+    cancelled.run();
+    canceller.join();
+    EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - cancel_start).count(), 1.0);
+    EXPECT_LT(cancelled.global_best->lower_cost, numeric_limits<double>::max());
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "evaluation_budget.hpp"
+#include "lahc.hpp"
+#include <thread>
+
+using namespace ::testing;
+
+TEST(EvaluationBudgetTest, ExhaustedAtMaxEvals) {
+    SCOPED_TRACE("A full evaluation is lookups_per_evaluation lookups...");
+
+    EvaluationBudget budget(22, 3.0);
+    EXPECT_EQ(budget.max_lookups(), 66u);
+    EvaluationCounter& counter = budget.add_counter();
+    EXPECT_FALSE(budget.exhausted());
+
+    counter.charge(65);
+    EXPECT_FALSE(budget.exhausted());
+    counter.charge(1);
+    EXPECT_TRUE(budget.exhausted());
+    EXPECT_DOUBLE_EQ(budget.evaluations(), 3.0);
+
+    // Exact even where adding 1 / 22 would round: 22 million lookups are a million evaluations
+    EvaluationBudget large(22, 1'000'000.0);
+    EvaluationCounter& large_counter = large.add_counter();
+    for (int i = 0; i < 22'000; ++i) large_counter.charge(999);
+    large_counter.charge(22'000);
+    EXPECT_TRUE(large.exhausted());
+    EXPECT_EQ(large.lookups(), 22'000'000u);
+}
+
+TEST(EvaluationBudgetTest, SumsThreadCounters) {
+    SCOPED_TRACE("One counter per thread...");
+
+    EvaluationBudget budget(10, 1'000.0);
+    vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        EvaluationCounter& counter = budget.add_counter();
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 1'000; ++i) counter.charge(2);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(budget.lookups(), 8'000u);
+    EXPECT_FALSE(budget.exhausted());
+}
+
+TEST(EvaluationBudgetTest, LahcChargesItsSearch) {
+    SCOPED_TRACE("Split, leader and follower lookups reach the budget of the heuristic...");
+
+    Case instance("E-n22-k4.evrp");
+    Parameters params;
+    Preprocessor preprocessor(instance, params);
+    Lahc lahc(params.seed, &instance, &preprocessor);
+    EXPECT_EQ(lahc.evaluation_budget.max_lookups(), static_cast<uint64_t>(preprocessor.max_evals_) * instance.problem_size_);
+
+    lahc.initialize_heuristic();
+    const uint64_t initial = lahc.evaluations.lookups();
+    EXPECT_GT(initial, 0u);
+    EXPECT_EQ(lahc.split->num_lookups, 0u);
+
+    lahc.leader->load_individual(lahc.current);
+    lahc.leader->neighbour_explore(lahc.leader->upper_cost);
+    lahc.follower->run(lahc.current);
+    const uint64_t pending = lahc.leader->num_lookups + lahc.follower->num_lookups;
+    EXPECT_GT(lahc.follower->num_lookups, 0u);
+    lahc.charge_evaluations();
+    EXPECT_EQ(lahc.evaluations.lookups(), initial + pending);
+    EXPECT_EQ(lahc.evaluation_budget.lookups(), initial + pending);
+}
+
+TEST(EvaluationBudgetTest, RemoveEnumRoundCost) {
+    SCOPED_TRACE("A round of the remove enumeration costs the lookups of its stretches and savings...");
+
+    // Alone on a route of 5 arcs, a station's stretch is the whole route, and a removable one adds its saving
+    EXPECT_EQ(RepairCostModel::remove_enum_round(5, 2, 2, 1, 0), 5u);
+    EXPECT_EQ(RepairCostModel::remove_enum_round(5, 2, 2, 1, 1), 8u);
+
+    // Stations on arcs 0, 2 and 4 of 5: stretches of arcs 0-1, 1-3 and 3-4, four ends at a station, one saving
+    EXPECT_EQ(RepairCostModel::remove_enum_round(5, 0, 4, 3, 1), 2u + 3u + 2u + 4u + 3u);
+
+    // A station on every arc: the stretch of each is its own arc
+    EXPECT_EQ(RepairCostModel::remove_enum_round(4, 0, 3, 4, 0), 4u * 1u + 6u);
+}
@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include "evolution_log.hpp"
+#include <filesystem>
+#include <thread>
+
+using namespace std;
+using namespace ::testing;
+
+namespace {
+
+vector<string> read_lines(const string& path) {
+    ifstream in(path);
+    vector<string> lines;
+    for (string line; getline(in, line);) lines.push_back(line);
+    return lines;
+}
+
+} // namespace
+
+TEST(EvolutionLogTest, WritesRowsInOrder) {
+    SCOPED_TRACE("Append and close...");
+
+    const string path = (fs::temp_directory_path() / "frogs_evolution_log_test.csv").string();
+    {
+        EvolutionLog log(path, "iters,global_best,min,max,mean,std", 8, 0.01);
+        for (long i = 0; i < 100; ++i) {
+            // The buffer holds 8 rows, so the search side waits here only to keep the test deterministic
+            while (!log.append({i, 10.0 + static_cast<double>(i), {1.0, 2.0, 1.5, 0.5, 4}})) std::this_thread::yield();
+        }
+        log.close();
+        EXPECT_EQ(log.num_written(), 100);
+        EXPECT_FALSE(log.is_open());
+    }
+
+    const vector<string> lines = read_lines(path);
+    ASSERT_EQ(lines.size(), 101u);
+    EXPECT_EQ(lines[0], "iters,global_best,min,max,mean,std");
+    EXPECT_EQ(lines[1], "0,10,1,2,1.5,0.5");
+    EXPECT_EQ(lines[100], "99,109,1,2,1.5,0.5");
+    fs::remove(path);
+}
+
+TEST(EvolutionLogTest, FlushesWhileOpenAndDropsWhenFull) {
+    SCOPED_TRACE("Bounded buffer...");
+
+    const string path = (fs::temp_directory_path() / "frogs_evolution_log_partial.csv").string();
+    EvolutionLog log(path, "iters", 4, 0.01);
+    EXPECT_TRUE(log.append({1, 5.0, {}}));
+    EXPECT_TRUE(log.append({2, 4.0, {}}));
+
+    // The rows reach the file at the next periodic flush, without closing the log
+    for (int k = 0; k < 500 && log.num_written() < 2; ++k) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_EQ(read_lines(path).size(), 3u);
+
+    // Appends never block: whatever does not fit in the buffer is dropped and counted
+    long accepted = 0;
+    for (long i = 0; i < 10000; ++i) accepted += log.append({i, 0.0, {}});
+    log.close();
+    EXPECT_EQ(accepted + log.num_dropped(), 10000);
+    EXPECT_EQ(log.num_written(), 2 + accepted);
+    EXPECT_EQ(static_cast<long>(read_lines(path).size()), 3 + accepted);
+    fs::remove(path);
+}
@@ -7,6 +7,8 @@
 #include "Split.h"
 //#include "LocalSearch.h"
 #include "leader_lahc.hpp"
+#include "leader_array.hpp"
+#include <list>
 #include <random>
 
 using namespace ::testing;
@@ -143,4 +145,328 @@ TEST_F(FollowerTest, SpecialCase_En23k3) {
     EXPECT_LT(instance_E23.calculate_demand_sum(ind.chromR[0]), instance_E23.max_vehicle_capa_);
     EXPECT_LT(instance_E23.calculate_demand_sum(ind.chromR[1]), instance_E23.max_vehicle_capa_);
     EXPECT_LT(instance_E23.calculate_demand_sum(ind.chromR[2]), instance_E23.max_vehicle_capa_);
-}
\ No newline at end of file
+}
+TEST_F(FollowerTest, RouteCacheReplaysRepairs) {
+    vector<int> chromT(preprocessor->customer_ids_);
+    std::shuffle(chromT.begin(), chromT.end(), random_engine);
+    Individual ind(instance, preprocessor, chromT);
+    split->generalSplit(&ind, preprocessor->route_cap_);
+
+    // The same walk through the neighbourhood, repaired with and without the cache
+    Follower uncached(instance, preprocessor);
+    uncached.route_cache.resize(0);
+    ASSERT_TRUE(follower->route_cache.enabled());
+    leader->loadIndividual(&ind);
+    double history_val = 800;
+    for (int i = 0; i < 2000; i++) {
+        leader->neighbourExplore(history_val);
+        leader->exportChromosome(&ind);
+        history_val = leader->getUpperCost() * 1.1;
+
+        follower->run(&ind);
+        const double cached_cost = ind.lower_cost;
+        uncached.run(&ind);
+        ASSERT_EQ(cached_cost, ind.lower_cost);
+        ASSERT_EQ(follower->num_lookups, uncached.num_lookups);
+        for (int r = 0; r < uncached.num_routes; ++r) {
+            ASSERT_EQ(follower->lower_num_nodes_per_route[r], uncached.lower_num_nodes_per_route[r]);
+            for (int j = 0; j < uncached.lower_num_nodes_per_route[r]; ++j) {
+                ASSERT_EQ(follower->lower_routes[r][j], uncached.lower_routes[r][j]);
+            }
+        }
+    }
+    EXPECT_GT(follower->route_cache.hit_rate(), 0.5);
+}
+
+TEST_F(FollowerTest, RunDirtyRoutesOnly) {
+    Individual ind(instance, preprocessor);
+    split->initIndividualWithHienClustering(&ind);
+
+    // Repairing the routes marked by the leader gives the same lower cost, routes and lookups as repairing them all
+    LeaderArray leader_array(params->seed, instance, preprocessor);
+    Follower full(instance, preprocessor);
+    full.route_cache.resize(0);
+    follower->route_cache.resize(0);
+    leader_array.load_individual(&ind);
+    leader_array.export_individual(&ind);
+    EXPECT_TRUE(leader_array.dirty_routes.all());
+    for (int i = 0; i < 3000; i++) {
+        leader_array.neighbour_explore(leader_array.upper_cost * 1.05);
+        leader_array.export_individual(&ind);
+
+        follower->run(&ind, leader_array.dirty_routes);
+        EXPECT_LE(leader_array.dirty_routes.ids().size(), 2u);
+        leader_array.dirty_routes.clear();
+        const double incremental_cost = ind.lower_cost;
+        full.run(&ind);
+        ASSERT_EQ(incremental_cost, ind.lower_cost);
+        ASSERT_EQ(follower->num_lookups, full.num_lookups);
+        ASSERT_EQ(follower->num_routes, full.num_routes);
+        for (int r = 0; r < full.num_routes; ++r) {
+            ASSERT_EQ(follower->lower_num_nodes_per_route[r], full.lower_num_nodes_per_route[r]);
+            for (int j = 0; j < full.node_cap; ++j) ASSERT_EQ(follower->lower_routes[r][j], full.lower_routes[r][j]);
+        }
+    }
+}
+
+TEST_F(FollowerTest, OptimiseMatchesEnumeration) {
+    // Battery range left between consecutive charges, over every route of the follower
+    auto max_leg = [&](const Follower& f) {
+        double longest = 0.0;
+        for (int r = 0; r < f.num_routes; ++r) {
+            double leg = 0.0;
+            for (int j = 1; j < f.lower_num_nodes_per_route[r]; ++j) {
+                leg += instance->distance(f.lower_routes[r][j - 1], f.lower_routes[r][j]);
+                longest = std::max(longest, leg);
+                if (instance->is_charging_station(f.lower_routes[r][j])) leg = 0.0;
+            }
+        }
+        return longest;
+    };
+
+    for (int k = 0; k < 20; ++k) {
+        vector<int> chromT(preprocessor->customer_ids_);
+        std::shuffle(chromT.begin(), chromT.end(), random_engine);
+        Individual ind(instance, preprocessor, chromT);
+        split->generalSplit(&ind, preprocessor->route_cap_);
+        leader->run(&ind, preprocessor->penalty_capacity_, preprocessor->penalty_duration_);
+
+        follower->refine(&ind);
+        const double enumerated = ind.lower_cost;
+        follower->optimise(&ind);
+
+        // Both are optimal over one station per arc, the enumeration only tries the fewest stations
+        EXPECT_LE(ind.lower_cost, enumerated + 1e-6);
+        EXPECT_NEAR(ind.lower_cost, instance->calculate_total_dist_follower(follower->lower_routes, follower->num_routes, follower->lower_num_nodes_per_route), 1e-6);
+        EXPECT_LE(max_leg(*follower), preprocessor->max_cruise_distance_ + 1e-9);
+    }
+
+    // With a short battery the enumeration explodes, the dynamic program still finds a feasible plan
+    Individual ind(instance, preprocessor);
+    split->initIndividualWithHienClustering(&ind);
+    preprocessor->max_cruise_distance_ *= 0.8;
+    follower->optimise(&ind);
+    EXPECT_LT(ind.lower_cost, INFEASIBLE);
+    EXPECT_LE(max_leg(*follower), preprocessor->max_cruise_distance_ + 1e-9);
+}
+
+// The remove enumeration as it was written before its prefix sums, with std::list and the segments summed arc by arc;
+// stretches, if given, collects the sums of the stretches that start at a station
+static double remove_enum_by_list(const Case* instance, const Preprocessor* preprocessor, int* repaired_route, int& repaired_length, uint64_t& num_lookups,
+                                  vector<double>* stretches = nullptr) {
+    auto metered_distance = [&](const int from, const int to) { ++num_lookups; return instance->distance(from, to); };
+    const int length = repaired_length;
+    const vector<int> route(repaired_route, repaired_route + length);
+
+    list<pair<int, int>> stationInserted;
+    for (int i = 0; i < length - 1; i++) {
+        double allowedDis = preprocessor->max_cruise_distance_;
+        if (i != 0) {
+            allowedDis = preprocessor->max_cruise_distance_ - metered_distance(stationInserted.back().second, route[i]);
+        }
+        int onestation = preprocessor->get_best_and_feasible_station(route[i], route[i + 1], allowedDis);
+        if (onestation == -1) {
+            return -1;
+        }
+        stationInserted.emplace_back(i, onestation);
+    }
+    while (!stationInserted.empty())
+    {
+        bool change = false;
+        auto delone = stationInserted.begin();
+        double savedis = 0;
+        auto itr = stationInserted.begin();
+        auto next = itr;
+        next++;
+        if (next != stationInserted.end()) {
+            int endInd = next->first;
+            int endstation = next->second;
+            double sumdis = 0;
+            for (int i = 0; i < endInd; i++) {
+                sumdis += metered_distance(route[i], route[i + 1]);
+            }
+            sumdis += metered_distance(route[endInd], endstation);
+            if (sumdis <= preprocessor->max_cruise_distance_) {
+                savedis = metered_distance(route[itr->first], itr->second)
+                          + metered_distance(itr->second, route[itr->first + 1])
+                          - metered_distance(route[itr->first], route[itr->first + 1]);
+            }
+        }
+        else {
+            double sumdis = 0;
+            for (int i = 0; i < length - 1; i++) {
+                sumdis += metered_distance(route[i], route[i + 1]);
+            }
+            if (sumdis <= preprocessor->max_cruise_distance_) {
+                savedis = metered_distance(route[itr->first], itr->second)
+                          + metered_distance(itr->second, route[itr->first + 1])
+                          - metered_distance(route[itr->first], route[itr->first + 1]);
+            }
+        }
+        itr++;
+        while (itr != stationInserted.end())
+        {
+            int startInd, endInd;
+            next = itr;
+            next++;
+            auto prev = itr;
+            prev--;
+            double sumdis = 0;
+            if (next != stationInserted.end()) {
+                startInd = prev->first + 1;
+                endInd = next->first;
+                sumdis += metered_distance(prev->second, route[startInd]);
+                for (int i = startInd; i < endInd; i++) {
+                    sumdis += metered_distance(route[i], route[i + 1]);
+                }
+                sumdis += metered_distance(route[endInd], next->second);
+                if (stretches) stretches->push_back(sumdis);
+                if (sumdis <= preprocessor->max_cruise_distance_) {
+                    double savedistemp = metered_distance(route[itr->first], itr->second)
+                                         + metered_distance(itr->second, route[itr->first + 1])
+                                         - metered_distance(route[itr->first], route[itr->first + 1]);
+                    if (savedistemp > savedis) {
+                        savedis = savedistemp;
+                        delone = itr;
+                    }
+                }
+            }
+            else {
+                startInd = prev->first + 1;
+                sumdis += metered_distance(prev->second, route[startInd]);
+                for (int i = startInd; i < length - 1; i++) {
+                    sumdis += metered_distance(route[i], route[i + 1]);
+                }
+                if (stretches) stretches->push_back(sumdis);
+                if (sumdis <= preprocessor->max_cruise_distance_) {
+                    double savedistemp = metered_distance(route[itr->first], itr->second)
+                                         + metered_distance(itr->second, route[itr->first + 1])
+                                         - metered_distance(route[itr->first], route[itr->first + 1]);
+                    if (savedistemp > savedis) {
+                        savedis = savedistemp;
+                        delone = itr;
+                    }
+                }
+            }
+            itr++;
+        }
+        if (savedis != 0) {
+            stationInserted.erase(delone);
+            change = true;
+        }
+        if (!change) {
+            break;
+        }
+    }
+    double sum = 0;
+    for (int i = 0; i < length - 1; i++) {
+        sum += metered_distance(route[i], route[i + 1]);
+    }
+    int currentIndex = 0;
+    int idx = 0;
+    for (auto& e : stationInserted) {
+        int pos = e.first;
+        int stat = e.second;
+        sum -= metered_distance(route[pos], route[pos + 1]);
+        sum += metered_distance(route[pos], stat);
+        sum += metered_distance(stat, route[pos + 1]);
+
+        int numElementsToCopy = pos + 1 - idx;
+        memcpy(&repaired_route[currentIndex], &route[idx], numElementsToCopy * sizeof(int));
+        currentIndex += numElementsToCopy;
+
+        repaired_route[currentIndex++] = stat;
+
+        idx = pos + 1;
+    }
+    int remainingElementsToCopy = length - idx;
+    memcpy(&repaired_route[currentIndex], &route[idx], remainingElementsToCopy * sizeof(int));
+    repaired_length = currentIndex + remainingElementsToCopy;
+
+    return sum;
+}
+
+TEST_F(FollowerTest, RemoveEnumMatchesListVersion) {
+    // Random routes over all the customers and battery ranges, compared station by station and lookup by lookup
+    const double max_range = preprocessor->max_cruise_distance_;
+    std::uniform_int_distribution<int> length_distribution(1, static_cast<int>(preprocessor->customer_ids_.size()));
+    int repaired = 0;
+    for (const double factor : {1.0, 0.8, 0.6, 0.5}) {
+        preprocessor->max_cruise_distance_ = max_range * factor;
+        for (int k = 0; k < 200; ++k) {
+            vector<int> customers(preprocessor->customer_ids_);
+            std::shuffle(customers.begin(), customers.end(), random_engine);
+            vector<int> route(1, instance->depot_);
+            route.insert(route.end(), customers.begin(), customers.begin() + length_distribution(random_engine));
+            route.push_back(instance->depot_);
+
+            vector<int> expected(route);
+            expected.resize(2 * route.size());
+            int expected_length = static_cast<int>(route.size());
+            uint64_t expected_lookups = 0;
+            const double expected_cost = remove_enum_by_list(instance, preprocessor, expected.data(), expected_length, expected_lookups);
+
+            vector<int> actual(expected.size());
+            std::copy(route.begin(), route.end(), actual.begin());
+            int actual_length = static_cast<int>(route.size());
+            follower->num_lookups = 0;
+            const double actual_cost = follower->insert_station_by_remove_enum(actual.data(), actual_length);
+
+            ASSERT_EQ(actual_cost, expected_cost);
+            ASSERT_EQ(follower->num_lookups, expected_lookups);
+            if (expected_cost == -1) continue;
+            ASSERT_EQ(actual_length, expected_length);
+            ASSERT_TRUE(std::equal(actual.begin(), actual.begin() + actual_length, expected.begin()));
+            repaired += actual_length > static_cast<int>(route.size()) + 1;
+        }
+    }
+    preprocessor->max_cruise_distance_ = max_range;
+    EXPECT_GT(repaired, 100);                   // routes left with more than one station
+}
+
+TEST_F(FollowerTest, RemoveEnumDecidesStretchesAtTheLimitAsBefore) {
+    // A battery range equal to a stretch the list version summed from a station: the difference of two prefix sums can
+    // round to either side of it, the remove enumeration sums such a stretch arc by arc again and decides the same
+    const double max_range = preprocessor->max_cruise_distance_;
+    std::uniform_int_distribution<int> length_distribution(2, static_cast<int>(preprocessor->customer_ids_.size()));
+    int at_limit = 0;
+    for (int k = 0; k < 400; ++k) {
+        vector<int> customers(preprocessor->customer_ids_);
+        std::shuffle(customers.begin(), customers.end(), random_engine);
+        vector<int> route(1, instance->depot_);
+        route.insert(route.end(), customers.begin(), customers.begin() + length_distribution(random_engine));
+        route.push_back(instance->depot_);
+
+        preprocessor->max_cruise_distance_ = max_range * 0.6;
+        vector<int> scratch(2 * route.size());
+        std::copy(route.begin(), route.end(), scratch.begin());
+        int scratch_length = static_cast<int>(route.size());
+        uint64_t scratch_lookups = 0;
+        vector<double> stretches;
+        remove_enum_by_list(instance, preprocessor, scratch.data(), scratch_length, scratch_lookups, &stretches);
+
+        for (const double stretch : stretches) {
+            if (stretch > max_range * 0.6 || stretch < max_range * 0.5) continue;
+            preprocessor->max_cruise_distance_ = stretch;
+            vector<int> expected(2 * route.size());
+            std::copy(route.begin(), route.end(), expected.begin());
+            int expected_length = static_cast<int>(route.size());
+            uint64_t expected_lookups = 0;
+            const double expected_cost = remove_enum_by_list(instance, preprocessor, expected.data(), expected_length, expected_lookups);
+
+            vector<int> actual(expected.size());
+            std::copy(route.begin(), route.end(), actual.begin());
+            int actual_length = static_cast<int>(route.size());
+            follower->num_lookups = 0;
+            const double actual_cost = follower->insert_station_by_remove_enum(actual.data(), actual_length);
+
+            ASSERT_EQ(actual_cost, expected_cost);
+            ASSERT_EQ(follower->num_lookups, expected_lookups);
+            ASSERT_EQ(actual_length, expected_length);
+            ASSERT_TRUE(std::equal(actual.begin(), actual.begin() + actual_length, expected.begin()));
+            at_limit += expected_cost != -1;
+        }
+    }
+    preprocessor->max_cruise_distance_ = max_range;
+    EXPECT_GT(at_limit, 50);
+}
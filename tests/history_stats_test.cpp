@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+#include "history_stats.hpp"
+#include <random>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(HistoryStatsTest, MatchesFullPass) {
+    SCOPED_TRACE("Replace...");
+
+    std::mt19937 random_engine(3);
+    std::uniform_real_distribution<double> cost(100.0, 200.0);
+    std::uniform_int_distribution<size_t> slot(0, 999);
+    vector<double> values(1000);
+    for (auto& value : values) value = cost(random_engine);
+
+    HistoryStats stats;
+    stats.assign(values);
+    for (int k = 0; k < 20000; ++k) {
+        const size_t i = slot(random_engine);
+        values[i] = k % 3 == 0 ? cost(random_engine) : values[i] - 1.0;     // both raises and drops of the extremes
+        stats.replace(i, values[i]);
+        if (k % 997 == 0 || k == 19999) {
+            const Indicators expected = StatsInterface::calculate_statistical_indicators(values);
+            const Indicators actual = stats.indicators();
+            EXPECT_EQ(actual.size, expected.size);
+            EXPECT_EQ(actual.min, expected.min);
+            EXPECT_EQ(actual.max, expected.max);
+            EXPECT_NEAR(actual.avg, expected.avg, 1e-9);
+            EXPECT_NEAR(actual.std, expected.std, 1e-9);
+        }
+    }
+    EXPECT_EQ(stats.value(42), values[42]);
+}
+
+TEST(HistoryStatsTest, SmallLists) {
+    SCOPED_TRACE("Sizes...");
+
+    HistoryStats stats;
+    EXPECT_EQ(stats.indicators().size, 0u);
+
+    stats.assign(1, 5.0);
+    stats.replace(0, 3.0);
+    EXPECT_EQ(stats.min(), 3.0);
+    EXPECT_EQ(stats.max(), 3.0);
+    EXPECT_EQ(stats.indicators().std, 0.0);
+
+    // Not a power of two, so the tree has padding leaves
+    stats.assign({4.0, 8.0, 6.0});
+    EXPECT_EQ(stats.min(), 4.0);
+    EXPECT_EQ(stats.max(), 8.0);
+    EXPECT_DOUBLE_EQ(stats.mean(), 6.0);
+    EXPECT_DOUBLE_EQ(stats.variance(), 4.0);
+    stats.replace(1, 2.0);
+    EXPECT_EQ(stats.min(), 2.0);
+    EXPECT_EQ(stats.max(), 6.0);
+    EXPECT_DOUBLE_EQ(stats.mean(), 4.0);
+}
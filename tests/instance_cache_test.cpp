@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include "instance_cache.hpp"
+#include "preprocessor.hpp"
+#include <filesystem>
+
+using namespace ::testing;
+
+class InstanceCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        params = new Parameters();
+        params->instance = "E-n22-k4.evrp";
+        params->enable_instance_cache = true;
+        instance = new Case(params->instance);
+        std::filesystem::remove(InstanceCache::file_path(*instance, params->nb_granular));
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(InstanceCache::file_path(*instance, params->nb_granular));
+        delete instance;
+        delete params;
+    }
+
+    Case* instance{};
+    Parameters* params{};
+};
+
+TEST_F(InstanceCacheTest, RoundTrip) {
+    InstanceCache cache;
+    EXPECT_FALSE(cache.open(*instance, params->nb_granular));
+
+    // The first preprocessing builds the tables and writes the cache file
+    Preprocessor built(*instance, *params);
+    ASSERT_TRUE(cache.open(*instance, params->nb_granular));
+    EXPECT_DOUBLE_EQ(cache.header().max_distance, built.max_distance_);
+    EXPECT_EQ(cache.sorted_nearby_customers(), built.sorted_nearby_customers_);
+    EXPECT_EQ(cache.correlated_vertices(), built.correlated_vertices_);
+    vector<uint16_t> codes(built.best_station_.size());
+    built.best_station_.store(codes.data());
+    EXPECT_TRUE(std::equal(codes.begin(), codes.end(), cache.best_station()));
+
+    // The next runs take everything from the cache
+    Case cached_instance(params->instance, *params);
+    Preprocessor loaded(cached_instance, *params);
+    for (int i = 0; i < instance->problem_size_; ++i) {
+        for (int j = 0; j < instance->problem_size_; ++j) {
+            EXPECT_EQ(cached_instance.distance(i, j), instance->distance(i, j));
+        }
+    }
+    EXPECT_EQ(loaded.max_distance_, built.max_distance_);
+    EXPECT_EQ(loaded.sorted_nearby_customers_, built.sorted_nearby_customers_);
+    EXPECT_EQ(loaded.correlated_vertices_, built.correlated_vertices_);
+    for (int i = 0; i <= instance->num_customer_; ++i) {
+        for (int j = 0; j <= instance->num_customer_; ++j) {
+            EXPECT_EQ(loaded.best_station(i, j), built.best_station(i, j));
+        }
+    }
+}
+
+TEST_F(InstanceCacheTest, KeyedByGranularity) {
+    Preprocessor built(*instance, *params);
+
+    InstanceCache cache;
+    EXPECT_TRUE(cache.open(*instance, params->nb_granular));
+    EXPECT_FALSE(cache.open(*instance, params->nb_granular + 1));
+    EXPECT_NE(InstanceCache::fingerprint(*instance, params->nb_granular), InstanceCache::fingerprint(*instance, params->nb_granular + 1));
+}
+
+TEST_F(InstanceCacheTest, RejectsCorruptedFile) {
+    Preprocessor built(*instance, *params);
+
+    const string path = InstanceCache::file_path(*instance, params->nb_granular);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+
+    InstanceCache cache;
+    EXPECT_FALSE(cache.open(*instance, params->nb_granular));
+}
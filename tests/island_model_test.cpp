@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+#include "island_model.hpp"
+#include <numeric>
+#include <thread>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(IslandModelTest, BoundedQueue) {
+    SCOPED_TRACE("Bounded queue...");
+
+    EXPECT_THROW(BoundedQueue<int>(6), invalid_argument);
+
+    BoundedQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.try_push(i));
+    int extra = 4;
+    EXPECT_FALSE(queue.try_push(extra));
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(queue.try_pop(), std::optional<int>(i));
+    EXPECT_FALSE(queue.try_pop().has_value());
+
+    // Several producers and consumers: every value comes out exactly once
+    BoundedQueue<int> shared(64);
+    std::atomic<long> popped_sum{0};
+    std::atomic<int> popped{0};
+    vector<std::thread> threads;
+    for (int p = 0; p < 3; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 1; i <= 1'000; ++i) {
+                int value = p * 1'000 + i;
+                while (!shared.try_push(value)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            while (popped.load() < 3'000) {
+                if (const auto value = shared.try_pop()) {
+                    popped_sum += *value;
+                    popped++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(popped.load(), 3'000);
+    EXPECT_EQ(popped_sum.load(), 3'000L * 3'001 / 2);
+}
+
+TEST(IslandModelTest, Topologies) {
+    SCOPED_TRACE("Neighbours...");
+
+    std::default_random_engine engine(1);
+    const IslandModel ring(4, Topology::RING, 100);
+    EXPECT_EQ(ring.neighbour(0, engine), 1);
+    EXPECT_EQ(ring.neighbour(3, engine), 0);
+    EXPECT_EQ(ring.migration_interval(), 100);
+
+    const IslandModel random(4, Topology::RANDOM, 100);
+    vector<int> hits(4, 0);
+    for (int i = 0; i < 300; ++i) hits[random.neighbour(2, engine)]++;
+    EXPECT_EQ(hits[2], 0);
+    EXPECT_GT(hits[0], 0);
+    EXPECT_GT(hits[1], 0);
+    EXPECT_GT(hits[3], 0);
+
+    EXPECT_EQ(IslandModel(1, Topology::RING, 100).neighbour(0, engine), 0);
+}
+
+TEST(IslandModelTest, Migration) {
+    SCOPED_TRACE("Emigrate and immigrate...");
+
+    std::default_random_engine engine(1);
+    IslandModel islands(2, Topology::RING, 10);
+    Individual elite;
+    for (int i = 0; i < IslandModel::kInboxCapacity; ++i) {
+        elite.lower_cost = 100.0 - i;
+        EXPECT_TRUE(islands.emigrate(0, elite, engine));
+    }
+    EXPECT_FALSE(islands.emigrate(0, elite, engine));   // the inbox of island 1 is full
+    EXPECT_EQ(islands.num_sent(), IslandModel::kInboxCapacity);
+    EXPECT_EQ(islands.num_dropped(), 1);
+
+    EXPECT_EQ(islands.immigrate(0), nullptr);
+    for (int i = 0; i < IslandModel::kInboxCapacity; ++i) {
+        const auto migrant = islands.immigrate(1);
+        ASSERT_NE(migrant, nullptr);
+        EXPECT_EQ(migrant->lower_cost, 100.0 - i);
+    }
+    EXPECT_EQ(islands.immigrate(1), nullptr);
+}
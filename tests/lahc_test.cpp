@@ -77,4 +77,51 @@ TEST_F(LahcTest, Run) {
 
     lahc->run();
     EXPECT_TRUE(true);
-}
\ No newline at end of file
+}
+
+TEST_F(LahcTest, RestartFromSharedBest) {
+    // A solution of another run, published to the group
+    Lahc donor(7, instance, preprocessor);
+    donor.initialize_heuristic();
+    donor.follower->run(donor.current);
+    SharedBest shared;
+    EXPECT_TRUE(shared.publish(*donor.current, donor.seed));
+
+    lahc->share_best(&shared, 1.0);
+    lahc->initialize_heuristic();
+    EXPECT_EQ(lahc->current->chromT, donor.current->chromT);
+    EXPECT_EQ(lahc->current->upper_cost.penalised_cost, lahc->history_list[0]);
+
+    // Without restart rate, a new solution is built
+    lahc->share_best(&shared, 0.0);
+    lahc->initialize_heuristic();
+    EXPECT_EQ(lahc->current->chromT.size(), donor.current->chromT.size());
+}
+
+TEST_F(LahcTest, MigrateAdoptsBetterImmigrant) {
+    IslandModel islands(2, Topology::RING, 1);
+    Lahc neighbour(7, instance, preprocessor);
+    neighbour.join_islands(&islands, 1);
+    lahc->join_islands(&islands, 0);
+
+    // The neighbour sends its best to island 0, which takes it in as its current and best solution
+    neighbour.initialize_heuristic();
+    neighbour.follower->run(neighbour.current);
+    neighbour.global_best = make_unique<Individual>(*neighbour.current);
+    neighbour.migrate();
+    EXPECT_EQ(islands.num_sent(), 1);
+
+    lahc->initialize_heuristic();
+    lahc->leader->load_individual(lahc->current);
+    lahc->migrate();
+    EXPECT_EQ(lahc->global_best->lower_cost, neighbour.current->lower_cost);
+    EXPECT_EQ(lahc->current->chromT, neighbour.current->chromT);
+    EXPECT_EQ(islands.num_sent(), 1);           // nothing better to send back
+
+    // A worse immigrant is ignored
+    neighbour.global_best->lower_cost += 1.0;
+    neighbour.emigrated_cost = numeric_limits<double>::max();
+    neighbour.migrate();
+    lahc->migrate();
+    EXPECT_EQ(lahc->global_best->lower_cost, neighbour.current->lower_cost);
+}
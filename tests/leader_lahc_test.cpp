@@ -7,6 +7,7 @@
 #include "leader_lahc.hpp"
 #include <random>
 #include <memory>  // Include for smart pointers
+#include <thread>
 
 using namespace ::testing;
 
@@ -147,4 +148,35 @@ TEST_F(LeaderLahcTest, NeighbourExplore) {
 
 //    cout << leader->nbMoves << endl;
 //    cout << "Hit Move Ratio: " << leader->nbMoves / static_cast<double>(length) << endl;
-}
\ No newline at end of file
+}
+TEST_F(LeaderLahcTest, SharedInstanceAcrossThreads) {
+    SCOPED_TRACE("Runs on several threads over one Case and Preprocessor...");
+
+    const vector<vector<int>> correlated_vertices = preprocessor->correlated_vertices_;
+    const Case* shared_instance = instance;
+    const Preprocessor* shared_preprocessor = preprocessor;
+    auto solve = [&](const int seed) {
+        vector<int> chromT(shared_preprocessor->customer_ids_);
+        std::shuffle(chromT.begin(), chromT.end(), std::default_random_engine(seed));
+        Individual ind(shared_instance, shared_preprocessor, chromT);
+        Split local_split(seed, shared_instance, shared_preprocessor);
+        LeaderLahc local_leader(seed, shared_instance, shared_preprocessor);
+        local_split.generalSplit(&ind, shared_preprocessor->route_cap_);
+        for (int i = 0; i < 5; ++i) {
+            local_leader.run(&ind, shared_preprocessor->penalty_capacity_, shared_preprocessor->penalty_duration_);
+        }
+        return ind.upper_cost.penalised_cost;
+    };
+
+    vector<double> serial(4), parallel(4);
+    for (int seed = 0; seed < 4; ++seed) serial[seed] = solve(seed);
+    vector<std::thread> threads;
+    for (int seed = 0; seed < 4; ++seed) {
+        threads.emplace_back([&, seed]() { parallel[seed] = solve(seed); });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(parallel, serial);
+    // Each local search reshuffles its own copy of the correlated vertices
+    EXPECT_EQ(preprocessor->correlated_vertices_, correlated_vertices);
+}
@@ -0,0 +1,35 @@
+#include "gtest/gtest.h"
+#include "parallel.hpp"
+#include <stdexcept>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(ParallelTest, VisitsEveryIndexOnce) {
+    SCOPED_TRACE("parallel_for...");
+
+    for (const int num_threads : {1, 3, 8}) {
+        vector<std::atomic<int>> visits(1000);
+        parallel_for(0, 1000, [&](const int i) { visits[i]++; }, num_threads, 7);
+        for (const auto& count : visits) EXPECT_EQ(count.load(), 1);
+    }
+
+    // Blocks cover the range without overlap, the last one is shorter
+    vector<int> block_sizes(10, 0);
+    parallel_for_blocks(5, 100, 10, [&](const int first, const int last) {
+        block_sizes[(first - 5) / 10] = last - first;
+    }, 4);
+    EXPECT_EQ(block_sizes, vector<int>({10, 10, 10, 10, 10, 10, 10, 10, 10, 5}));
+
+    int calls = 0;
+    parallel_for(3, 3, [&](int) { calls++; });
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(ParallelTest, RethrowsExceptions) {
+    SCOPED_TRACE("Exception in a worker...");
+
+    EXPECT_THROW(parallel_for(0, 100, [](const int i) {
+        if (i == 57) throw std::runtime_error("failed");
+    }, 4), std::runtime_error);
+}
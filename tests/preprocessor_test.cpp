@@ -4,6 +4,9 @@
 
 #include "gtest/gtest.h"
 #include "preprocessor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
 
 using namespace ::testing;
 
@@ -31,6 +34,199 @@ TEST_F(PreprocessorTest, Construtor) {
     Preprocessor preprocessor(*instance, *params);
 
     EXPECT_FALSE(preprocessor.correlated_vertices_.empty());
-    EXPECT_FALSE(preprocessor.best_station_.empty());
+    EXPECT_EQ(preprocessor.best_station_.num_nodes(), instance->num_customer_ + 1);
 }
 
+
+TEST_F(PreprocessorTest, MatrixFreeTables) {
+    SCOPED_TRACE("Same tables on both distance backends...");
+
+    Preprocessor dense(*instance, *params);
+    Parameters matrix_free_params;
+    matrix_free_params.matrix_free_threshold = 0;
+    Case matrix_free_instance("E-n22-k4.evrp", matrix_free_params);
+    Preprocessor matrix_free(matrix_free_instance, matrix_free_params);
+
+    EXPECT_EQ(matrix_free.max_distance_, dense.max_distance_);
+    EXPECT_EQ(matrix_free.sorted_nearby_customers_, dense.sorted_nearby_customers_);
+    EXPECT_EQ(matrix_free.correlated_vertices_, dense.correlated_vertices_);
+    for (int i = 0; i <= instance->num_customer_; ++i) {
+        for (int j = 0; j <= instance->num_customer_; ++j) {
+            EXPECT_EQ(matrix_free.best_station(i, j), dense.best_station(i, j));
+        }
+    }
+}
+
+TEST_F(PreprocessorTest, ParallelBuild) {
+    SCOPED_TRACE("Same tables on one and several threads...");
+
+    Parameters serial_params, parallel_params;
+    serial_params.build_threads = 1;
+    parallel_params.build_threads = 4;
+    Case serial_instance("X-n143-k7.evrp", serial_params);
+    Case parallel_instance("X-n143-k7.evrp", parallel_params);
+    for (int i = 0; i < serial_instance.problem_size_; ++i) {
+        for (int j = 0; j < serial_instance.problem_size_; ++j) {
+            EXPECT_EQ(parallel_instance.distance(i, j), serial_instance.distance(i, j));
+            EXPECT_EQ(parallel_instance.distance(i, j), parallel_instance.distance(j, i));
+        }
+    }
+
+    Preprocessor serial(serial_instance, serial_params);
+    Preprocessor parallel(parallel_instance, parallel_params);
+    EXPECT_EQ(parallel.max_distance_, serial.max_distance_);
+    EXPECT_EQ(parallel.sorted_nearby_customers_, serial.sorted_nearby_customers_);
+    EXPECT_EQ(parallel.correlated_vertices_, serial.correlated_vertices_);
+    for (int i = 0; i <= serial_instance.num_customer_; ++i) {
+        for (int j = 0; j <= serial_instance.num_customer_; ++j) {
+            EXPECT_EQ(parallel.best_station(i, j), serial.best_station(i, j));
+        }
+    }
+
+    vector<string> phases;
+    for (const auto& [phase, seconds] : parallel.startup_phases_) {
+        phases.push_back(phase);
+        EXPECT_GE(seconds, 0.0);
+    }
+    EXPECT_EQ(phases, vector<string>({"max distance", "nearby customers", "correlated vertices", "best stations"}));
+}
+
+TEST_F(PreprocessorTest, LazyBestStation) {
+    SCOPED_TRACE("Best stations of the correlated arcs up front, the others on demand...");
+
+    Case large("X-n143-k7.evrp");
+    Preprocessor preprocessor(large, *params);
+    const BestStationTable& table = preprocessor.best_station_;
+    const int m = large.num_customer_ + 1;
+    EXPECT_EQ(table.size(), static_cast<size_t>(m) * (m + 1) / 2);
+    EXPECT_EQ(table.bytes(), table.size() * sizeof(uint16_t));
+
+    for (int i = 0; i < m; ++i) {
+        EXPECT_NE(table.code(i, i), BestStationTable::kUnknown);
+        EXPECT_NE(table.code(0, i), BestStationTable::kUnknown);
+        for (const int x : preprocessor.correlated_vertices_[i]) {
+            EXPECT_NE(table.code(i, x), BestStationTable::kUnknown);
+        }
+    }
+    const size_t eager = table.num_known();
+    EXPECT_LT(eager, table.size() / 2);
+
+    // Lookups fill the missing entries with the same choice as get_best_station, symmetrically
+    for (int i = 0; i < m; ++i) {
+        EXPECT_EQ(preprocessor.best_station(i, i), 0);
+        for (int j = 0; j < m; ++j) {
+            if (i == j) continue;
+            EXPECT_EQ(preprocessor.best_station(i, j), preprocessor.get_best_station(i, j));
+            EXPECT_EQ(preprocessor.best_station(j, i), preprocessor.best_station(i, j));
+        }
+    }
+    EXPECT_EQ(table.num_known(), table.size());
+}
+
+TEST_F(PreprocessorTest, NearbyCustomersOnDemand) {
+    SCOPED_TRACE("Bounded rows of nearby customers, extended in the order of a full sort...");
+
+    Case large("X-n143-k7.evrp");
+    Preprocessor preprocessor(large, *params);
+    const int others = large.num_customer_ - 1;
+    vector<int> extended;
+    for (int i = 1; i <= large.num_customer_; ++i) {
+        vector<int> sorted;
+        for (const int x : preprocessor.customer_ids_) {
+            if (x != i) sorted.push_back(x);
+        }
+        std::sort(sorted.begin(), sorted.end(), [&](const int a, const int b) {
+            return make_pair(large.distance(i, a), a) < make_pair(large.distance(i, b), b);
+        });
+
+        const vector<int>& row = preprocessor.sorted_nearby_customers_[i];
+        ASSERT_EQ(static_cast<int>(row.size()), std::min(Preprocessor::kNearbyCustomers, others));
+        EXPECT_TRUE(std::equal(row.begin(), row.end(), sorted.begin()));
+        EXPECT_EQ(&preprocessor.nearby_customers(i, 10, extended), &row);
+        EXPECT_EQ(preprocessor.nearby_customers(i, 2 * others, extended), sorted);
+    }
+}
+
+TEST_F(PreprocessorTest, MatrixFreeMemoryAboveThreshold) {
+    SCOPED_TRACE("Tables of a synthetic instance above the matrix-free threshold stay linear in its size...");
+
+    // Customers on a jittered grid, a few stations, the depot in the middle
+    const Parameters defaults;
+    const int num_customers = defaults.matrix_free_threshold + 500;
+    const int num_stations = 64;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> jitter(0.0, 0.5);
+    const int side = static_cast<int>(std::ceil(std::sqrt(num_customers)));
+    string content = "NAME: synthetic\nDIMENSION: " + to_string(num_customers + 1) + "\nSTATIONS: " +
+                     to_string(num_stations) + "\nVEHICLES: " + to_string(num_customers / 50) +
+                     "\nCAPACITY: 100\nENERGY_CAPACITY: 200\nENERGY_CONSUMPTION: 1.0\nNODE_COORD_SECTION\n";
+    content += "1 " + to_string(side / 2) + " " + to_string(side / 2) + "\n";
+    for (int i = 0; i < num_customers; ++i) {
+        content += to_string(i + 2) + " " + to_string(i % side + jitter(rng)) + " " + to_string(i / side + jitter(rng)) + "\n";
+    }
+    for (int s = 0; s < num_stations; ++s) {
+        content += to_string(num_customers + 2 + s) + " " + to_string((s % 8 + 0.5) * side / 8) + " " + to_string((s / 8 + 0.5) * side / 8) + "\n";
+    }
+    content += "DEMAND_SECTION\n1 0\n";
+    for (int i = 0; i < num_customers; ++i) content += to_string(i + 2) + " 1\n";
+    content += "DEPOT_SECTION\n1\n-1\nEOF\n";
+
+    Case synthetic;
+    synthetic.parse_problem(content.data(), content.data() + content.size());
+    synthetic.build_coordinates();
+    ASSERT_GT(synthetic.problem_size_, defaults.matrix_free_threshold);
+    synthetic.enable_matrix_free(defaults.nb_granular);
+    Preprocessor preprocessor(synthetic, defaults);
+
+    auto row_bytes = [](const vector<vector<int>>& rows) {
+        size_t bytes = 0;
+        for (const auto& row : rows) bytes += sizeof(vector<int>) + row.size() * sizeof(int);
+        return bytes;
+    };
+    const size_t n = synthetic.problem_size_;
+    const size_t bytes = row_bytes(preprocessor.sorted_nearby_customers_) + row_bytes(preprocessor.correlated_vertices_) +
+                         preprocessor.best_station_.bytes() + synthetic.nearest_customers_.size() * sizeof(int);
+    EXPECT_TRUE(preprocessor.best_station_.sparse());
+    EXPECT_EQ(synthetic.distances_, nullptr);
+    EXPECT_LT(bytes, n * n / 16);               // the dense tables would take about 2 n^2 bytes for the stations alone
+    EXPECT_LT(bytes, n * 1024);                 // and a bounded amount per node
+
+    // The sparse store answers like the scan, for the correlated arcs and for the others, filled on first use
+    std::uniform_int_distribution<int> node(0, synthetic.num_customer_);
+    for (int k = 0; k < 2000; ++k) {
+        const int i = node(rng);
+        const int j = k % 2 == 0 || preprocessor.correlated_vertices_[i].empty() ? node(rng) : preprocessor.correlated_vertices_[i][k % preprocessor.correlated_vertices_[i].size()];
+        const int expected = i == j ? 0 : preprocessor.get_best_station(i, j);
+        EXPECT_EQ(preprocessor.best_station(i, j), expected);
+        EXPECT_EQ(preprocessor.best_station(j, i), expected);
+    }
+}
+
+TEST_F(PreprocessorTest, SparseBestStationTable) {
+    SCOPED_TRACE("Sparse store beyond the 16-bit node ids of the dense one...");
+
+    const int num_nodes = 100'000;
+    vector<vector<int>> neighbours(num_nodes);
+    for (int i = 1; i + 1 < num_nodes; ++i) neighbours[i] = {i - 1, i + 1};
+    BestStationTable table;
+    EXPECT_THROW(table.resize(num_nodes, num_nodes + 10), length_error);
+    table.resize_sparse(num_nodes, neighbours, 4096);
+    EXPECT_TRUE(table.sparse());
+    EXPECT_LT(table.bytes(), static_cast<size_t>(num_nodes) * 64);
+
+    EXPECT_EQ(table.station(5, 5), 0);
+    EXPECT_EQ(table.station(0, 70'000), BestStationTable::kUnknownStation);
+    EXPECT_EQ(table.set(70'000, 0, 99'999), 99'999);                // a depot arc
+    EXPECT_EQ(table.station(0, 70'000), 99'999);
+    EXPECT_EQ(table.set(70'001, 70'000, 80'000), 80'000);           // a neighbour arc
+    EXPECT_EQ(table.station(70'000, 70'001), 80'000);
+    EXPECT_EQ(table.set(12, 90'000, 75'000), 75'000);               // a lazily stored arc
+    EXPECT_EQ(table.station(90'000, 12), 75'000);
+    EXPECT_EQ(table.station(13, 90'000), BestStationTable::kUnknownStation);
+    EXPECT_EQ(table.num_known(), 3u);
+
+    // A full hash stores nothing more, and answers unknown for the arcs it could not keep
+    for (int i = 1; i < 20'000; ++i) table.set(i, i + 50'000, 1);
+    EXPECT_LE(table.num_known(), 3u + 4096u);
+    EXPECT_EQ(table.station(90'000, 12), 75'000);
+}
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "route_cache.hpp"
+
+using namespace std;
+using namespace ::testing;
+
+TEST(RouteCacheTest, HitsAndMisses) {
+    RouteCache cache;
+    EXPECT_FALSE(cache.enabled());
+    cache.resize(10);
+    EXPECT_EQ(cache.capacity(), 16u);
+
+    const vector<int> route = {0, 3, 5, 0};
+    const vector<int> repaired = {0, 3, 21, 5, 0};
+    const uint64_t hash = RouteCache::hash(route.data(), 4);
+    EXPECT_EQ(cache.find(hash, route.data(), 4), nullptr);
+    cache.insert(hash, route.data(), 4, repaired.data(), 5, 12.5, 7);
+
+    const RouteCache::Entry* entry = cache.find(hash, route.data(), 4);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->cost, 12.5);
+    EXPECT_EQ(entry->lookups, 7u);
+    EXPECT_EQ(vector<int>(entry->repaired(), entry->repaired() + entry->repaired_length), repaired);
+
+    // Same hash, other route: keys are compared in full
+    const vector<int> other = {0, 5, 3, 0};
+    EXPECT_EQ(cache.find(hash, other.data(), 4), nullptr);
+    EXPECT_EQ(cache.num_hits(), 1u);
+    EXPECT_EQ(cache.num_misses(), 2u);
+    EXPECT_DOUBLE_EQ(cache.hit_rate(), 1.0 / 3.0);
+}
+
+TEST(RouteCacheTest, EvictsLeastRecentlyUsed) {
+    RouteCache cache;
+    cache.resize(RouteCache::kWays);    // a single set
+
+    vector<vector<int>> routes;
+    for (int k = 0; k <= RouteCache::kWays; ++k) routes.push_back({0, k + 1, 0});
+    auto insert = [&](const int k) {
+        cache.insert(RouteCache::hash(routes[k].data(), 3), routes[k].data(), 3, routes[k].data(), 3, k, 0);
+    };
+    auto contains = [&](const int k) {
+        return cache.find(RouteCache::hash(routes[k].data(), 3), routes[k].data(), 3) != nullptr;
+    };
+    for (int k = 0; k < RouteCache::kWays; ++k) insert(k);
+    EXPECT_TRUE(contains(0));           // route 1 is now the least recently used
+    insert(RouteCache::kWays);
+    EXPECT_FALSE(contains(1));
+    EXPECT_TRUE(contains(0));
+    EXPECT_TRUE(contains(RouteCache::kWays));
+}
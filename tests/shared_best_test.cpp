@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include "shared_best.hpp"
+#include <random>
+#include <thread>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(SharedBestTest, KeepsOnlyImprovements) {
+    SCOPED_TRACE("Publish...");
+
+    SharedBest shared;
+    EXPECT_EQ(SharedBest::Reader(shared).get(), nullptr);
+    EXPECT_EQ(shared.best_improvement().publisher, -1);
+    EXPECT_EQ(shared.seconds_to_reach(1e9), -1.0);
+
+    Individual solution;
+    for (const double cost : {50.0, 60.0, 40.0, 40.0, 45.0, 30.0}) {
+        solution.lower_cost = cost;
+        solution.chromT = {static_cast<int>(cost)};
+        shared.publish(solution, static_cast<int>(cost));
+    }
+    const SharedBest::Reader best(shared);
+    ASSERT_NE(best.get(), nullptr);
+    EXPECT_EQ(shared.best_cost(), 30.0);
+    EXPECT_EQ(best->solution.chromT, vector<int>({30}));
+    EXPECT_EQ(best->publisher, 30);
+    EXPECT_EQ(shared.best_improvement().publisher, 30);
+    EXPECT_EQ(shared.num_improvements(), 3);    // 50, 40, 30
+    EXPECT_GE(shared.seconds_to_reach(45.0), 0.0);
+    EXPECT_LE(shared.seconds_to_reach(45.0), shared.seconds_to_reach(30.0));
+    EXPECT_EQ(shared.seconds_to_reach(20.0), -1.0);
+}
+
+TEST(SharedBestTest, ConcurrentPublishers) {
+    SCOPED_TRACE("Concurrent publish...");
+
+    SharedBest shared;
+    vector<double> thread_best(4, numeric_limits<double>::max());
+    vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 engine(t);
+            std::uniform_real_distribution<double> cost(0.0, 1000.0);
+            Individual solution;
+            for (int i = 0; i < 2'000; ++i) {
+                solution.lower_cost = cost(engine);
+                thread_best[t] = std::min(thread_best[t], solution.lower_cost);
+                shared.publish(solution, t);
+                EXPECT_LE(shared.best_cost(), solution.lower_cost);
+                const SharedBest::Reader best(shared);
+                EXPECT_LE(best->cost, solution.lower_cost);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(shared.best_cost(), *std::min_element(thread_best.begin(), thread_best.end()));
+    // The improvements have strictly decreasing costs, and the snapshots replaced while read are not all kept
+    const vector<SharedBest::Improvement> improvements = shared.improvements();
+    for (size_t i = 1; i < improvements.size(); ++i) EXPECT_LT(improvements[i].cost, improvements[i - 1].cost);
+    EXPECT_EQ(improvements.back().cost, shared.best_cost());
+    EXPECT_LE(shared.num_snapshots(), improvements.size());
+}
+
+TEST(SharedBestTest, FreesReplacedSnapshots) {
+    SCOPED_TRACE("Reclaim...");
+
+    SharedBest shared;
+    Individual solution;
+    solution.lower_cost = 50.0;
+    solution.chromT = {50};
+    shared.publish(solution, 1);
+    {
+        // A reader keeps the snapshot it got alive through later improvements
+        const SharedBest::Reader held(shared);
+        solution.lower_cost = 40.0;
+        solution.chromT = {40};
+        shared.publish(solution, 2);
+        EXPECT_EQ(shared.num_snapshots(), 2u);
+        EXPECT_EQ(held->solution.chromT, vector<int>({50}));
+        EXPECT_EQ(SharedBest::Reader(shared)->solution.chromT, vector<int>({40}));
+    }
+    solution.lower_cost = 30.0;
+    shared.publish(solution, 3);
+    EXPECT_EQ(shared.num_snapshots(), 1u);
+    EXPECT_EQ(shared.num_improvements(), 3);
+}
+
+TEST(SharedBestTest, RecordsImprovementsWithoutSolutions) {
+    SCOPED_TRACE("Publish without solutions...");
+
+    SharedBest shared(false);
+    Individual solution;
+    for (const double cost : {50.0, 40.0, 45.0}) {
+        solution.lower_cost = cost;
+        shared.publish(solution, static_cast<int>(cost));
+    }
+    EXPECT_EQ(SharedBest::Reader(shared).get(), nullptr);
+    EXPECT_EQ(shared.num_snapshots(), 0u);
+    EXPECT_EQ(shared.best_cost(), 40.0);
+    EXPECT_EQ(shared.best_improvement().publisher, 40);
+    EXPECT_EQ(shared.num_improvements(), 2);
+}
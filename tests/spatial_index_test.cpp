@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "spatial_index.hpp"
+
+using namespace ::testing;
+
+class SpatialIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        instance = new Case("X-n143-k7.evrp");
+        for (int i = 1; i <= instance->num_customer_; ++i) customers.push_back(i);
+        for (int i = instance->num_customer_ + 1; i < instance->problem_size_; ++i) stations.push_back(i);
+    }
+
+    void TearDown() override {
+        delete instance;
+    }
+
+    // The linear scan the index replaces
+    int scan_best_detour(const int from, const int to, const double max_from, const double max_to) const {
+        int best = -1;
+        double best_dis = std::numeric_limits<double>::max();
+        for (const int s : stations) {
+            if (s != from && s != to && instance->distance(from, s) < max_from && instance->distance(s, to) < max_to &&
+                best_dis > instance->distance(from, s) + instance->distance(to, s)) {
+                best = s;
+                best_dis = instance->distance(from, s) + instance->distance(to, s);
+            }
+        }
+        return best;
+    }
+
+    Case* instance{};
+    vector<int> customers;
+    vector<int> stations;
+};
+
+TEST_F(SpatialIndexTest, BestDetour) {
+    SCOPED_TRACE("Best detour station...");
+
+    const SpatialIndex index(*instance, stations);
+    EXPECT_EQ(index.size(), static_cast<int>(stations.size()));
+    const double inf = std::numeric_limits<double>::infinity();
+    for (int i = 0; i <= instance->num_customer_; ++i) {
+        for (int j = 0; j <= instance->num_customer_; ++j) {
+            EXPECT_EQ(index.best_detour(i, j), scan_best_detour(i, j, inf, inf));
+            for (const double range : {-1.0, 50.0, 200.0, 500.0}) {
+                EXPECT_EQ(index.best_detour(i, j, range, 300.0), scan_best_detour(i, j, range, 300.0));
+            }
+        }
+    }
+    EXPECT_EQ(SpatialIndex().best_detour(0, 1), -1);
+}
+
+TEST_F(SpatialIndexTest, Nearest) {
+    SCOPED_TRACE("k nearest customers...");
+
+    const SpatialIndex index(*instance, customers);
+    vector<int> nearest;
+    for (int i = 0; i <= instance->num_customer_; ++i) {
+        vector<pair<double, int>> order;
+        for (const int j : customers) {
+            if (j != i) order.emplace_back(instance->distance(i, j), j);
+        }
+        sort(order.begin(), order.end());
+        for (const int k : {1, 5, 20, instance->num_customer_ + 5}) {
+            index.nearest(i, k, nearest);
+            ASSERT_EQ(nearest.size(), std::min<size_t>(k, order.size()));
+            for (size_t p = 0; p < nearest.size(); ++p) {
+                EXPECT_EQ(nearest[p], order[p].second);
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "trace.hpp"
+#include <filesystem>
+#include <sstream>
+
+using namespace std;
+using namespace ::testing;
+namespace fs = std::filesystem;
+
+class TraceTest : public Test {
+protected:
+    string path = (fs::temp_directory_path() / "frogs_trace_test.bin").string();
+    const vector<TraceColumn> columns = {{"iter", TraceType::INT64}, {"cost"}};
+
+    void TearDown() override { fs::remove(path); }
+
+    void write_rows(const long num_rows) const {
+        TraceWriter writer(path, columns, 4);
+        for (long i = 0; i < num_rows; ++i) writer.append({i - 2, 0.5 * static_cast<double>(i)});
+        EXPECT_EQ(writer.num_rows(), num_rows);
+    }
+};
+
+TEST_F(TraceTest, RoundTrip) {
+    write_rows(10);     // two full blocks and a partial one
+    EXPECT_EQ(fs::file_size(path), TraceFormat::data_offset(2) + 3 * TraceFormat::block_bytes(2, 4));
+
+    const TraceReader reader(path);
+    ASSERT_EQ(reader.num_columns(), 2u);
+    ASSERT_EQ(reader.num_rows(), 10u);
+    EXPECT_EQ(reader.column(0).name, "iter");
+    EXPECT_EQ(reader.column(0).type, TraceType::INT64);
+    EXPECT_EQ(reader.find_column("cost"), 1);
+    EXPECT_EQ(reader.find_column("missing"), -1);
+    for (size_t row = 0; row < 10; ++row) {
+        EXPECT_EQ(reader.integer(row, 0), static_cast<int64_t>(row) - 2);
+        EXPECT_EQ(reader.value(row, 1), 0.5 * static_cast<double>(row));
+    }
+    ASSERT_EQ(reader.num_blocks(), 3u);
+    EXPECT_EQ(reader.block_size(2), 2u);
+    EXPECT_EQ(static_cast<int64_t>(reader.block_column(1, 0)[3]), 5);
+
+    ostringstream csv;
+    reader.write_csv(csv);
+    EXPECT_EQ(csv.str().substr(0, 26), "iter,cost\n-2,0\n-1,0.5\n0,1\n");
+}
+
+TEST_F(TraceTest, IgnoresTruncatedBlock) {
+    write_rows(8);
+    // A crash in the middle of a block write leaves a partial block at the end of the file
+    fs::resize_file(path, fs::file_size(path) - 8);
+
+    const TraceReader reader(path);
+    EXPECT_EQ(reader.num_rows(), 4u);
+}
+
+TEST_F(TraceTest, RejectsOtherFiles) {
+    ofstream(path) << "iter,cost\n1,2\n3,4\n5,6\n7,8\n";
+    EXPECT_THROW(TraceReader reader(path), runtime_error);
+    EXPECT_THROW(TraceReader reader(path + ".missing"), runtime_error);
+    EXPECT_THROW(TraceWriter(path, {{string(30, 'x')}}), runtime_error);
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include "trial_scheduler.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+using namespace ::testing;
+
+TEST(TrialSchedulerTest, RunsEveryTrialOnceWithItsSeed) {
+    SCOPED_TRACE("Trials and seeds...");
+
+    for (const int num_workers : {1, 3, 16}) {
+        const TrialScheduler scheduler(10, num_workers, false, 100);
+        EXPECT_LE(scheduler.num_workers(), 10);
+
+        vector<std::atomic<int>> runs(10);
+        const auto reports = scheduler.run([&](const int trial, const int seed) {
+            runs[trial]++;
+            return static_cast<double>(seed) * 2.0;
+        });
+
+        ASSERT_EQ(reports.size(), 10u);
+        for (int t = 0; t < 10; ++t) {
+            EXPECT_EQ(runs[t].load(), 1);
+            EXPECT_EQ(reports[t].trial, t);
+            EXPECT_EQ(reports[t].seed, 100 + t + 1);
+            EXPECT_DOUBLE_EQ(reports[t].result, 2.0 * (100 + t + 1));
+            EXPECT_GE(reports[t].worker, 0);
+            EXPECT_LT(reports[t].worker, scheduler.num_workers());
+            EXPECT_EQ(reports[t].cpu, -1);
+            EXPECT_GE(reports[t].wall_seconds, 0.0);
+            EXPECT_GE(reports[t].cpu_seconds, 0.0);
+        }
+    }
+
+    // The default seed reproduces the historical seeds 1..10
+    EXPECT_EQ(TrialScheduler::trial_seed(0, 0), 1);
+    EXPECT_EQ(TrialScheduler::trial_seed(0, 9), 10);
+}
+
+TEST(TrialSchedulerTest, PinsWorkers) {
+    SCOPED_TRACE("Pinned workers...");
+
+    const TrialScheduler scheduler(4, 2, true, 0);
+    const auto reports = scheduler.run([](int, const int seed) { return static_cast<double>(seed); });
+    for (const auto& report : reports) {
+#ifdef __linux__
+        EXPECT_EQ(report.cpu, report.worker % std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+#else
+        EXPECT_EQ(report.cpu, -1);
+#endif
+    }
+}
+
+TEST(TrialSchedulerTest, RethrowsExceptions) {
+    SCOPED_TRACE("Exception in a trial...");
+
+    const TrialScheduler scheduler(8, 4, false, 0);
+    EXPECT_THROW(scheduler.run([](const int trial, int) -> double {
+        if (trial == 5) throw std::runtime_error("failed");
+        return 0.0;
+    }), std::runtime_error);
+}
@@ -0,0 +1,28 @@
+#include "trace.hpp"
+#include <fstream>
+#include <iostream>
+
+// Usage: ./TraceToCsv <trace file> [csv file], the CSV goes to stdout without a second argument
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: ./TraceToCsv <trace file> [csv file]" << std::endl;
+        return 1;
+    }
+
+    try {
+        const TraceReader trace(argv[1]);
+        if (argc > 2) {
+            std::ofstream out(argv[2]);
+            if (!out) throw std::runtime_error(string("can not open ") + argv[2]);
+            trace.write_csv(out);
+        } else {
+            std::ios::sync_with_stdio(false);
+            trace.write_csv(std::cout);
+        }
+        std::cerr << trace.num_rows() << " rows, " << trace.num_columns() << " columns" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}